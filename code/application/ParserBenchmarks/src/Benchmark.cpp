@@ -0,0 +1,87 @@
+#include "Benchmark.h"
+
+#include <algorithm>
+#include <chrono>
+#include <exception>
+#include <iomanip>
+
+namespace benchmarks {
+
+Benchmark::Benchmark(const std::string& name, std::size_t inputSize, RunFunction run, PrepareFunction prepare)
+    : m_name{ name }
+    , m_inputSize{ inputSize }
+    , m_run{ run }
+    , m_prepare{ prepare }
+{
+}
+
+void Benchmark::Prepare() const
+{
+    if (m_prepare)
+        m_prepare();
+}
+
+std::size_t Benchmark::Run() const
+{
+    return m_run();
+}
+
+BenchmarkRunner::BenchmarkRunner(double minTime, std::size_t minIterations)
+    : m_minTime{ minTime }
+    , m_minIterations{ minIterations }
+{
+}
+
+BenchmarkResult BenchmarkRunner::Run(const Benchmark& benchmark) const
+{
+    using Clock = std::chrono::steady_clock;
+    BenchmarkResult result{ benchmark.Name(), 0, 0.0, 0, 0, {} };
+    try
+    {
+        benchmark.Prepare();
+        benchmark.Run();
+        while ((result.iterations < m_minIterations) || (result.seconds < m_minTime))
+        {
+            benchmark.Prepare();
+            auto start = Clock::now();
+            auto tokens = benchmark.Run();
+            result.seconds += std::chrono::duration<double>(Clock::now() - start).count();
+            result.tokens += tokens;
+            result.bytes += benchmark.InputSize();
+            ++result.iterations;
+        }
+    }
+    catch (std::exception& e)
+    {
+        result.error = e.what();
+    }
+    return result;
+}
+
+void BenchmarkRunner::Report(std::ostream& stream, const std::vector<BenchmarkResult>& results)
+{
+    std::size_t nameWidth = std::string("Benchmark").length();
+    for (auto const& result : results)
+    {
+        nameWidth = std::max(nameWidth, result.name.length());
+    }
+    stream << std::left << std::setw(static_cast<int>(nameWidth)) << "Benchmark" << std::right
+        << std::setw(12) << "Iterations" << std::setw(14) << "ms/iteration" << std::setw(12) << "MB/s" << std::setw(14) << "Mtokens/s" << std::endl;
+    for (auto const& result : results)
+    {
+        stream << std::left << std::setw(static_cast<int>(nameWidth)) << result.name << std::right;
+        if (!result.error.empty())
+        {
+            stream << "  FAILED: " << result.error << std::endl;
+            continue;
+        }
+        double seconds = (result.seconds > 0.0) ? result.seconds : 1e-9;
+        stream << std::fixed << std::setprecision(3)
+            << std::setw(12) << result.iterations
+            << std::setw(14) << (seconds * 1000.0 / static_cast<double>(result.iterations))
+            << std::setw(12) << (static_cast<double>(result.bytes) / seconds / 1e6)
+            << std::setw(14) << (static_cast<double>(result.tokens) / seconds / 1e6) << std::endl;
+    }
+}
+
+} // namespace benchmarks
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <functional>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace benchmarks {
+
+// A single benchmark. Prepare runs before every iteration and is not timed. Run is timed, and returns the number
+// of tokens processed by the iteration. A failing iteration throws.
+class Benchmark
+{
+public:
+    using PrepareFunction = std::function<void()>;
+    using RunFunction = std::function<std::size_t()>;
+
+private:
+    std::string m_name;
+    std::size_t m_inputSize;
+    RunFunction m_run;
+    PrepareFunction m_prepare;
+
+public:
+    Benchmark(const std::string& name, std::size_t inputSize, RunFunction run, PrepareFunction prepare = {});
+
+    const std::string& Name() const { return m_name; }
+    std::size_t InputSize() const { return m_inputSize; }
+    void Prepare() const;
+    std::size_t Run() const;
+};
+
+struct BenchmarkResult
+{
+    std::string name;
+    std::size_t iterations;
+    double seconds;
+    std::size_t bytes;
+    std::size_t tokens;
+    std::string error;
+};
+
+// Runs every benchmark for at least a minimum time and number of iterations, after one untimed warm up iteration
+class BenchmarkRunner
+{
+private:
+    double m_minTime;
+    std::size_t m_minIterations;
+
+public:
+    BenchmarkRunner(double minTime, std::size_t minIterations);
+
+    BenchmarkResult Run(const Benchmark& benchmark) const;
+    static void Report(std::ostream& stream, const std::vector<BenchmarkResult>& results);
+};
+
+} // namespace benchmarks
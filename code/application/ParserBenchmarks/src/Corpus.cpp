@@ -0,0 +1,82 @@
+#include "Corpus.h"
+
+#include <sstream>
+
+namespace benchmarks {
+
+std::string GenerateCMakeCorpus(std::size_t scale)
+{
+    std::ostringstream stream;
+    stream << "cmake_minimum_required(VERSION 3.5.1)\n"
+        << "\n"
+        << "project(benchmark-project\n"
+        << "    DESCRIPTION \"Generated project\"\n"
+        << ")\n"
+        << "\n";
+    for (std::size_t index = 0; index < scale; ++index)
+    {
+        stream << "# Settings for component " << index << "\n"
+            << "set(COMPONENT_" << index << "_NAME component-" << index << ")\n"
+            << "set(COMPONENT_" << index << "_SOURCES\n"
+            << "    ${CMAKE_CURRENT_SOURCE_DIR}/src/source_" << index << ".cpp\n"
+            << "    ${CMAKE_CURRENT_SOURCE_DIR}/include/header_" << index << ".h\n"
+            << "    )\n"
+            << "set(COMPONENT_" << index << "_OPTIONS /wd" << (4000 + index % 1000) << " -DVALUE=" << index << ")\n"
+            << "message(STATUS \"Component ${COMPONENT_" << index << "_NAME} version " << index << ".0\")\n"
+            << "\n";
+    }
+    return stream.str();
+}
+
+std::string GenerateExpressionCorpus(std::size_t scale)
+{
+    std::ostringstream stream;
+    for (std::size_t index = 0; index < scale; ++index)
+    {
+        stream << "${CMAKE_SOURCE_DIR}/output/${PLATFORM_NAME}/lib_" << index
+            << ";$ENV{HOME}/path." << index
+            << " \"Quoted ${VALUE_" << index << "} text\" name-" << index << " = " << index << "\n";
+    }
+    return stream.str();
+}
+
+std::string GenerateJSONCorpus(std::size_t scale)
+{
+    std::ostringstream stream;
+    stream << "{\n    \"items\": [\n";
+    for (std::size_t index = 0; index < scale; ++index)
+    {
+        stream << "        {\n"
+            << "            \"name\": \"item-" << index << "\",\n"
+            << "            \"index\": " << index << ",\n"
+            << "            \"weight\": " << index << ".25e-3,\n"
+            << "            \"enabled\": " << ((index % 2 == 0) ? "true" : "false") << ",\n"
+            << "            \"parent\": null,\n"
+            << "            \"tags\": [ \"a\", \"b\", \"c" << index << "\" ]\n"
+            << "        }" << ((index + 1 < scale) ? "," : "") << "\n";
+    }
+    // The parser does not accept whitespace after the top level value
+    stream << "    ]\n}";
+    return stream.str();
+}
+
+std::string GenerateCppCorpus(std::size_t scale)
+{
+    // The C++ lexer only knows keywords, punctuation and comments
+    std::ostringstream stream;
+    for (std::size_t index = 0; index < scale; ++index)
+    {
+        stream << "// Declaration " << index << "\n"
+            << "struct\n"
+            << "{\n"
+            << "    virtual unsigned long (char, int *, double &);\n"
+            << "    float [] = { };\n"
+            << "    virtual ~() override final;\n"
+            << "};\n"
+            << "class : struct < int, long > { };\n"
+            << "\n";
+    }
+    return stream.str();
+}
+
+} // namespace benchmarks
@@ -0,0 +1,15 @@
+#pragma once
+
+#include <string>
+
+namespace benchmarks {
+
+// Synthetic inputs for the benchmarks. The output is deterministic, and grows linearly with the scale.
+// Every corpus only uses constructs that its lexer and parser accept, so a benchmark that meets an invalid token
+// reports a failure instead of a meaningless throughput.
+std::string GenerateCMakeCorpus(std::size_t scale);
+std::string GenerateExpressionCorpus(std::size_t scale);
+std::string GenerateJSONCorpus(std::size_t scale);
+std::string GenerateCppCorpus(std::size_t scale);
+
+} // namespace benchmarks
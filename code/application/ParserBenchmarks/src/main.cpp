@@ -0,0 +1,222 @@
+#include "getopt.h"
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include "cmake-parser/CMakeParser.h"
+#include "cmake-parser/ExpressionLexer.h"
+#include "cmake-parser/IncrementalLexer.h"
+#include "cmake-parser/Lexer.h"
+#include "cpp-parser/Lexer.h"
+#include "json-parser/Lexer.h"
+#include "json-parser/Parser.h"
+#include "parser/ParseArena.h"
+#include "parser/TokenCache.h"
+#include "Benchmark.h"
+#include "Corpus.h"
+
+using namespace benchmarks;
+
+static const std::size_t DefaultScale = 1000;
+static const double DefaultMinTime = 1.0;
+
+int ShowHelp(const char* application)
+{
+    std::cout << "Usage: " << application << " [-s <scale>] [-t <minimum time per benchmark in seconds>] [-f <name filter>]" << std::endl;
+    return 0;
+}
+
+// Reads tokens one at a time until the end of the input, and returns the number of tokens read
+template<class Lexer, class GetToken>
+std::size_t CountTokens(Lexer& lexer, GetToken getToken)
+{
+    std::size_t count{};
+    for (auto token = getToken(lexer); !token.IsNull(); token = getToken(lexer))
+    {
+        if (token.IsInvalid())
+            throw std::runtime_error("Invalid token in corpus");
+        ++count;
+    }
+    return count;
+}
+
+void AddLexerBenchmarks(std::vector<Benchmark>& benchmarks, std::size_t scale)
+{
+    auto cmakeSource = std::make_shared<std::string>(GenerateCMakeCorpus(scale));
+    auto cmakeStream = std::make_shared<std::istringstream>();
+    auto prepareCMake = [cmakeSource, cmakeStream]() { cmakeStream->clear(); cmakeStream->str(*cmakeSource); };
+    benchmarks.emplace_back("cmake_parser::Lexer::GetToken", cmakeSource->size(), [cmakeStream]()
+    {
+        cmake_parser::Lexer lexer("CMakeLists.txt", *cmakeStream);
+        return CountTokens(lexer, [](cmake_parser::Lexer& l) { return l.GetToken(); });
+    }, prepareCMake);
+    benchmarks.emplace_back("cmake_parser::Lexer::GetTokenView", cmakeSource->size(), [cmakeStream]()
+    {
+        cmake_parser::Lexer lexer("CMakeLists.txt", *cmakeStream);
+        return CountTokens(lexer, [](cmake_parser::Lexer& l) { return l.GetTokenView(); });
+    }, prepareCMake);
+    benchmarks.emplace_back("cmake_parser::Lexer::Tokenize", cmakeSource->size(), [cmakeSource]()
+    {
+        return cmake_parser::Lexer::Tokenize("CMakeLists.txt", *cmakeSource).Size();
+    });
+    benchmarks.emplace_back("cmake_parser::Lexer::Tokenize (arena)", cmakeSource->size(), [cmakeSource]()
+    {
+        parser::ParseArena arena;
+        return cmake_parser::Lexer::Tokenize("CMakeLists.txt", *cmakeSource, arena.Resource()).Size();
+    });
+    auto tokenCache = std::make_shared<parser::TokenCache>(std::filesystem::temp_directory_path() / "parser-benchmarks-token-cache");
+    cmake_parser::Lexer::Tokenize("CMakeLists.txt", *cmakeSource, *tokenCache);
+    benchmarks.emplace_back("cmake_parser::Lexer::Tokenize (cache hit)", cmakeSource->size(), [cmakeSource, tokenCache]()
+    {
+        return cmake_parser::Lexer::Tokenize("CMakeLists.txt", *cmakeSource, *tokenCache).Size();
+    });
+    benchmarks.emplace_back("cmake_parser::Lexer::TokenizeParallel", cmakeSource->size(), [cmakeSource]()
+    {
+        return cmake_parser::Lexer::TokenizeParallel("CMakeLists.txt", *cmakeSource).Size();
+    });
+    // Typing and deleting a character in the middle of the script, so the time per iteration is the latency of two edits
+    auto incrementalLexer = std::make_shared<cmake_parser::IncrementalLexer>("CMakeLists.txt", *cmakeSource);
+    benchmarks.emplace_back("cmake_parser::IncrementalLexer::Apply", 2, [incrementalLexer]()
+    {
+        auto offset = incrementalLexer->Source().size() / 2;
+        auto inserted = incrementalLexer->Apply(parser::TextEdit{ offset, 0, "x" }).inserted;
+        return inserted + incrementalLexer->Apply(parser::TextEdit{ offset, 1, "" }).inserted;
+    });
+
+    auto expressionSource = std::make_shared<std::string>(GenerateExpressionCorpus(scale));
+    auto expressionStream = std::make_shared<std::istringstream>();
+    benchmarks.emplace_back("cmake_parser::expression::Lexer::GetToken", expressionSource->size(), [expressionStream]()
+    {
+        cmake_parser::expression::Lexer lexer("expression", *expressionStream);
+        return CountTokens(lexer, [](cmake_parser::expression::Lexer& l) { return l.GetToken(); });
+    }, [expressionSource, expressionStream]() { expressionStream->clear(); expressionStream->str(*expressionSource); });
+
+    auto jsonSource = std::make_shared<std::string>(GenerateJSONCorpus(scale));
+    auto jsonStream = std::make_shared<std::istringstream>();
+    auto prepareJSON = [jsonSource, jsonStream]() { jsonStream->clear(); jsonStream->str(*jsonSource); };
+    benchmarks.emplace_back("json_parser::Lexer::GetToken", jsonSource->size(), [jsonStream]()
+    {
+        json_parser::Lexer lexer("data.json", *jsonStream);
+        return CountTokens(lexer, [](json_parser::Lexer& l) { return l.GetToken(); });
+    }, prepareJSON);
+    benchmarks.emplace_back("json_parser::Lexer::GetTokenView", jsonSource->size(), [jsonStream]()
+    {
+        json_parser::Lexer lexer("data.json", *jsonStream);
+        return CountTokens(lexer, [](json_parser::Lexer& l) { return l.GetTokenView(); });
+    }, prepareJSON);
+    benchmarks.emplace_back("json_parser::Lexer::Tokenize", jsonSource->size(), [jsonSource]()
+    {
+        return json_parser::Lexer::Tokenize("data.json", *jsonSource).Size();
+    });
+    benchmarks.emplace_back("json_parser::Lexer::TokenizeParallel", jsonSource->size(), [jsonSource]()
+    {
+        return json_parser::Lexer::TokenizeParallel("data.json", *jsonSource).Size();
+    });
+
+    auto cppSource = std::make_shared<std::string>(GenerateCppCorpus(scale));
+    auto cppStream = std::make_shared<std::istringstream>();
+    benchmarks.emplace_back("parser::Lexer::Parse", cppSource->size(), [cppStream]()
+    {
+        parser::Lexer lexer("source.cpp", *cppStream);
+        if (!lexer.Parse())
+            throw std::runtime_error("Invalid token in corpus");
+        return lexer.GetTokens().size();
+    }, [cppSource, cppStream]() { cppStream->clear(); cppStream->str(*cppSource); });
+}
+
+void AddParserBenchmarks(std::vector<Benchmark>& benchmarks, std::size_t scale)
+{
+    // The parsers are constructed outside of the timed part, as CMakeParser looks up the CMake installation on construction.
+    // CMakeParser also expects the root directory to contain the CMakeLists.txt file being parsed.
+    auto cmakeSource = std::make_shared<std::string>(GenerateCMakeCorpus(scale));
+    auto rootDirectory = std::filesystem::temp_directory_path() / "parser-benchmarks";
+    std::filesystem::create_directories(rootDirectory);
+    std::ofstream(rootDirectory / "CMakeLists.txt") << *cmakeSource;
+    auto cmakeStream = std::make_shared<std::istringstream>();
+    auto cmakeParser = std::make_shared<std::unique_ptr<cmake_parser::CMakeParser>>();
+    auto cmakeTokens = cmake_parser::Lexer::Tokenize("CMakeLists.txt", *cmakeSource).Size();
+    benchmarks.emplace_back("cmake_parser::CMakeParser::Parse", cmakeSource->size(), [cmakeParser, cmakeTokens]()
+    {
+        if (!(*cmakeParser)->Parse())
+            throw std::runtime_error("Parsing failed");
+        return cmakeTokens;
+    }, [cmakeSource, cmakeStream, cmakeParser, rootDirectory]()
+    {
+        cmakeStream->clear();
+        cmakeStream->str(*cmakeSource);
+        *cmakeParser = std::make_unique<cmake_parser::CMakeParser>(rootDirectory, "cmake-build", *cmakeStream);
+    });
+    benchmarks.emplace_back("cmake_parser::CMakeParser::Parse (pipelined)", cmakeSource->size(), [cmakeParser, cmakeTokens]()
+    {
+        if (!(*cmakeParser)->Parse(parser::ParseMode::Pipelined))
+            throw std::runtime_error("Parsing failed");
+        return cmakeTokens;
+    }, [cmakeSource, cmakeStream, cmakeParser, rootDirectory]()
+    {
+        cmakeStream->clear();
+        cmakeStream->str(*cmakeSource);
+        *cmakeParser = std::make_unique<cmake_parser::CMakeParser>(rootDirectory, "cmake-build", *cmakeStream);
+    });
+
+    auto jsonSource = std::make_shared<std::string>(GenerateJSONCorpus(scale));
+    auto jsonStream = std::make_shared<std::istringstream>();
+    auto jsonParser = std::make_shared<std::unique_ptr<json_parser::Parser>>();
+    auto jsonTokens = json_parser::Lexer::Tokenize("data.json", *jsonSource).Size();
+    benchmarks.emplace_back("json_parser::Parser::Parse", jsonSource->size(), [jsonParser, jsonTokens]()
+    {
+        if (!(*jsonParser)->Parse())
+            throw std::runtime_error("Parsing failed");
+        return jsonTokens;
+    }, [jsonSource, jsonStream, jsonParser]()
+    {
+        jsonStream->clear();
+        jsonStream->str(*jsonSource);
+        *jsonParser = std::make_unique<json_parser::Parser>("data.json", *jsonStream);
+    });
+}
+
+int main(int argc, char* argv[])
+{
+    std::size_t scale = DefaultScale;
+    double minTime = DefaultMinTime;
+    std::string filter;
+    int opt{};
+    while ((opt = getopt(argc, argv, ":s:t:f:h")) != -1)
+    {
+        switch (static_cast<char>(opt))
+        {
+        case 's':
+            scale = static_cast<std::size_t>(std::strtoull(optarg, nullptr, 10));
+            break;
+        case 't':
+            minTime = std::strtod(optarg, nullptr);
+            break;
+        case 'f':
+            filter = optarg;
+            break;
+        case 'h':
+        case '?':
+        default:
+            return ShowHelp(argv[0]);
+        }
+    }
+
+    std::vector<Benchmark> benchmarks;
+    AddLexerBenchmarks(benchmarks, scale);
+    AddParserBenchmarks(benchmarks, scale);
+
+    std::cout << "Scale " << scale << ", minimum time " << minTime << " s per benchmark" << std::endl;
+    BenchmarkRunner runner(minTime, 3);
+    std::vector<BenchmarkResult> results;
+    bool failed{};
+    for (auto const& benchmark : benchmarks)
+    {
+        if (!filter.empty() && (benchmark.Name().find(filter) == std::string::npos))
+            continue;
+        results.push_back(runner.Run(benchmark));
+        failed |= !results.back().error.empty();
+    }
+    BenchmarkRunner::Report(std::cout, results);
+    return failed ? 1 : 0;
+}
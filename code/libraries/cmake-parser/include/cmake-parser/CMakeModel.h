@@ -5,6 +5,7 @@
 #include "cmake-parser/CMakeCache.h"
 #include "cmake-parser/DirectoryList.h"
 #include "cmake-parser/DirectoryStack.h"
+#include "cmake-parser/ModelSnapshot.h"
 #include "cmake-parser/ProjectList.h"
 #include "cmake-parser/VariableList.h"
 
@@ -74,6 +75,9 @@ extern const std::string VarSuffixVersionTweak;
 
 class CMakeModel
 {
+public:
+    static constexpr std::uint32_t SnapshotFormatVersion = 1;
+
 private:
     CMakeCache m_cache;
     VariableList* m_scopeVariables;
@@ -106,6 +110,7 @@ public:
 
     std::string GetVariable(const std::string& name) const;
     VariablePtr FindVariable(const std::string& name) const;
+    VariablePtr FindVariable(Symbol name) const;
     void SetVariable(const std::string& name, const std::string& value, VariableAttribute attributes = {}, const std::string& type = {}, const std::string& description = {});
     void UnsetVariable(const std::string& name, VariableAttribute attributes = {});
 
@@ -133,6 +138,13 @@ public:
 
     void AddMessage(const std::string& messageMode, const std::string& message);
 
+    // Writes the projects, directories, targets, variables and cache to a binary snapshot file, together with the
+    // manifest of the scripts they were parsed from. The file is replaced at once, readers never see a partial file.
+    bool SaveSnapshot(const std::filesystem::path& path, const SnapshotManifest& manifest) const;
+    // Replaces the parsed contents of the model by those of a snapshot file, if the manifest of the snapshot is clean
+    // for the configuration. Returns false and leaves the model unchanged otherwise.
+    bool LoadSnapshot(const std::filesystem::path& path, std::uint64_t configurationHash);
+
     std::string Serialize(SerializationFormat format = SerializationFormat::Text, unsigned indent = 0) const;
 
 private:
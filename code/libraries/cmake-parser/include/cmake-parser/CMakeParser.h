@@ -2,6 +2,7 @@
 
 #include "cmake-parser/CMakeModel.h"
 #include "cmake-parser/Lexer.h"
+#include "parser/Diagnostic.h"
 #include "parser/ParserExecutor.h"
 
 namespace cmake_parser {
@@ -13,15 +14,33 @@ private:
     const std::filesystem::path m_rootDirectory;
     const std::string m_buildDirectoryName;
     std::istream& m_stream;
+    parser::Diagnostics m_diagnostics;
+    std::filesystem::path m_snapshotPath;
+    bool m_loadedFromSnapshot;
+    std::filesystem::path m_tokenCacheDirectory;
 
 public:
     CMakeParser(const std::filesystem::path& rootDirectory, const std::string& buildDirectoryName, std::istream& stream);
-    bool Parse();
+    bool Parse(parser::ParseMode mode = parser::ParseMode::Sequential, parser::ErrorMode errorMode = parser::ErrorMode::Stop);
+    // Errors found by the last Parse in ErrorMode::Recover
+    const parser::Diagnostics& GetDiagnostics() const { return m_diagnostics; }
+    // Parse loads the model from this snapshot if none of its inputs changed, and otherwise parses and saves it
+    void SetSnapshotPath(const std::filesystem::path& path) { m_snapshotPath = path; }
+    const std::filesystem::path& SnapshotPath() const { return m_snapshotPath; }
+    // True if the last Parse loaded the model from the snapshot
+    bool IsLoadedFromSnapshot() const { return m_loadedFromSnapshot; }
+    // In ParseMode::Parallel, Parse loads the tokens of scripts that were lexed before from this directory, and
+    // stores the tokens of the others
+    void SetTokenCacheDirectory(const std::filesystem::path& directory) { m_tokenCacheDirectory = directory; }
+    const std::filesystem::path& TokenCacheDirectory() const { return m_tokenCacheDirectory; }
 
     const CMakeModel& GetModel() const { return m_model; }
     CMakeModel& GetModel() { return m_model; }
     void Setup();
     std::string Serialize() const;
+
+private:
+    bool ParseScript(std::istream& stream, parser::ParseMode mode, parser::ErrorMode errorMode);
 };
 
 } // namespace cmake_parser
@@ -32,6 +32,8 @@ private:
     parser::Tokenizer<Terminal> m_tokenizer;
 
 public:
+    static const parser::TokenizerRuleSet<Terminal>& GetRuleSet();
+
     Lexer(const std::filesystem::path& path, std::istream& stream);
 
     parser::SourceLocation GetCurrentLocation() const override;
@@ -0,0 +1,31 @@
+#pragma once
+
+#include <cstddef>
+#include <string_view>
+#include "cmake-parser/ExpressionLexer.h"
+
+namespace cmake_parser {
+namespace expression {
+
+// Hand-written scanner for the tokens of the expression Lexer, without a stream, regular expressions or token objects.
+// It follows the lexer rules: the longest match wins, and text that does not start a token makes the rest of the
+// text invalid.
+class Scanner
+{
+private:
+    std::string_view m_text;
+    std::size_t m_offset;
+
+public:
+    explicit Scanner(std::string_view text);
+
+    // Reads the next token, returns false at the end of the text. Invalid text is returned with type None.
+    bool Next(Terminal& type, std::string_view& value);
+    bool IsAtEnd() const { return m_offset >= m_text.size(); }
+
+private:
+    std::size_t ScanString(std::size_t offset) const;
+};
+
+} // namespace expression
+} // namespace cmake_parser
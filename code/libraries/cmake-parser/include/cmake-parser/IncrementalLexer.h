@@ -0,0 +1,52 @@
+#pragma once
+
+#include <filesystem>
+#include <string>
+#include <vector>
+#include "parser/IncrementalTokenizer.h"
+#include "cmake-parser/Lexer.h"
+
+namespace cmake_parser {
+
+// Top level command of a script, as the tokens [firstToken, firstToken + numTokens): the command name up to the
+// parenthesis closing its arguments. Whitespace, line ends and comments between commands are not part of a command.
+struct CommandRange
+{
+    std::size_t firstToken;
+    std::size_t numTokens;
+};
+
+// Commands replaced by an edit: the commands [first, first + removed) of the previous list are replaced by the
+// commands [first, first + inserted) of the new list.
+struct CommandChange
+{
+    std::size_t first;
+    std::size_t removed;
+    std::size_t inserted;
+};
+
+// Lexer for a script that is edited while it is being parsed, such as in an editor.
+// After an edit, only the tokens around the edit are lexed again, and the top level commands that changed are reported,
+// so that only those need to be parsed again.
+class IncrementalLexer
+{
+private:
+    parser::IncrementalTokenizer<Terminal> m_tokenizer;
+    std::vector<CommandRange> m_commands;
+
+public:
+    IncrementalLexer(const std::filesystem::path& path, std::string source);
+
+    const std::string& Source() const { return m_tokenizer.Source(); }
+    const parser::TokenStream<Terminal>& Tokens() const { return m_tokenizer.Tokens(); }
+    const std::vector<CommandRange>& Commands() const { return m_commands; }
+
+    // Applies an edit to the source text, and returns the commands that changed
+    CommandChange Apply(const parser::TextEdit& edit);
+    parser::FileId Register() { return m_tokenizer.Register(); }
+
+private:
+    bool ReadCommand(std::size_t& index, CommandRange& command) const;
+};
+
+} // namespace cmake_parser
@@ -1,8 +1,9 @@
 #pragma once
 
 #include <filesystem>
-#include <set>
+#include "parser/TokenCache.h"
 #include "parser/Tokenizer.h"
+#include "parser/TokenTypeSet.h"
 
 namespace cmake_parser {
 
@@ -31,7 +32,7 @@ enum Terminal
     //Number,
     DigitSequence,
 };
-using TerminalSet = std::set<Terminal>;
+using TerminalSet = parser::TokenTypeSet<Terminal>;
 
 class Lexer
     : public parser::ITokenizer<Terminal>
@@ -40,12 +41,33 @@ private:
     parser::Tokenizer<Terminal> m_tokenizer;
 
 public:
-    Lexer(const std::filesystem::path& path, std::istream& stream);
+    // Identity of the token types and rules, as tokens in a TokenCache depend on them
+    static std::uint64_t GrammarId();
+
+    static const parser::TokenizerRuleSet<Terminal>& GetRuleSet();
+    // Lexes a caller owned source buffer at once, with a matcher built at compile time. The token stream refers to the buffer.
+    static parser::TokenStream<Terminal> Tokenize(const std::filesystem::path& path, std::string_view source,
+                                                  std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+    // Same as Tokenize, loading the tokens from the cache if the source text was lexed before
+    static parser::TokenStream<Terminal> Tokenize(const std::filesystem::path& path, std::string_view source, const parser::TokenCache& cache,
+                                                  std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+    // Same as Tokenize, splitting large buffers into chunks that are lexed on multiple threads
+    static parser::TokenStream<Terminal> TokenizeParallel(const std::filesystem::path& path, std::string_view source, std::size_t numThreads = 0);
+
+    Lexer(const std::filesystem::path& path, std::istream& stream, std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+    // Lexer on a caller owned source buffer that is already registered with the FileTable
+    Lexer(parser::FileId fileId, std::string_view source);
 
     parser::SourceLocation GetCurrentLocation() const override;
+    std::string_view Source() const { return m_tokenizer.Source(); }
     parser::Token<Terminal> GetToken() override;
+    parser::TokenView<Terminal> GetTokenView();
+    parser::Token<Terminal> MakeToken(const parser::TokenView<Terminal>& view) const;
     void UngetToken(const parser::Token<Terminal>& token) override;
+    parser::TokenStream<Terminal> Tokenize();
     bool IsAtEnd() const override;
+    // Continues lexing at an offset in the source text, discarding tokens pushed back
+    void Seek(std::size_t offset);
 };
 
 } // namespace cmake_parser
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <istream>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace cmake_parser {
+
+// Input script of a model snapshot, with what is needed to tell whether it changed since
+struct SnapshotInput
+{
+    std::filesystem::path path;
+    std::uint64_t size;
+    std::int64_t modificationTime;
+    std::uint64_t contentHash;
+
+    // Reads the file to determine its size, modification time and hash, returns false if it cannot be read
+    static bool Make(const std::filesystem::path& path, SnapshotInput& input);
+    // Returns true if the file still has the same contents. Only the size and modification time are checked, unless
+    // the file was written since, in which case its contents are hashed again.
+    bool IsUnchanged() const;
+};
+
+// Binary encoding of snapshot values: fixed size integers in the byte order of the machine that writes them, and
+// strings as their length followed by their characters
+class SnapshotWriter
+{
+private:
+    std::ostream& m_stream;
+
+public:
+    explicit SnapshotWriter(std::ostream& stream);
+
+    void WriteUInt32(std::uint32_t value);
+    void WriteUInt64(std::uint64_t value);
+    void WriteString(const std::string& value);
+    bool IsValid() const { return static_cast<bool>(m_stream); }
+};
+
+// Reads values written by SnapshotWriter. Any read beyond the end of the data or of an implausible size fails, and
+// makes all further reads fail.
+class SnapshotReader
+{
+private:
+    std::istream& m_stream;
+    std::uint64_t m_remaining;
+
+public:
+    SnapshotReader(std::istream& stream, std::uint64_t size);
+
+    bool ReadUInt32(std::uint32_t& value);
+    bool ReadUInt64(std::uint64_t& value);
+    bool ReadString(std::string& value);
+    // Reads a count of items, which fails if the remaining data cannot hold that many items of at least itemSize bytes
+    bool ReadCount(std::size_t itemSize, std::size_t& count);
+    bool IsValid() const { return static_cast<bool>(m_stream); }
+    bool IsAtEnd() const { return m_remaining == 0; }
+
+private:
+    bool ReadBytes(char* data, std::uint64_t size);
+};
+
+// Describes what a model snapshot was made from: a hash of the configuration the scripts were parsed with, and the
+// scripts that were read. The snapshot is clean, and can be used instead of parsing again, if the configuration is
+// the same and none of the scripts changed.
+class SnapshotManifest
+{
+private:
+    std::uint64_t m_configurationHash;
+    std::vector<SnapshotInput> m_inputs;
+
+public:
+    SnapshotManifest();
+    explicit SnapshotManifest(std::uint64_t configurationHash);
+
+    std::uint64_t ConfigurationHash() const { return m_configurationHash; }
+    const std::vector<SnapshotInput>& Inputs() const { return m_inputs; }
+    // Adds an input script, returns false if it cannot be read
+    bool AddInput(const std::filesystem::path& path);
+    bool IsClean(std::uint64_t configurationHash) const;
+
+    void Write(SnapshotWriter& writer) const;
+    bool Read(SnapshotReader& reader);
+};
+
+} // namespace cmake_parser
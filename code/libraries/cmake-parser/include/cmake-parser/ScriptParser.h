@@ -1,29 +1,68 @@
 #pragma once
 
+#include <memory>
 #include "cmake-parser/CMakeModel.h"
 #include "cmake-parser/Lexer.h"
+#include "cmake-parser/ScriptPrefetcher.h"
+#include "parser/Diagnostic.h"
+#include "parser/ParseArena.h"
 #include "parser/ParserExecutor.h"
+#include "parser/TokenStreamTokenizer.h"
 
 namespace cmake_parser {
 
+// The parser executor reads the tokens between commands through the parser, from the same tokenizer as the handlers
 class ScriptParser
     : public parser::IParserCallback<Terminal>
+    , public parser::ITokenizer<Terminal>
 {
 private:
     std::filesystem::path m_path;
+    // Arena of the parse session, shared with the parsers of subdirectories, or null to use the heap
+    parser::ParseArena* m_arena;
+    // Cache of lexed scripts in parallel mode, shared with the parsers of subdirectories, or null to always lex them
+    const parser::TokenCache* m_tokenCache;
+    // Script read and lexed ahead in parallel mode, null when reading from a stream
+    LexedScriptPtr m_script;
     Lexer m_lexer;
+    // Set while parsing in pipelined mode, then tokens are read from it instead of the lexer
+    parser::PipelinedTokenizer<Terminal, Lexer>* m_pipelinedLexer;
+    // Set while parsing in parallel mode, then tokens are read from the lexed script instead of the lexer
+    parser::TokenStreamTokenizer<Terminal>* m_streamLexer;
+    // Set after an invalid token in ErrorMode::Recover, then tokens are read from it, from the line end after the
+    // invalid token on
+    std::unique_ptr<Lexer> m_recoveryLexer;
+    // Reads the scripts of subdirectories ahead in parallel mode, shared with the parsers of subdirectories
+    ScriptPrefetcher* m_prefetcher;
     parser::Token<Terminal> m_currentToken;
+    // Parentheses opened and not closed since the parser executor read the last token, and whether a line end was
+    // read outside parentheses since then, which ends a command
+    int m_parenthesisDepth;
+    bool m_commandEnded;
     int m_errorCount;
+    // Mode of the current parse, also used for the scripts of subdirectories
+    parser::ParseMode m_parseMode;
+    parser::ErrorMode m_errorMode;
+    parser::Diagnostics m_diagnostics;
     CMakeModel& m_model;
     ProjectPtr m_mainProject;
     ProjectPtr m_currentProject;
     TargetPtr m_currentTarget;
 
 public:
-    ScriptParser(CMakeModel& model, const std::filesystem::path& rootDirectory, std::istream& stream);
-    bool Parse();
+    ScriptParser(CMakeModel& model, const std::filesystem::path& rootDirectory, std::istream& stream, parser::ParseArena* arena = nullptr,
+                 const parser::TokenCache* tokenCache = nullptr);
+    // Parser for the script of a subdirectory in parallel mode
+    ScriptParser(CMakeModel& model, const LexedScriptPtr& script, ScriptPrefetcher& prefetcher, parser::ParseArena* arena = nullptr);
+    // In ErrorMode::Recover, parsing continues after an error at the next command, and all errors are collected in
+    // GetDiagnostics(), including those of subdirectories. The model then holds the commands that were parsed.
+    // In ParseMode::Parallel, the scripts of subdirectories are read and lexed on a thread pool, and evaluated in
+    // the same order as in the other modes, so the model is the same. Scripts are then lexed as a whole, and loaded
+    // from the token cache if one is set.
+    bool Parse(parser::ParseMode mode = parser::ParseMode::Sequential, parser::ErrorMode errorMode = parser::ErrorMode::Stop);
 
     const CMakeModel& GetModel() const { return m_model; }
+    const parser::Diagnostics& GetDiagnostics() const { return m_diagnostics; }
 
     std::string ParseVersion(const TerminalSet& endTerminals);
     std::string ParseDescription();
@@ -38,11 +77,11 @@ public:
     void SkipWhitespace();
     std::string Expect(Terminal type);
     std::string Expect_SkipWhitespace(Terminal type);
-    parser::Token<Terminal> Expect(std::set<Terminal> oneOfTypes);
-    parser::Token<Terminal> Expect_SkipWhitespace(std::set<Terminal> oneOfTypes);
+    parser::Token<Terminal> Expect(const TerminalSet& oneOfTypes);
+    parser::Token<Terminal> Expect_SkipWhitespace(const TerminalSet& oneOfTypes);
     std::string ExpectVariable();
-    std::filesystem::path ExpectPath(const std::set<Terminal>& finalizers);
-    std::string ExpectExpression(const std::set<Terminal>& finalizers);
+    std::filesystem::path ExpectPath(const TerminalSet& finalizers);
+    std::string ExpectExpression(const TerminalSet& finalizers);
     std::string ExpectExpressionPart();
 
     std::string Evaluate(const std::string& expression) const;
@@ -59,16 +98,28 @@ public:
     bool HandleTargetCompileDefinitions();
     bool HandleTargetCompileOptions();
     bool HandleUnsupported();
+    bool HandleCommand(const parser::Token<Terminal>& token);
 
     bool OnToken(const parser::Token<Terminal>&, bool& done) override;
     bool OnNoMoreToken(const parser::SourceLocation& location) override;
     void OnSkipToken(const parser::Token<Terminal>& token) override;
     void OnParseError(const parser::Token<Terminal>& token) override;
+    bool OnRecover(parser::ITokenizer<Terminal>& tokenizer) override;
+
+    parser::Token<Terminal> GetToken() override;
+    void UngetToken(const parser::Token<Terminal>& token) override;
+    parser::SourceLocation GetCurrentLocation() const override;
+    bool IsAtEnd() const override;
 
     std::string Serialize() const;
 
 private:
+    bool ParseParallel(parser::ParserExecutor<Terminal>& parserExecutor);
+    void AddDiagnostic(const parser::SourceLocation& location, const std::string& message);
     std::string ReadScopedArguments();
+    parser::TokenView<Terminal> GetTokenView();
+    parser::TokenView<Terminal> LimitToLine(const parser::TokenView<Terminal>& view);
+    parser::Token<Terminal> MakeToken(const parser::TokenView<Terminal>& view) const;
 };
 
 } // namespace cmake_parser
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <filesystem>
+#include <future>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include "cmake-parser/Lexer.h"
+#include "parser/ThreadPool.h"
+#include "parser/TokenStream.h"
+
+namespace cmake_parser {
+
+// Script of a directory, read and lexed before it is parsed. The tokens refer to the text.
+struct LexedScript
+{
+    std::filesystem::path directory;
+    std::string text;
+    std::optional<parser::TokenStream<Terminal>> tokens;
+};
+
+using LexedScriptPtr = std::shared_ptr<const LexedScript>;
+
+// Reads and lexes the scripts of subdirectories on a thread pool, before the parser gets to their add_subdirectory
+// command. When a script is lexed, the subdirectories it adds with a literal path are prefetched as well, so a
+// directory tree is read in parallel while the scripts are evaluated one by one, in order.
+// Only reading and lexing are done ahead, which do not depend on the model, so parsing gives the same result.
+class ScriptPrefetcher
+{
+private:
+    std::mutex m_mutex;
+    std::map<std::filesystem::path, std::shared_future<LexedScriptPtr>> m_scripts;
+    // Cache of lexed scripts, or null to always lex them
+    const parser::TokenCache* m_tokenCache;
+    // Destroyed first, finishing the tasks that still use the scripts
+    parser::ThreadPool m_pool;
+
+public:
+    // With numThreads 0, the number of hardware threads is used. Scripts lexed before are loaded from the token cache,
+    // if there is one.
+    explicit ScriptPrefetcher(std::size_t numThreads = 0, const parser::TokenCache* tokenCache = nullptr);
+
+    // Starts reading the script of a directory, if it was not read yet
+    void Prefetch(const std::filesystem::path& directory);
+    // Prefetches the subdirectories added with a literal path in the lexed script of a directory
+    void PrefetchSubdirectories(const std::filesystem::path& directory, const parser::TokenStream<Terminal>& tokens);
+    // Returns the script of a directory, waiting for it if it is being read, or reading it now if it was not prefetched
+    LexedScriptPtr Get(const std::filesystem::path& directory);
+
+    // Reads and lexes the script of a directory, or loads its tokens from the cache. A directory without a script has
+    // an empty script.
+    static LexedScriptPtr Load(const std::filesystem::path& directory, const parser::TokenCache* tokenCache = nullptr);
+
+private:
+    LexedScriptPtr LoadAndPrefetch(const std::filesystem::path& directory);
+};
+
+} // namespace cmake_parser
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "cmake-parser/Symbol.h"
+
+namespace cmake_parser {
+
+class CMakeModel;
+
+namespace expression {
+
+// String with variable references, compiled once into a sequence of operations, so that it can be expanded in one pass.
+// Literal text is appended to the result, and a reference ${name} collects the expansion of its name, which can
+// contain references itself as in ${${name}}, and then appends the value of the variable with that name.
+// A reference without closing brace is kept as text, and a $ that does not start a reference is dropped, as in the
+// fixed point expansion of Expression::EvaluateString.
+class StringTemplate
+{
+public:
+    enum class OpCode
+    {
+        Literal,
+        BeginReference,
+        EndReference,
+        EndUnterminatedReference,
+    };
+    struct Op
+    {
+        OpCode code;
+        std::string text;
+        // For EndReference, the interned name of a reference without nested references, looked up without building the name
+        Symbol name;
+    };
+
+    static constexpr std::size_t MaxCacheSize = 4096;
+
+private:
+    std::vector<Op> m_ops;
+    std::size_t m_maxDepth;
+
+public:
+    explicit StringTemplate(std::string_view text);
+
+    // Returns the compiled template for a text from a per thread cache, compiling it on first use
+    static std::shared_ptr<const StringTemplate> Get(const std::string& text);
+
+    const std::vector<Op>& Ops() const { return m_ops; }
+    bool HasReferences() const { return m_maxDepth > 0; }
+    // Expands the references with the variables of the model, looking up every variable once. Returns false if a
+    // value contains $, { or }, which a fixed point expansion would evaluate again.
+    bool Evaluate(const CMakeModel& model, std::string& result) const;
+
+private:
+    void AddLiteral(std::string& literal);
+};
+
+} // namespace expression
+} // namespace cmake_parser
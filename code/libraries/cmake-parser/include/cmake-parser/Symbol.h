@@ -0,0 +1,58 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <ostream>
+#include <string>
+#include <string_view>
+
+namespace cmake_parser {
+
+// Interned name of a variable, property or target. Each distinct name is stored once in a process wide table and
+// identified by a 32-bit id, so symbols compare and hash as integers. Names are never removed from the table, so the
+// name of a symbol stays valid for the lifetime of the process. Id 0 is the empty name.
+class Symbol
+{
+private:
+    std::uint32_t m_id;
+
+public:
+    Symbol()
+        : m_id{}
+    {}
+    // Interns the name, adding it to the table if it is new
+    explicit Symbol(std::string_view name);
+
+    // Finds the symbol of a name without adding it, returns false if the name was never interned
+    static bool Find(std::string_view name, Symbol& symbol);
+    // Number of names in the table, including the empty name
+    static std::size_t TableSize();
+
+    std::uint32_t Id() const { return m_id; }
+    bool IsEmpty() const { return m_id == 0; }
+    const std::string& Name() const;
+
+    friend bool operator == (Symbol lhs, Symbol rhs) { return lhs.m_id == rhs.m_id; }
+    friend bool operator != (Symbol lhs, Symbol rhs) { return lhs.m_id != rhs.m_id; }
+};
+
+inline std::ostream& operator << (std::ostream& stream, Symbol value)
+{
+    return stream << value.Name();
+}
+
+} // namespace cmake_parser
+
+namespace std {
+
+template<>
+struct hash<cmake_parser::Symbol>
+{
+    std::size_t operator()(cmake_parser::Symbol symbol) const noexcept
+    {
+        // Ids are dense, so they spread over the buckets as they are
+        return symbol.Id();
+    }
+};
+
+} // namespace std
@@ -4,12 +4,13 @@
 #include <memory>
 #include <string>
 #include "cmake-parser/Serialization.h"
+#include "cmake-parser/Symbol.h"
 
 namespace cmake_parser {
 
 struct TypedVariable
 {
-    std::string m_name;
+    Symbol m_name;
     std::string m_type;
     std::string m_value;
     std::string m_description;
@@ -28,7 +29,8 @@ struct TypedVariable
         , m_description{ description }
     {
     }
-    const std::string& Name() const { return m_name; }
+    Symbol NameSymbol() const { return m_name; }
+    const std::string& Name() const { return m_name.Name(); }
     const std::string& Type() const { return m_type; }
     const std::string& Value() const { return m_value; }
     const std::string& Description() const { return m_description; }
@@ -1,28 +1,36 @@
 #pragma once
 
 #include <map>
+#include <unordered_map>
 #include "cmake-parser/TypedVariable.h"
 
 namespace cmake_parser {
 
 using TypedVariables = std::map<std::string, TypedVariablePtr>;
+using TypedVariableMap = std::unordered_map<Symbol, TypedVariablePtr>;
 
+// Variables keyed by their interned name, names are only ordered as strings for GetVariables and serialization
 class TypedVariableList
 {
 private:
-    TypedVariables m_variables;
+    TypedVariableMap m_variables;
+    // All variables ordered by name, built on the first request and kept up to date from then on, so that a reference
+    // returned by GetVariables stays valid
+    mutable TypedVariables m_ordered;
+    mutable bool m_orderedIsValid;
 
 public:
     TypedVariableList();
     TypedVariableList(const TypedVariableList& other);
     TypedVariableList& operator = (const TypedVariableList& other);
 
-    const TypedVariables& GetVariables() const { return m_variables; }
+    const TypedVariables& GetVariables() const;
     std::string GetVariable(const std::string& name) const;
     void SetVariable(const std::string& name, const std::string& type, const std::string& value, const std::string& description);
     void UnsetVariable(const std::string& name);
 
     TypedVariablePtr FindVariable(const std::string& name) const;
+    TypedVariablePtr FindVariable(Symbol name) const;
     void AddVariable(const std::string& name, TypedVariablePtr variable);
 
     std::string Serialize(SerializationFormat format = SerializationFormat::Text, unsigned indent = 0) const;
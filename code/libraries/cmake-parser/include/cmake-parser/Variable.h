@@ -4,12 +4,13 @@
 #include <memory>
 #include <string>
 #include "cmake-parser/Serialization.h"
+#include "cmake-parser/Symbol.h"
 
 namespace cmake_parser {
 
 struct Variable
 {
-    std::string m_name;
+    Symbol m_name;
     std::string m_value;
 
     Variable(const std::string& name)
@@ -22,7 +23,13 @@ struct Variable
         , m_value{ value }
     {
     }
-    const std::string& Name() const { return m_name; }
+    Variable(Symbol name, const std::string& value)
+        : m_name{ name }
+        , m_value{ value }
+    {
+    }
+    Symbol NameSymbol() const { return m_name; }
+    const std::string& Name() const { return m_name.Name(); }
     const std::string& Value() const { return m_value; }
     void SetValue(const std::string& value) { m_value = value; }
 
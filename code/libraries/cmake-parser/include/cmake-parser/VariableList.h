@@ -1,31 +1,72 @@
 #pragma once
 
 #include <map>
+#include <unordered_map>
 #include "cmake-parser/Variable.h"
 
 namespace cmake_parser {
 
 using Variables = std::map<std::string, VariablePtr>;
+using VariableMap = std::unordered_map<Symbol, VariablePtr>;
 
+// Variables of a scope. A child scope does not copy the variables of its parent: the variables set so far are frozen
+// into a layer shared by both scopes, and each scope keeps the variables it sets or unsets on top of it. Entering a
+// scope is therefore constant time, and memory grows with the number of variables changed in a scope.
+// Variables found in a frozen layer are shared between scopes, and must not be modified in place, see
+// FindLocalVariable.
+// Variables are keyed by their interned name, names are only ordered as strings for GetVariables and serialization.
 class VariableList
 {
 private:
-    Variables m_variables;
+    struct Layer
+    {
+        VariableMap variables;
+        std::shared_ptr<const Layer> parent;
+        std::size_t depth;
+    };
+    using LayerPtr = std::shared_ptr<const Layer>;
+
+    // Frozen layers beyond this depth are merged into one, to bound lookup time
+    static constexpr std::size_t MaxLayerDepth = 16;
+
+    // Variables set in this scope, a null variable hides a variable of a frozen layer
+    VariableMap m_variables;
+    LayerPtr m_frozen;
+    // All visible variables ordered by name, built on the first request and kept up to date from then on, so that a
+    // reference returned by GetVariables stays valid
+    mutable Variables m_merged;
+    mutable bool m_mergedIsValid;
 
 public:
     VariableList();
     VariableList(const VariableList& other);
+    VariableList(VariableList&& other) = default;
     VariableList& operator = (const VariableList& other);
+    VariableList& operator = (VariableList&& other) = default;
+
+    // Returns a scope that starts with the variables of this scope, without copying them
+    VariableList CreateChildScope();
 
-    const Variables& GetVariables() const { return m_variables; }
+    const Variables& GetVariables() const;
     std::string GetVariable(const std::string& name) const;
     void SetVariable(const std::string& name, const std::string& value);
     void UnsetVariable(const std::string& name);
 
     VariablePtr FindVariable(const std::string& name) const;
+    VariablePtr FindVariable(Symbol name) const;
+    // Finds a variable set in this scope itself, which can be modified without affecting other scopes
+    VariablePtr FindLocalVariable(const std::string& name) const;
+    VariablePtr FindLocalVariable(Symbol name) const;
     void AddVariable(const std::string& name, VariablePtr variable);
+    void AddVariable(Symbol name, VariablePtr variable);
+    void UnsetVariable(Symbol name);
 
     std::string Serialize(SerializationFormat format = SerializationFormat::Text, unsigned indent = 0) const;
+
+private:
+    VariablePtr FindFrozenVariable(Symbol name) const;
+    void Freeze();
+    void Merge(VariableMap& variables) const;
 };
 
 inline std::ostream& operator << (std::ostream& stream, const VariableList& value)
@@ -33,4 +74,4 @@ inline std::ostream& operator << (std::ostream& stream, const VariableList& valu
     return stream << value.Serialize();
 }
 
-} // namespace cmake_parser
\ No newline at end of file
+} // namespace cmake_parser
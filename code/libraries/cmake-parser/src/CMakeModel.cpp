@@ -1,7 +1,11 @@
 #include "cmake-parser/CMakeModel.h"
 
+#include <algorithm>
 #include <cassert>
+#include <fstream>
+#include <functional>
 #include <iostream>
+#include <set>
 #include "utility/StringFunctions.h"
 #include "tracing/Tracing.h"
 #include "cmake-parser/Expression.h"
@@ -293,6 +297,12 @@ VariablePtr CMakeModel::FindVariable(const std::string& name) const
     return m_scopeVariables->FindVariable(name);
 }
 
+VariablePtr CMakeModel::FindVariable(Symbol name) const
+{
+    assert(IsSourceRootSet());
+    return m_scopeVariables->FindVariable(name);
+}
+
 static std::string ReplaceQuotesExceptEscapedOnes(const std::string& text)
 {
     std::string result;
@@ -354,12 +364,14 @@ void CMakeModel::SetVariable(const std::string& name, const std::string& value,
     else
     {
         assert(IsSourceRootSet());
-        auto var = m_scopeVariables->FindVariable(evaluatedName);
+        // A variable inherited from an enclosing scope is shared with it, so it is replaced in this scope instead of updated
+        Symbol symbol(evaluatedName);
+        auto var = m_scopeVariables->FindLocalVariable(symbol);
         if (var == nullptr)
         {
             TRACE_DATA("Add new variable {} = {}", evaluatedName, evaluatedValue);
-            var = std::make_shared<Variable>(evaluatedName, evaluatedValue);
-            m_scopeVariables->AddVariable(evaluatedName, var);
+            var = std::make_shared<Variable>(symbol, evaluatedValue);
+            m_scopeVariables->AddVariable(symbol, var);
         }
         else
         {
@@ -466,6 +478,345 @@ std::string CMakeModel::Evaluate(const std::string& value)
     return expression::Expression::EvaluateString(*this, value);
 }
 
+// "CMSN" in the byte order of the machine that wrote the snapshot
+static constexpr std::uint32_t SnapshotMagic = 0x4E534D43u;
+
+// Directories ordered so that every directory follows its parent
+static std::vector<DirectoryPtr> ParentsFirst(const Directories& directories)
+{
+    std::vector<DirectoryPtr> result;
+    std::set<const Directory*> added;
+    std::function<void(const DirectoryPtr&)> add = [&](const DirectoryPtr& directory)
+    {
+        if ((directory == nullptr) || !added.insert(directory.get()).second)
+            return;
+        add(directory->Parent());
+        result.push_back(directory);
+    };
+    for (auto const& item : directories)
+    {
+        add(item.second);
+    }
+    return result;
+}
+
+// Projects ordered so that every project follows its parent
+static std::vector<ProjectPtr> ParentsFirst(const Projects& projects)
+{
+    std::vector<ProjectPtr> result;
+    std::set<const Project*> added;
+    std::function<void(const ProjectPtr&)> add = [&](const ProjectPtr& project)
+    {
+        if ((project == nullptr) || !added.insert(project.get()).second)
+            return;
+        add(project->Parent());
+        result.push_back(project);
+    };
+    for (auto const& item : projects)
+    {
+        add(item.second);
+    }
+    return result;
+}
+
+static void WriteVariables(SnapshotWriter& writer, const Variables& variables)
+{
+    std::size_t count{};
+    for (auto const& variable : variables)
+    {
+        if (variable.second != nullptr)
+            ++count;
+    }
+    writer.WriteUInt64(count);
+    for (auto const& variable : variables)
+    {
+        if (variable.second == nullptr)
+            continue;
+        writer.WriteString(variable.first);
+        writer.WriteString(variable.second->Value());
+    }
+}
+
+static bool ReadVariables(SnapshotReader& reader, VariableList& variables)
+{
+    // Each variable holds at least the lengths of its name and value
+    std::size_t count{};
+    if (!reader.ReadCount(2 * sizeof(std::uint64_t), count))
+        return false;
+    for (std::size_t index = 0; index < count; ++index)
+    {
+        std::string name;
+        std::string value;
+        if (!reader.ReadString(name) || !reader.ReadString(value))
+            return false;
+        variables.SetVariable(name, value);
+    }
+    return true;
+}
+
+bool CMakeModel::SaveSnapshot(const std::filesystem::path& path, const SnapshotManifest& manifest) const
+{
+    assert(IsSourceRootSet());
+    auto temporaryPath = path;
+    temporaryPath += ".tmp";
+    std::error_code error;
+    {
+        std::ofstream stream(temporaryPath, std::ios::binary | std::ios::trunc);
+        SnapshotWriter writer(stream);
+        writer.WriteUInt32(SnapshotMagic);
+        writer.WriteUInt32(SnapshotFormatVersion);
+        manifest.Write(writer);
+
+        auto const& cacheVariables = m_cache.GetVariables();
+        writer.WriteUInt64(cacheVariables.size());
+        for (auto const& variable : cacheVariables)
+        {
+            writer.WriteString(variable.first);
+            writer.WriteString((variable.second != nullptr) ? variable.second->Type() : std::string{});
+            writer.WriteString((variable.second != nullptr) ? variable.second->Value() : std::string{});
+            writer.WriteString((variable.second != nullptr) ? variable.second->Description() : std::string{});
+        }
+        WriteVariables(writer, m_environment.GetVariables());
+
+        // The variables of a directory are stored as the changes to those of its parent
+        auto directories = ParentsFirst(m_directories.GetDirectories());
+        writer.WriteUInt64(directories.size());
+        for (auto const& directory : directories)
+        {
+            static const Variables NoVariables;
+            auto parent = directory->Parent();
+            auto const& parentVariables = (parent != nullptr) ? parent->GetVariables() : NoVariables;
+            auto const& variables = directory->GetVariables();
+            Variables changed;
+            std::vector<std::string> unset;
+            for (auto const& variable : variables)
+            {
+                auto it = parentVariables.find(variable.first);
+                if ((it == parentVariables.end()) || (it->second == nullptr) || (variable.second == nullptr) || (it->second->Value() != variable.second->Value()))
+                    changed.insert(variable);
+            }
+            for (auto const& variable : parentVariables)
+            {
+                if (variables.find(variable.first) == variables.end())
+                    unset.push_back(variable.first);
+            }
+            writer.WriteString(directory->SourcePath().string());
+            writer.WriteString(directory->BinaryPath().string());
+            writer.WriteString((parent != nullptr) ? parent->SourcePath().string() : std::string{});
+            WriteVariables(writer, changed);
+            writer.WriteUInt64(unset.size());
+            for (auto const& name : unset)
+            {
+                writer.WriteString(name);
+            }
+        }
+
+        // The main project goes first, it has no parent and is the first project without parent to be added
+        auto projects = ParentsFirst(m_projects.GetProjects());
+        std::stable_partition(projects.begin(), projects.end(), [this](const ProjectPtr& project) { return project == GetMainProject(); });
+        writer.WriteUInt64(projects.size());
+        for (auto const& project : projects)
+        {
+            auto parent = project->Parent();
+            auto directory = project->Directory();
+            writer.WriteString(project->Name());
+            writer.WriteString(project->Version());
+            writer.WriteString(project->Description());
+            writer.WriteString(project->Languages());
+            writer.WriteString(project->HomePageURL());
+            writer.WriteString((parent != nullptr) ? parent->Name() : std::string{});
+            writer.WriteString((directory != nullptr) ? directory->SourcePath().string() : std::string{});
+            auto targets = project->GetTargets();
+            writer.WriteUInt64(targets.size());
+            for (auto const& item : targets)
+            {
+                auto const& target = item.second;
+                writer.WriteString(target->Name());
+                writer.WriteUInt32(static_cast<std::uint32_t>(target->Type()));
+                writer.WriteUInt32(static_cast<std::uint32_t>(target->Attributes()));
+                writer.WriteString(target->Sources().ToString());
+                writer.WriteString(target->AliasTarget());
+                WriteVariables(writer, target->GetProperties());
+            }
+        }
+        writer.WriteString((m_rootProject != nullptr) ? m_rootProject->Name() : std::string{});
+        writer.WriteString((m_currentProject != nullptr) ? m_currentProject->Name() : std::string{});
+
+        if (!stream.flush())
+        {
+            stream.close();
+            std::filesystem::remove(temporaryPath, error);
+            return false;
+        }
+    }
+    std::filesystem::rename(temporaryPath, path, error);
+    if (error)
+    {
+        std::filesystem::remove(temporaryPath, error);
+        return false;
+    }
+    return true;
+}
+
+bool CMakeModel::LoadSnapshot(const std::filesystem::path& path, std::uint64_t configurationHash)
+{
+    assert(IsSourceRootSet());
+    std::error_code error;
+    auto fileSize = std::filesystem::file_size(path, error);
+    if (error)
+        return false;
+    std::ifstream stream(path, std::ios::binary);
+    SnapshotReader reader(stream, fileSize);
+    std::uint32_t magic{};
+    std::uint32_t formatVersion{};
+    SnapshotManifest manifest;
+    if (!reader.ReadUInt32(magic) || (magic != SnapshotMagic) ||
+        !reader.ReadUInt32(formatVersion) || (formatVersion != SnapshotFormatVersion) ||
+        !manifest.Read(reader))
+        return false;
+    if (!manifest.IsClean(configurationHash))
+    {
+        TRACE_INFO("Snapshot {} is out of date", path.string());
+        return false;
+    }
+
+    // Everything is read into new objects first, so that the model is unchanged if the snapshot turns out to be invalid
+    const std::size_t MinStringSize = sizeof(std::uint64_t);
+    std::size_t count{};
+    CMakeCache cache;
+    TypedVariables defaultCacheVariables = cache.GetVariables();
+    for (auto const& variable : defaultCacheVariables)
+    {
+        cache.UnsetVariable(variable.first);
+    }
+    if (!reader.ReadCount(4 * MinStringSize, count))
+        return false;
+    for (std::size_t index = 0; index < count; ++index)
+    {
+        std::string name;
+        std::string type;
+        std::string value;
+        std::string description;
+        if (!reader.ReadString(name) || !reader.ReadString(type) || !reader.ReadString(value) || !reader.ReadString(description))
+            return false;
+        cache.SetVariable(name, type, value, description);
+    }
+    VariableList environment;
+    if (!ReadVariables(reader, environment))
+        return false;
+
+    DirectoryList directories;
+    std::map<std::string, DirectoryPtr> directoriesByPath;
+    if (!reader.ReadCount(3 * MinStringSize, count))
+        return false;
+    for (std::size_t index = 0; index < count; ++index)
+    {
+        std::string sourcePath;
+        std::string binaryPath;
+        std::string parentPath;
+        if (!reader.ReadString(sourcePath) || !reader.ReadString(binaryPath) || !reader.ReadString(parentPath))
+            return false;
+        DirectoryPtr directory;
+        if (parentPath.empty())
+        {
+            directory = std::make_shared<Directory>(sourcePath, binaryPath);
+        }
+        else
+        {
+            auto parent = directoriesByPath.find(parentPath);
+            if (parent == directoriesByPath.end())
+                return false;
+            directory = std::make_shared<Directory>(sourcePath, binaryPath, parent->second);
+        }
+        std::size_t numUnset{};
+        if (!ReadVariables(reader, directory->GetVariableList()) || !reader.ReadCount(MinStringSize, numUnset))
+            return false;
+        for (std::size_t unsetIndex = 0; unsetIndex < numUnset; ++unsetIndex)
+        {
+            std::string name;
+            if (!reader.ReadString(name))
+                return false;
+            directory->UnsetVariable(name);
+        }
+        if (!directories.AddDirectory(directory))
+            return false;
+        directoriesByPath[sourcePath] = directory;
+    }
+    auto rootDirectory = directories.GetRootDirectory();
+    if (rootDirectory == nullptr)
+        return false;
+
+    ProjectList projects;
+    if (!reader.ReadCount(8 * MinStringSize, count))
+        return false;
+    for (std::size_t index = 0; index < count; ++index)
+    {
+        std::string name;
+        std::string version;
+        std::string description;
+        std::string languages;
+        std::string homePageURL;
+        std::string parentName;
+        std::string directoryPath;
+        std::size_t numTargets{};
+        if (!reader.ReadString(name) || !reader.ReadString(version) || !reader.ReadString(description) || !reader.ReadString(languages) ||
+            !reader.ReadString(homePageURL) || !reader.ReadString(parentName) || !reader.ReadString(directoryPath) ||
+            !reader.ReadCount(4 * MinStringSize + 2 * sizeof(std::uint32_t), numTargets))
+            return false;
+        ProjectPtr parent;
+        if (!parentName.empty())
+        {
+            parent = projects.GetProject(parentName);
+            if (parent == nullptr)
+                return false;
+        }
+        auto directory = directoriesByPath.find(directoryPath);
+        auto project = std::make_shared<Project>((directory != directoriesByPath.end()) ? directory->second : nullptr, name, parent);
+        project->SetVersion(version);
+        project->SetDescription(description);
+        project->SetLanguages(languages);
+        project->SetHomePageURL(homePageURL);
+        for (std::size_t targetIndex = 0; targetIndex < numTargets; ++targetIndex)
+        {
+            std::string targetName;
+            std::uint32_t type{};
+            std::uint32_t attributes{};
+            std::string sources;
+            std::string aliasTarget;
+            if (!reader.ReadString(targetName) || !reader.ReadUInt32(type) || !reader.ReadUInt32(attributes) ||
+                !reader.ReadString(sources) || !reader.ReadString(aliasTarget))
+                return false;
+            auto target = std::make_shared<Target>(project, targetName, static_cast<TargetType>(type), static_cast<TargetAttribute>(attributes), sources, aliasTarget);
+            VariableList properties;
+            if (!ReadVariables(reader, properties))
+                return false;
+            for (auto const& property : properties.GetVariables())
+            {
+                target->SetProperty(property.first, property.second->Value());
+            }
+            project->AddTarget(target);
+        }
+        if (!projects.AddProject(project))
+            return false;
+    }
+    std::string rootProjectName;
+    std::string currentProjectName;
+    if (!reader.ReadString(rootProjectName) || !reader.ReadString(currentProjectName) || !reader.IsAtEnd())
+        return false;
+
+    m_cache = std::move(cache);
+    m_environment = std::move(environment);
+    m_projects = std::move(projects);
+    m_rootProject = m_projects.GetProject(rootProjectName);
+    m_currentProject = m_projects.GetProject(currentProjectName);
+    m_directories = std::move(directories);
+    m_rootDirectory = rootDirectory;
+    m_directoryStack = DirectoryStack();
+    m_directoryStack.Push(m_rootDirectory);
+    m_scopeVariables = &m_rootDirectory->GetVariableList();
+    return true;
+}
+
 std::string CMakeModel::Serialize(SerializationFormat format, unsigned indent) const
 {
     std::ostringstream stream;
@@ -1,6 +1,9 @@
 #include "cmake-parser/CMakeParser.h"
 
 #include <fstream>
+#include <optional>
+#include <sstream>
+#include "parser/ContentHash.h"
 #include "utility/CommandLine.h"
 #include "utility/StringFunctions.h"
 #include "tracing/Tracing.h"
@@ -48,14 +51,61 @@ CMakeParser::CMakeParser(const std::filesystem::path& rootDirectory, const std::
     , m_rootDirectory{ rootDirectory }
     , m_buildDirectoryName{ buildDirectoryName }
     , m_stream{ stream }
+    , m_diagnostics{}
+    , m_snapshotPath{}
+    , m_loadedFromSnapshot{}
+    , m_tokenCacheDirectory{}
 {
     Setup();
 }
 
-bool CMakeParser::Parse()
+bool CMakeParser::Parse(ParseMode mode, ErrorMode errorMode)
 {
-    ScriptParser parser{ m_model, m_rootDirectory, m_stream };
-    return parser.Parse();
+    m_loadedFromSnapshot = false;
+    if (m_snapshotPath.empty())
+        return ParseScript(m_stream, mode, errorMode);
+
+    // The snapshot is only valid for the same main script, the same model before parsing (paths, tools, environment)
+    // and the same grammar, the scripts of subdirectories are checked through its manifest
+    std::string mainScript{ std::istreambuf_iterator<char>(m_stream), std::istreambuf_iterator<char>() };
+    auto configurationHash = ContentHash(m_model.Serialize(SerializationFormat::JSON, 0) + mainScript, Lexer::GrammarId());
+    if (m_model.LoadSnapshot(m_snapshotPath, configurationHash))
+    {
+        TRACE_INFO("Loaded model from snapshot {}", m_snapshotPath.string());
+        m_diagnostics.clear();
+        m_loadedFromSnapshot = true;
+        return true;
+    }
+
+    std::istringstream stream(mainScript);
+    auto result = ParseScript(stream, mode, errorMode);
+    // A model with errors is parsed again next time, so that its errors are reported again
+    if (result && m_diagnostics.empty())
+    {
+        SnapshotManifest manifest(configurationHash);
+        bool haveInputs = true;
+        for (auto const& directory : m_model.GetDirectories())
+        {
+            if (directory.second != m_model.GetRootDirectory())
+                haveInputs = manifest.AddInput(directory.second->SourcePath() / CMakeScriptFileName) && haveInputs;
+        }
+        if (!haveInputs || !m_model.SaveSnapshot(m_snapshotPath, manifest))
+            TRACE_WARNING("Could not save snapshot {}", m_snapshotPath.string());
+    }
+    return result;
+}
+
+bool CMakeParser::ParseScript(std::istream& stream, ParseMode mode, ErrorMode errorMode)
+{
+    // The scripts of all directories are read into one arena, which is released when parsing is done
+    ParseArena arena;
+    std::optional<TokenCache> tokenCache;
+    if (!m_tokenCacheDirectory.empty())
+        tokenCache.emplace(m_tokenCacheDirectory);
+    ScriptParser parser{ m_model, m_rootDirectory, stream, &arena, tokenCache ? &*tokenCache : nullptr };
+    auto result = parser.Parse(mode, errorMode);
+    m_diagnostics = parser.GetDiagnostics();
+    return result;
 }
 
 void CMakeParser::Setup()
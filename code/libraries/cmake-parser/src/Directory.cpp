@@ -17,13 +17,9 @@ Directory::Directory(const std::filesystem::path& sourcePath, const std::filesys
 Directory::Directory(const std::filesystem::path& sourcePath, const std::filesystem::path& binaryPath, DirectoryPtr parent)
     : m_sourcePath{ sourcePath }
     , m_binaryPath{ binaryPath }
-    , m_variables{}
+    , m_variables{ (parent != nullptr) ? parent->GetVariableList().CreateChildScope() : VariableList() }
     , m_parentDirectory{ parent }
 {
-    if (parent != nullptr)
-    {
-        m_variables = parent->GetVariableList();
-    }
     TRACE_DEBUG("Create directory {}", Serialize());
 }
 
@@ -2,8 +2,9 @@
 
 #include "utility/StringFunctions.h"
 #include "tracing/Tracing.h"
-
-using namespace parser;
+#include "parser/SourceLocation.h"
+#include "cmake-parser/ExpressionScanner.h"
+#include "cmake-parser/StringTemplate.h"
 
 namespace cmake_parser {
 namespace expression {
@@ -16,8 +17,8 @@ private:
     parser::SourceLocation m_location;
 
 public:
-    UnexpectedToken(const parser::Token<Terminal>& token, const char* fileName, int line)
-        : m_message{ "Unexpected token: " + token.Serialize() }
+    UnexpectedToken(std::string_view token, std::string_view expression, const char* fileName, int line)
+        : m_message{ "Unexpected token: '" + std::string(token) + "' in expression " + std::string(expression) }
         , m_location{ fileName, line, 1 }
     {}
     const char* what() const override
@@ -27,46 +28,19 @@ public:
     const parser::SourceLocation& Location() const { return m_location; }
 };
 
-static void PrintToken(const Token<Terminal>& token)
-{
-    TRACE_DEBUG("Token: {}", token);
-}
-
-static void PrintUngetToken(const Token<Terminal>& token)
-{
-    TRACE_DEBUG("Unget: {}", token);
-}
-
-static void PrintTokenSkip(const Token<Terminal>& token)
-{
-    TRACE_DEBUG("Skip: {}", token);
-}
-
 Expression::Expression(const CMakeModel& model, const std::string& expression)
     : m_model{ model }
-    , m_stream{ expression }
-    , m_lexer{ "", m_stream }
-    , m_currentToken{}
-    , m_errorCount{}
-    , m_result{}
+    , m_expression{ expression }
 {
 }
 
 std::string Expression::Evaluate()
 {
-    if (Parse())
-    {
-        return m_result;
-    }
-    return {};
+    return Evaluate(m_model, m_expression);
 }
 
-std::string Expression::EvaluateString(const std::string& text)
-{
-    return EvaluateString(m_model, text);
-}
-
-std::string Expression::EvaluateString(const CMakeModel& model, const std::string& text)
+// Expands references in the text, and again in the result, until nothing changes
+static std::string ExpandUntilFixedPoint(const CMakeModel& model, const std::string& text)
 {
     std::string prevResult;
     std::string result = text;
@@ -117,104 +91,67 @@ std::string Expression::EvaluateString(const CMakeModel& model, const std::strin
     return result;
 }
 
-bool Expression::Parse()
-{
-    m_result = {};
-    ParserExecutor<Terminal> parserExecutor(*this, { Terminal::Whitespace, Terminal::NewLine });
-
-    return parserExecutor.Parse(m_lexer) && (m_errorCount == 0);
-}
-
-void Expression::NextToken()
-{
-    m_currentToken = m_lexer.GetToken();
-    PrintToken(CurrentToken());
-}
-
-Terminal Expression::CurrentTokenType()
-{
-    return CurrentToken().Type().TypeCode();
-}
-
-const parser::Token<Terminal>& Expression::CurrentToken()
+std::string Expression::EvaluateString(const std::string& text)
 {
-    return m_currentToken;
+    return EvaluateString(m_model, text);
 }
 
-void Expression::UngetCurrentToken()
+std::string Expression::EvaluateString(const CMakeModel& model, const std::string& text)
 {
-    m_lexer.UngetToken(CurrentToken());
-    PrintUngetToken(CurrentToken());
+    if (text.find('$') == std::string::npos)
+        return text;
+    std::string result;
+    if (StringTemplate::Get(text)->Evaluate(model, result))
+        return result;
+    // A variable value holds references or braces, so the result is expanded again
+    return ExpandUntilFixedPoint(model, text);
 }
 
-void Expression::SkipWhitespace()
+static std::string_view Expect(Scanner& scanner, Terminal expected, std::string_view expression)
 {
-    while ((CurrentTokenType() == Terminal::Whitespace) || (CurrentTokenType() == Terminal::NewLine))
+    Terminal type{};
+    std::string_view value;
+    if (!scanner.Next(type, value) || (type != expected))
     {
-        NextToken();
+        TRACE_ERROR("Parse error: unexpected token '{}' in expression {}", value, expression);
+        throw UnexpectedToken(value, expression, __FILE__, __LINE__);
     }
+    return value;
 }
 
-std::string Expression::Expect(Terminal type)
-{
-    if (CurrentTokenType() != type)
-    {
-        OnParseError(CurrentToken());
-        throw UnexpectedToken(CurrentToken(), __FILE__, __LINE__);
-    }
-    auto result = CurrentToken().Value();
-    NextToken();
-    return result;
-}
-
-std::string Expression::Expect_SkipWhitespace(Terminal type)
-{
-    SkipWhitespace();
-    return Expect(type);
-}
-
-bool Expression::OnToken(const parser::Token<Terminal>& token, bool& done)
+std::string Expression::Evaluate(const CMakeModel& model, std::string_view expression)
 {
-    done = false;
-    PrintToken(token);
-    switch (token.Type().TypeCode())
+    std::string result;
+    Scanner scanner(expression);
+    Terminal type{};
+    std::string_view value;
+    while (scanner.Next(type, value))
     {
-    case Terminal::String:
-        m_result += utility::UnQuote(EvaluateString(token.Value()));
-        break;
-    case Terminal::Dollar:
+        switch (type)
         {
-            NextToken();
-            Expect(Terminal::CurlyBraceOpen);
-            auto variableName = Expect(Terminal::Name);
-            Expect(Terminal::CurlyBraceClose);
-            UngetCurrentToken();
-            m_result += m_model.GetVariable(variableName);
+        case Terminal::None:
+            TRACE_ERROR("Parse error: invalid text '{}' in expression {}", value, expression);
+            return {};
+        case Terminal::Whitespace:
+        case Terminal::NewLine:
+            break;
+        case Terminal::String:
+            result += utility::UnQuote(EvaluateString(model, std::string(value)));
+            break;
+        case Terminal::Dollar:
+            {
+                Expect(scanner, Terminal::CurlyBraceOpen, expression);
+                auto variableName = Expect(scanner, Terminal::Name, expression);
+                Expect(scanner, Terminal::CurlyBraceClose, expression);
+                result += model.GetVariable(std::string(variableName));
+            }
+            break;
+        default:
+            result += value;
+            break;
         }
-        break;
-    default:
-        m_result += token.Value();
-        break;
     }
-
-    return true;
-}
-
-bool Expression::OnNoMoreToken(const parser::SourceLocation& /*location*/)
-{
-    TRACE_INFO("No more tokens");
-    return true;
-}
-
-void Expression::OnSkipToken(const parser::Token<Terminal>& token)
-{
-    PrintTokenSkip(token);
-}
-
-void Expression::OnParseError(const parser::Token<Terminal>& token)
-{
-    m_errorCount++;
-    TRACE_ERROR("Parse error: unexpected token {}", token);
+    return result;
 }
 
 } // namespace expression
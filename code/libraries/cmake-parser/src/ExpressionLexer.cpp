@@ -1,6 +1,6 @@
 #include "cmake-parser/ExpressionLexer.h"
 
-#include "parser/TokenizerRule.h"
+#include "parser/TokenizerRuleSet.h"
 
 using namespace parser;
 
@@ -41,13 +41,15 @@ static TokenizerRules<Terminal> tokenizerRules{
     { "[0-9]+", DigitSequence },
 };
 
+const TokenizerRuleSet<Terminal>& Lexer::GetRuleSet()
+{
+    static const TokenizerRuleSet<Terminal> ruleSet(tokenDefinitions, tokenizerRules);
+    return ruleSet;
+}
+
 Lexer::Lexer(const std::filesystem::path& path, std::istream& stream)
-    : m_tokenizer(path, stream)
+    : m_tokenizer(GetRuleSet(), path, stream)
 {
-    TokenDefinitions<Terminal> allTokenDefinitions{ tokenDefinitions };
-    SetupTokenDefinitions(allTokenDefinitions);
-    TokenizerRules<Terminal> allTokenizerRules{ tokenizerRules };
-    SetTokenizerRules(allTokenizerRules);
 }
 
 parser::SourceLocation Lexer::GetCurrentLocation() const
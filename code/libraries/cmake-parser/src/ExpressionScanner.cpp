@@ -0,0 +1,129 @@
+#include "cmake-parser/ExpressionScanner.h"
+
+namespace cmake_parser {
+namespace expression {
+
+static bool IsNameStart(char ch)
+{
+    return ((ch >= 'a') && (ch <= 'z')) || ((ch >= 'A') && (ch <= 'Z')) || (ch == '_');
+}
+
+static bool IsDigit(char ch)
+{
+    return (ch >= '0') && (ch <= '9');
+}
+
+static bool IsNameCharacter(char ch)
+{
+    return IsNameStart(ch) || IsDigit(ch) || (ch == '-');
+}
+
+Scanner::Scanner(std::string_view text)
+    : m_text{ text }
+    , m_offset{}
+{
+}
+
+bool Scanner::Next(Terminal& type, std::string_view& value)
+{
+    if (IsAtEnd())
+        return false;
+    auto start = m_offset;
+    auto end = start + 1;
+    auto size = m_text.size();
+    char ch = m_text[start];
+    type = Terminal::None;
+    switch (ch)
+    {
+    case ' ':
+    case '\t':
+        while ((end < size) && ((m_text[end] == ' ') || (m_text[end] == '\t')))
+            ++end;
+        type = Terminal::Whitespace;
+        break;
+    case '\n':
+        type = Terminal::NewLine;
+        break;
+    case '\r':
+        if ((end < size) && (m_text[end] == '\n'))
+        {
+            ++end;
+            type = Terminal::NewLine;
+        }
+        break;
+    case '$':
+        type = Terminal::Dollar;
+        break;
+    case '/':
+        type = Terminal::ForwardSlash;
+        break;
+    case '=':
+        type = Terminal::Equals;
+        break;
+    case '.':
+        type = Terminal::Dot;
+        break;
+    case ';':
+        type = Terminal::SemiColon;
+        break;
+    case '{':
+        type = Terminal::CurlyBraceOpen;
+        break;
+    case '}':
+        type = Terminal::CurlyBraceClose;
+        break;
+    case '"':
+        end = ScanString(start);
+        if (end != 0)
+            type = Terminal::String;
+        break;
+    case '#':
+        while ((end < size) && (m_text[end] != '\n') && (m_text[end] != '\r'))
+            ++end;
+        type = Terminal::Comment;
+        break;
+    default:
+        if (IsNameStart(ch))
+        {
+            while ((end < size) && IsNameCharacter(m_text[end]))
+                ++end;
+            type = Terminal::Name;
+        }
+        else if (IsDigit(ch))
+        {
+            while ((end < size) && IsDigit(m_text[end]))
+                ++end;
+            type = Terminal::DigitSequence;
+        }
+        break;
+    }
+    if (type == Terminal::None)
+        end = size;
+    value = m_text.substr(start, end - start);
+    m_offset = end;
+    return true;
+}
+
+// Returns the offset after the closing quote of the string starting at offset, or 0 if the string is not terminated
+std::size_t Scanner::ScanString(std::size_t offset) const
+{
+    auto size = m_text.size();
+    ++offset;
+    while (offset < size)
+    {
+        char ch = m_text[offset++];
+        if (ch == '"')
+            return offset;
+        if (ch == '\\')
+        {
+            // An escape applies to any character but a line end
+            if ((offset >= size) || (m_text[offset] == '\n') || (m_text[offset] == '\r'))
+                return 0;
+            ++offset;
+        }
+    }
+    return 0;
+}
+
+} // namespace expression
+} // namespace cmake_parser
@@ -0,0 +1,100 @@
+#include "cmake-parser/IncrementalLexer.h"
+
+#include <algorithm>
+
+using namespace parser;
+
+namespace cmake_parser {
+
+IncrementalLexer::IncrementalLexer(const std::filesystem::path& path, std::string source)
+    : m_tokenizer(Lexer::GetRuleSet(), path, std::move(source))
+    , m_commands{}
+{
+    std::size_t index{};
+    CommandRange command{};
+    while (ReadCommand(index, command))
+    {
+        m_commands.push_back(command);
+    }
+}
+
+// Splitting the tokens into commands keeps no state between commands either. Commands that end before the first
+// changed token are kept. The commands are split again from there, until a command starts at a token after the changed
+// tokens where a command started before.
+CommandChange IncrementalLexer::Apply(const TextEdit& edit)
+{
+    auto tokenChange = m_tokenizer.Apply(edit);
+    auto tokenShift = static_cast<std::ptrdiff_t>(tokenChange.inserted) - static_cast<std::ptrdiff_t>(tokenChange.removed);
+    auto changeEnd = tokenChange.first + tokenChange.inserted;
+
+    // A command that ends at the first changed token may be continued by it
+    auto first = static_cast<std::size_t>(std::lower_bound(m_commands.begin(), m_commands.end(), tokenChange.first,
+        [](const CommandRange& command, std::size_t index) { return command.firstToken + command.numTokens < index; }) - m_commands.begin());
+    auto index = (first < m_commands.size()) ? std::min(m_commands[first].firstToken, tokenChange.first) : tokenChange.first;
+
+    auto next = first;
+    std::vector<CommandRange> commands;
+    bool inStep{};
+    CommandRange command{};
+    while (ReadCommand(index, command))
+    {
+        if (command.firstToken >= changeEnd)
+        {
+            auto previousFirstToken = static_cast<std::size_t>(static_cast<std::ptrdiff_t>(command.firstToken) - tokenShift);
+            while ((next < m_commands.size()) && (m_commands[next].firstToken < previousFirstToken))
+                ++next;
+            if ((next < m_commands.size()) && (m_commands[next].firstToken == previousFirstToken))
+            {
+                inStep = true;
+                break;
+            }
+        }
+        commands.push_back(command);
+    }
+    if (!inStep)
+        next = m_commands.size();
+
+    for (auto it = m_commands.begin() + static_cast<std::ptrdiff_t>(next); it != m_commands.end(); ++it)
+    {
+        it->firstToken = static_cast<std::size_t>(static_cast<std::ptrdiff_t>(it->firstToken) + tokenShift);
+    }
+    ReplaceRange(m_commands, first, next - first, commands);
+    return CommandChange{ first, next - first, commands.size() };
+}
+
+// Reads the command starting at or after token index, and moves the index to the token after it.
+// A command ends with the parenthesis that closes its arguments. Without arguments, or with unbalanced parentheses,
+// it ends at the end of the line or at a comment.
+bool IncrementalLexer::ReadCommand(std::size_t& index, CommandRange& command) const
+{
+    auto const& tokens = m_tokenizer.Tokens();
+    while ((index < tokens.Size()) &&
+           ((tokens.Type(index) == Terminal::Whitespace) || (tokens.Type(index) == Terminal::NewLine) || (tokens.Type(index) == Terminal::Comment)))
+        ++index;
+    if (index >= tokens.Size())
+        return false;
+
+    command.firstToken = index;
+    std::size_t depth{};
+    while (index < tokens.Size())
+    {
+        auto type = tokens.Type(index);
+        if ((depth == 0) && ((type == Terminal::NewLine) || (type == Terminal::Comment)))
+            break;
+        ++index;
+        if (type == Terminal::ParenthesisOpen)
+        {
+            ++depth;
+        }
+        else if (type == Terminal::ParenthesisClose)
+        {
+            if (depth <= 1)
+                break;
+            --depth;
+        }
+    }
+    command.numTokens = index - command.firstToken;
+    return true;
+}
+
+} // namespace cmake_parser
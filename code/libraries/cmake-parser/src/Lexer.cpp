@@ -1,6 +1,8 @@
 #include "cmake-parser/Lexer.h"
 
-#include "parser/TokenizerRule.h"
+#include "parser/ParallelTokenizer.h"
+#include "parser/StaticGrammar.h"
+#include "parser/TokenizerRuleSet.h"
 
 using namespace parser;
 
@@ -29,38 +31,72 @@ static TokenDefinitions<Terminal> tokenDefinitions {
     TOKEN_DEF(DigitSequence),
 };
 
-static TokenizerRules<Terminal> tokenizerRules{
-    { "[ \t]+", Whitespace },
-    { "(\r)?\n", NewLine },
-    { "\\$", Dollar },
-    { "\\/", ForwardSlash },
-    { "=", Equals },
-    { "\\.", Dot },
-    { "\\-", Minus },
-    { "\\+", Plus },
-    { "\\:", Plus },
-    { "\\(", ParenthesisOpen },
-    { "\\)", ParenthesisClose },
-    { "\\{", CurlyBraceOpen },
-    { "\\}", CurlyBraceClose },
-    { "\"(?:[^\"\\\\]|\\\\.)*\"", String },
-    //{ "[[:digit:]]\\.[[:digit:]](\\.[[:digit:]])?", VersionNumber },
-    { "[_a-zA-Z][_a-zA-Z0-9]*", Identifier },
-    { "[_a-zA-Z][_\\-a-zA-Z0-9]*", Name },
-    { "#.*", Comment },
-    //{ "[\\/\\-][a-zA-Z].*", CompilerOption },
-    //{ "0[xX][0-9a-fA-F]+", HexNumber },
-    //{ "[0-9]+", Number },
-    { "[0-9]+", DigitSequence },
+// The grammar, which is matched directly when lexing a buffer, and from which the rule set for lexing streams is built
+using StaticTerminal = parser::StaticTerminal<Terminal>;
+static constexpr CharacterClass WordStart{ CharacterClass::Range('a', 'z') | CharacterClass::Range('A', 'Z') | CharacterClass::Of("_") };
+static constexpr CharacterClass Digits{ CharacterClass::Range('0', '9') };
+static constexpr StaticTerminal staticTerminals[] = {
+    StaticTerminal::Repeat(CharacterClass::Of(" \t"), Whitespace),
+    StaticTerminal::Literal("\n", NewLine),
+    StaticTerminal::Literal("\r\n", NewLine),
+    StaticTerminal::Literal("$", Dollar),
+    StaticTerminal::Literal("/", ForwardSlash),
+    StaticTerminal::Literal("=", Equals),
+    StaticTerminal::Literal(".", Dot),
+    StaticTerminal::Literal("-", Minus),
+    StaticTerminal::Literal("+", Plus),
+    StaticTerminal::Literal(":", Plus),
+    StaticTerminal::Literal("(", ParenthesisOpen),
+    StaticTerminal::Literal(")", ParenthesisClose),
+    StaticTerminal::Literal("{", CurlyBraceOpen),
+    StaticTerminal::Literal("}", CurlyBraceClose),
+    StaticTerminal::Quoted('"', '\\', String),
+    StaticTerminal::Word(WordStart, WordStart | Digits, Identifier),
+    StaticTerminal::Word(WordStart, WordStart | Digits | CharacterClass::Of("-"), Name),
+    StaticTerminal::LineComment("#", Comment),
+    StaticTerminal::Repeat(Digits, DigitSequence),
 };
+static constexpr StaticGrammar staticGrammar(staticTerminals);
 
-Lexer::Lexer(const std::filesystem::path& path, std::istream& stream)
-    : m_tokenizer(path, stream)
+const TokenizerRuleSet<Terminal>& Lexer::GetRuleSet()
+{
+    static const TokenizerRuleSet<Terminal> ruleSet(tokenDefinitions, MakeTokenizerRules(staticGrammar));
+    return ruleSet;
+}
+
+std::uint64_t Lexer::GrammarId()
+{
+    static const std::uint64_t grammarId = parser::GrammarId("cmake_parser::Lexer", staticGrammar);
+    return grammarId;
+}
+
+parser::TokenStream<Terminal> Lexer::Tokenize(const std::filesystem::path& path, std::string_view source, std::pmr::memory_resource* resource)
+{
+    return parser::Tokenize(staticGrammar, path, source, resource);
+}
+
+parser::TokenStream<Terminal> Lexer::Tokenize(const std::filesystem::path& path, std::string_view source, const parser::TokenCache& cache,
+                                              std::pmr::memory_resource* resource)
+{
+    return cache.Tokenize<Terminal>(GrammarId(), path, source, [resource](const std::filesystem::path& unit, std::string_view text)
+    {
+        return Tokenize(unit, text, resource);
+    }, resource);
+}
+
+parser::TokenStream<Terminal> Lexer::TokenizeParallel(const std::filesystem::path& path, std::string_view source, std::size_t numThreads)
+{
+    return parser::TokenizeParallel(GetRuleSet(), path, source, numThreads);
+}
+
+Lexer::Lexer(const std::filesystem::path& path, std::istream& stream, std::pmr::memory_resource* resource)
+    : m_tokenizer(GetRuleSet(), path, stream, parser::TokenRing<Terminal>::DefaultCapacity, resource)
+{
+}
+
+Lexer::Lexer(parser::FileId fileId, std::string_view source)
+    : m_tokenizer(GetRuleSet(), fileId, source)
 {
-    TokenDefinitions<Terminal> allTokenDefinitions{ tokenDefinitions };
-    SetupTokenDefinitions(allTokenDefinitions);
-    TokenizerRules<Terminal> allTokenizerRules{ tokenizerRules };
-    SetTokenizerRules(allTokenizerRules);
 }
 
 parser::SourceLocation Lexer::GetCurrentLocation() const
@@ -73,14 +109,34 @@ parser::Token<Terminal> Lexer::GetToken()
     return m_tokenizer.GetToken();
 }
 
+parser::TokenView<Terminal> Lexer::GetTokenView()
+{
+    return m_tokenizer.GetTokenView();
+}
+
+parser::Token<Terminal> Lexer::MakeToken(const parser::TokenView<Terminal>& view) const
+{
+    return m_tokenizer.MakeToken(view);
+}
+
 void Lexer::UngetToken(const parser::Token<Terminal>& token)
 {
     m_tokenizer.UngetToken(token);
 }
 
+parser::TokenStream<Terminal> Lexer::Tokenize()
+{
+    return m_tokenizer.Tokenize();
+}
+
 bool Lexer::IsAtEnd() const
 {
     return m_tokenizer.IsAtEnd();
 }
 
+void Lexer::Seek(std::size_t offset)
+{
+    m_tokenizer.Seek(offset);
+}
+
 } // namespace cmake_parser
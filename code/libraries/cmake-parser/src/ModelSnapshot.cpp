@@ -0,0 +1,191 @@
+#include "cmake-parser/ModelSnapshot.h"
+
+#include <fstream>
+#include <iterator>
+#include "parser/ContentHash.h"
+
+using namespace cmake_parser;
+
+static bool ReadFile(const std::filesystem::path& path, std::string& text)
+{
+    std::ifstream stream(path, std::ios::binary);
+    if (!stream)
+        return false;
+    text.assign(std::istreambuf_iterator<char>(stream), std::istreambuf_iterator<char>());
+    return !stream.bad();
+}
+
+static bool GetModificationTime(const std::filesystem::path& path, std::int64_t& modificationTime)
+{
+    std::error_code error;
+    auto time = std::filesystem::last_write_time(path, error);
+    if (error)
+        return false;
+    modificationTime = static_cast<std::int64_t>(time.time_since_epoch().count());
+    return true;
+}
+
+bool SnapshotInput::Make(const std::filesystem::path& path, SnapshotInput& input)
+{
+    std::string text;
+    input.path = path;
+    if (!GetModificationTime(path, input.modificationTime) || !ReadFile(path, text))
+        return false;
+    input.size = text.size();
+    input.contentHash = parser::ContentHash(text);
+    return true;
+}
+
+bool SnapshotInput::IsUnchanged() const
+{
+    std::error_code error;
+    auto fileSize = std::filesystem::file_size(path, error);
+    std::int64_t fileModificationTime{};
+    if (error || (fileSize != size) || !GetModificationTime(path, fileModificationTime))
+        return false;
+    if (fileModificationTime == modificationTime)
+        return true;
+    // Written again, possibly with the same contents
+    std::string text;
+    return ReadFile(path, text) && (text.size() == size) && (parser::ContentHash(text) == contentHash);
+}
+
+SnapshotWriter::SnapshotWriter(std::ostream& stream)
+    : m_stream{ stream }
+{
+}
+
+void SnapshotWriter::WriteUInt32(std::uint32_t value)
+{
+    m_stream.write(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+void SnapshotWriter::WriteUInt64(std::uint64_t value)
+{
+    m_stream.write(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+void SnapshotWriter::WriteString(const std::string& value)
+{
+    WriteUInt64(value.size());
+    m_stream.write(value.data(), static_cast<std::streamsize>(value.size()));
+}
+
+SnapshotReader::SnapshotReader(std::istream& stream, std::uint64_t size)
+    : m_stream{ stream }
+    , m_remaining{ size }
+{
+}
+
+bool SnapshotReader::ReadUInt32(std::uint32_t& value)
+{
+    return ReadBytes(reinterpret_cast<char*>(&value), sizeof(value));
+}
+
+bool SnapshotReader::ReadUInt64(std::uint64_t& value)
+{
+    return ReadBytes(reinterpret_cast<char*>(&value), sizeof(value));
+}
+
+bool SnapshotReader::ReadString(std::string& value)
+{
+    std::uint64_t size{};
+    if (!ReadUInt64(size) || (size > m_remaining))
+    {
+        m_stream.setstate(std::ios::failbit);
+        return false;
+    }
+    value.resize(static_cast<std::size_t>(size));
+    return ReadBytes(value.data(), size);
+}
+
+bool SnapshotReader::ReadCount(std::size_t itemSize, std::size_t& count)
+{
+    std::uint64_t value{};
+    if (!ReadUInt64(value) || ((itemSize != 0) && (value > m_remaining / itemSize)))
+    {
+        m_stream.setstate(std::ios::failbit);
+        return false;
+    }
+    count = static_cast<std::size_t>(value);
+    return true;
+}
+
+bool SnapshotReader::ReadBytes(char* data, std::uint64_t size)
+{
+    if (!m_stream || (size > m_remaining))
+    {
+        m_stream.setstate(std::ios::failbit);
+        return false;
+    }
+    m_remaining -= size;
+    return static_cast<bool>(m_stream.read(data, static_cast<std::streamsize>(size)));
+}
+
+SnapshotManifest::SnapshotManifest()
+    : m_configurationHash{}
+    , m_inputs{}
+{
+}
+
+SnapshotManifest::SnapshotManifest(std::uint64_t configurationHash)
+    : m_configurationHash{ configurationHash }
+    , m_inputs{}
+{
+}
+
+bool SnapshotManifest::AddInput(const std::filesystem::path& path)
+{
+    SnapshotInput input{};
+    if (!SnapshotInput::Make(path, input))
+        return false;
+    m_inputs.push_back(input);
+    return true;
+}
+
+bool SnapshotManifest::IsClean(std::uint64_t configurationHash) const
+{
+    if (configurationHash != m_configurationHash)
+        return false;
+    for (auto const& input : m_inputs)
+    {
+        if (!input.IsUnchanged())
+            return false;
+    }
+    return true;
+}
+
+void SnapshotManifest::Write(SnapshotWriter& writer) const
+{
+    writer.WriteUInt64(m_configurationHash);
+    writer.WriteUInt64(m_inputs.size());
+    for (auto const& input : m_inputs)
+    {
+        writer.WriteString(input.path.generic_string());
+        writer.WriteUInt64(input.size);
+        writer.WriteUInt64(static_cast<std::uint64_t>(input.modificationTime));
+        writer.WriteUInt64(input.contentHash);
+    }
+}
+
+bool SnapshotManifest::Read(SnapshotReader& reader)
+{
+    // Each input holds at least a path length, a size, a modification time and a hash
+    const std::size_t MinInputSize = 4 * sizeof(std::uint64_t);
+    std::size_t count{};
+    m_inputs.clear();
+    if (!reader.ReadUInt64(m_configurationHash) || !reader.ReadCount(MinInputSize, count))
+        return false;
+    for (std::size_t index = 0; index < count; ++index)
+    {
+        SnapshotInput input{};
+        std::string path;
+        std::uint64_t modificationTime{};
+        if (!reader.ReadString(path) || !reader.ReadUInt64(input.size) || !reader.ReadUInt64(modificationTime) || !reader.ReadUInt64(input.contentHash))
+            return false;
+        input.path = path;
+        input.modificationTime = static_cast<std::int64_t>(modificationTime);
+        m_inputs.push_back(input);
+    }
+    return true;
+}
@@ -1,10 +1,13 @@
 #include "cmake-parser/ScriptParser.h"
 
 #include <fstream>
+#include <memory>
+#include <optional>
 #include "serialization/EnumSerialization.h"
 #include "utility/CommandLine.h"
 #include "utility/StringFunctions.h"
 #include "tracing/Tracing.h"
+#include "parser/KeywordTable.h"
 #include "cmake-parser/Expression.h"
 #include "cmake-parser/List.h"
 #include "cmake-parser/ParserExceptions.h"
@@ -52,46 +55,58 @@ enum class Keyword {
     Unset,
 };
 
+// Commands are recognized with a perfect hash table, their names are also used for serialization
+static constexpr auto Keywords = MakeKeywordTable<Keyword>({
+    { "add_executable", Keyword::AddExecutable },
+    { "add_library", Keyword::AddLibrary },
+    { "add_subdirectory", Keyword::AddSubDirectory },
+    { "cmake_minimum_required", Keyword::CMakeMinimumRequired },
+    { "else", Keyword::Else },
+    { "endforeach", Keyword::EndForEach },
+    { "endfunction", Keyword::EndFunction },
+    { "endif", Keyword::EndIf },
+    { "endmacro", Keyword::EndMacro },
+    { "find_package", Keyword::FindPackage },
+    { "force", Keyword::Force },
+    { "foreach", Keyword::ForEach },
+    { "function", Keyword::Function },
+    { "get_cmake_property", Keyword::GetCMakeProperty },
+    { "get_target_properties", Keyword::GetTargetProperties },
+    { "if", Keyword::If },
+    { "include", Keyword::Include },
+    { "link_directories", Keyword::LinkDirectories },
+    { "list", Keyword::List },
+    { "macro", Keyword::Macro },
+    { "message", Keyword::Message },
+    { "option", Keyword::Option },
+    { "project", Keyword::Project },
+    { "set", Keyword::Set },
+    { "set_property", Keyword::SetProperty },
+    { "set_target_properties", Keyword::SetTargetProperties },
+    { "string", Keyword::String },
+    { "target_compile_definitions", Keyword::TargetCompileDefinitions },
+    { "target_compile_options", Keyword::TargetCompileOptions },
+    { "target_include_directories", Keyword::TargetIncludeDirectories },
+    { "target_link_libraries", Keyword::TargetLinkLibraries },
+    { "unset", Keyword::Unset },
+});
+
 } // cmake_parser
 
 namespace serialization {
 
 template<>
-const BidirectionalMap<cmake_parser::Keyword, std::string> EnumSerializationMap<cmake_parser::Keyword>::ConversionMap =
+const BidirectionalMap<cmake_parser::Keyword, std::string> EnumSerializationMap<cmake_parser::Keyword>::ConversionMap = []()
 {
-    { cmake_parser::Keyword::AddExecutable, "add_executable" },
-    { cmake_parser::Keyword::AddLibrary, "add_library" },
-    { cmake_parser::Keyword::AddSubDirectory, "add_subdirectory" },
-    { cmake_parser::Keyword::CMakeMinimumRequired, "cmake_minimum_required" },
-    { cmake_parser::Keyword::Else, "else" },
-    { cmake_parser::Keyword::EndForEach, "endforeach" },
-    { cmake_parser::Keyword::EndFunction, "endfunction" },
-    { cmake_parser::Keyword::EndIf, "endif" },
-    { cmake_parser::Keyword::EndMacro, "endmacro" },
-    { cmake_parser::Keyword::FindPackage, "find_package" },
-    { cmake_parser::Keyword::Force, "force" },
-    { cmake_parser::Keyword::ForEach, "foreach" },
-    { cmake_parser::Keyword::Function, "function" },
-    { cmake_parser::Keyword::GetCMakeProperty, "get_cmake_property" },
-    { cmake_parser::Keyword::GetTargetProperties, "get_target_properties" },
-    { cmake_parser::Keyword::If, "if" },
-    { cmake_parser::Keyword::Include, "include" },
-    { cmake_parser::Keyword::LinkDirectories, "link_directories" },
-    { cmake_parser::Keyword::List, "list" },
-    { cmake_parser::Keyword::Macro, "macro" },
-    { cmake_parser::Keyword::Message, "message" },
-    { cmake_parser::Keyword::Option, "option" },
-    { cmake_parser::Keyword::Project, "project" },
-    { cmake_parser::Keyword::Set, "set" },
-    { cmake_parser::Keyword::SetProperty, "set_property" },
-    { cmake_parser::Keyword::SetTargetProperties, "set_target_properties" },
-    { cmake_parser::Keyword::String, "string" },
-    { cmake_parser::Keyword::TargetCompileDefinitions, "target_compile_definitions" },
-    { cmake_parser::Keyword::TargetCompileOptions, "target_compile_options" },
-    { cmake_parser::Keyword::TargetIncludeDirectories, "target_include_directories" },
-    { cmake_parser::Keyword::TargetLinkLibraries, "target_link_libraries" },
-    { cmake_parser::Keyword::Unset, "unset" },
-};
+    std::vector<std::pair<cmake_parser::Keyword, std::string>> values;
+    for (auto const& keyword : cmake_parser::Keywords)
+    {
+        values.emplace_back(keyword.value, std::string(keyword.text));
+    }
+    BidirectionalMap<cmake_parser::Keyword, std::string> map;
+    map.Init(values);
+    return map;
+}();
 
 } // namespace serialization
 
@@ -102,19 +117,6 @@ inline std::ostream& operator << (std::ostream& stream, Keyword keyword)
     return stream << serialization::Serialize(keyword);
 }
 
-static bool LookupKeyword(const Token<Terminal>& token, Keyword& keyword)
-{
-    for (auto const& item : serialization::EnumSerializationMap<Keyword>::GetValues())
-    {
-        if (utility::IsEqualIgnoreCase(item, token.Value()))
-        {
-            serialization::Deserialize(item, keyword);
-            return true;
-        }
-    }
-    return false;
-}
-
 static void PrintToken(const Token<Terminal>& token)
 {
     TRACE_DEBUG("Token: {}", token);
@@ -130,11 +132,48 @@ static void PrintTokenSkip(const Token<Terminal>& token)
     TRACE_DEBUG("Skip: {}", token);
 }
 
-ScriptParser::ScriptParser(CMakeModel& model, const std::filesystem::path& rootDirectory, std::istream& stream)
+ScriptParser::ScriptParser(CMakeModel& model, const std::filesystem::path& rootDirectory, std::istream& stream, ParseArena* arena,
+                           const TokenCache* tokenCache)
     : m_path{ rootDirectory / CMakeScriptFileName }
-    , m_lexer{ m_path, stream }
+    , m_arena{ arena }
+    , m_tokenCache{ tokenCache }
+    , m_script{}
+    , m_lexer{ m_path, stream, (arena != nullptr) ? arena->Resource() : std::pmr::get_default_resource() }
+    , m_pipelinedLexer{}
+    , m_streamLexer{}
+    , m_recoveryLexer{}
+    , m_prefetcher{}
+    , m_currentToken{}
+    , m_parenthesisDepth{}
+    , m_commandEnded{}
+    , m_errorCount{}
+    , m_parseMode{}
+    , m_errorMode{}
+    , m_diagnostics{}
+    , m_model{ model }
+    , m_mainProject{}
+    , m_currentProject{}
+    , m_currentTarget{}
+{
+}
+
+ScriptParser::ScriptParser(CMakeModel& model, const LexedScriptPtr& script, ScriptPrefetcher& prefetcher, ParseArena* arena)
+    : m_path{ script->directory / CMakeScriptFileName }
+    , m_arena{ arena }
+    , m_tokenCache{}
+    , m_script{ script }
+    , m_lexer{ script->tokens->GetFileId(), script->text }
+    , m_pipelinedLexer{}
+    , m_streamLexer{}
+    , m_recoveryLexer{}
+    , m_prefetcher{ &prefetcher }
     , m_currentToken{}
+    , m_parenthesisDepth{}
+    , m_commandEnded{}
     , m_errorCount{}
+    , m_parseMode{}
+    , m_errorMode{}
+    , m_diagnostics{}
     , m_model{ model }
     , m_mainProject{}
     , m_currentProject{}
@@ -142,16 +181,82 @@ ScriptParser::ScriptParser(CMakeModel& model, const std::filesystem::path& rootD
 {
 }
 
-bool ScriptParser::Parse()
+bool ScriptParser::Parse(ParseMode mode, ErrorMode errorMode)
 {
     TRACE_INFO("Start parsing {}", m_path.generic_string());
-    ParserExecutor<Terminal> parserExecutor(*this, { Terminal::Whitespace, Terminal::NewLine });
+    m_parseMode = mode;
+    m_errorMode = errorMode;
+    ParserExecutor<Terminal> parserExecutor(*this, { Terminal::Whitespace, Terminal::NewLine }, errorMode);
 
-    auto result = parserExecutor.Parse(m_lexer) && (m_errorCount == 0);
+    bool result{};
+    if (mode == ParseMode::Pipelined)
+    {
+        // The handlers read tokens themselves, so the executor reads them through the parser from the same pipelined lexer
+        PipelinedTokenizer<Terminal, Lexer> pipelinedLexer(m_lexer);
+        m_pipelinedLexer = &pipelinedLexer;
+        try
+        {
+            result = parserExecutor.Parse(*this);
+        }
+        catch (...)
+        {
+            m_pipelinedLexer = nullptr;
+            throw;
+        }
+        m_pipelinedLexer = nullptr;
+    }
+    else if (mode == ParseMode::Parallel)
+    {
+        result = ParseParallel(parserExecutor);
+    }
+    else
+    {
+        result = parserExecutor.Parse(*this);
+    }
+    result = result && (m_errorCount == 0);
     TRACE_INFO("End parsing {}: result {}, errors {}", m_path.generic_string(), result, m_errorCount);
     return result;
 }
 
+bool ScriptParser::ParseParallel(ParserExecutor<Terminal>& parserExecutor)
+{
+    // The main script starts reading the scripts of subdirectories for the duration of the parse
+    std::unique_ptr<ScriptPrefetcher> prefetcher;
+    if (m_prefetcher == nullptr)
+    {
+        prefetcher = std::make_unique<ScriptPrefetcher>(0, m_tokenCache);
+        m_prefetcher = prefetcher.get();
+    }
+    std::optional<TokenStream<Terminal>> tokens;
+    if (m_script == nullptr)
+    {
+        auto resource = (m_arena != nullptr) ? m_arena->Resource() : std::pmr::get_default_resource();
+        if (m_tokenCache != nullptr)
+            tokens.emplace(Lexer::Tokenize(m_path, m_lexer.Source(), *m_tokenCache, resource));
+        else
+            tokens.emplace(Lexer::Tokenize(m_path, m_lexer.Source(), resource));
+        m_prefetcher->PrefetchSubdirectories(m_path.parent_path(), *tokens);
+    }
+    TokenStreamTokenizer<Terminal> streamLexer((m_script != nullptr) ? *m_script->tokens : *tokens);
+    m_streamLexer = &streamLexer;
+    bool result{};
+    try
+    {
+        result = parserExecutor.Parse(*this);
+    }
+    catch (...)
+    {
+        m_streamLexer = nullptr;
+        if (prefetcher != nullptr)
+            m_prefetcher = nullptr;
+        throw;
+    }
+    m_streamLexer = nullptr;
+    if (prefetcher != nullptr)
+        m_prefetcher = nullptr;
+    return result;
+}
+
 std::string ScriptParser::ParseVersion(const TerminalSet& endTerminals)
 {
     std::string version;
@@ -161,8 +266,7 @@ std::string ScriptParser::ParseVersion(const TerminalSet& endTerminals)
         NextToken();
         SkipWhitespace();
         auto expressionText = ExpectExpression(endTerminals);
-        expression::Expression expr(m_model, expressionText);
-        version = expr.Evaluate();
+        version = expression::Expression::Evaluate(m_model, expressionText);
     }
     catch (std::exception&)
     { 
@@ -235,7 +339,7 @@ std::string ScriptParser::ParseURL()
 
 void ScriptParser::NextToken()
 {
-    m_currentToken = m_lexer.GetToken();
+    m_currentToken = MakeToken(GetTokenView());
     PrintToken(CurrentToken());
 }
 
@@ -251,21 +355,27 @@ const parser::Token<Terminal>& ScriptParser::CurrentToken()
 
 bool ScriptParser::CurrentTokenInSet(const TerminalSet& terminals)
 {
-    return terminals.find(CurrentTokenType()) != terminals.end();
+    return terminals.Contains(CurrentTokenType());
 }
 
 void ScriptParser::UngetCurrentToken()
 {
-    m_lexer.UngetToken(CurrentToken());
+    UngetToken(CurrentToken());
     PrintUngetToken(CurrentToken());
 }
 
 void ScriptParser::SkipWhitespace()
 {
-    while ((CurrentTokenType() == Terminal::Whitespace) || (CurrentTokenType() == Terminal::NewLine))
+    if ((CurrentTokenType() != Terminal::Whitespace) && (CurrentTokenType() != Terminal::NewLine))
+        return;
+    // Skipped tokens are only inspected for their type, so they are not converted to owning tokens
+    auto tokenView = GetTokenView();
+    while ((tokenView.Type() == Terminal::Whitespace) || (tokenView.Type() == Terminal::NewLine))
     {
-        NextToken();
+        tokenView = GetTokenView();
     }
+    m_currentToken = MakeToken(tokenView);
+    PrintToken(CurrentToken());
 }
 
 std::string ScriptParser::Expect(Terminal type)
@@ -286,9 +396,9 @@ std::string ScriptParser::Expect_SkipWhitespace(Terminal type)
     return Expect(type);
 }
 
-Token<Terminal> ScriptParser::Expect(std::set<Terminal> oneOfTypes)
+Token<Terminal> ScriptParser::Expect(const TerminalSet& oneOfTypes)
 {
-    if (oneOfTypes.find(CurrentTokenType()) == oneOfTypes.end())
+    if (!oneOfTypes.Contains(CurrentTokenType()))
     {
         OnParseError(CurrentToken());
         throw UnexpectedToken(CurrentToken(), __FILE__, __LINE__);
@@ -298,7 +408,7 @@ Token<Terminal> ScriptParser::Expect(std::set<Terminal> oneOfTypes)
     return result;
 }
 
-Token<Terminal> ScriptParser::Expect_SkipWhitespace(std::set<Terminal> oneOfTypes)
+Token<Terminal> ScriptParser::Expect_SkipWhitespace(const TerminalSet& oneOfTypes)
 {
     SkipWhitespace();
     return Expect(oneOfTypes);
@@ -315,7 +425,7 @@ std::string ScriptParser::ExpectVariable()
     return result;
 }
 
-std::filesystem::path ScriptParser::ExpectPath(const std::set<Terminal>& finalizers)
+std::filesystem::path ScriptParser::ExpectPath(const TerminalSet& finalizers)
 {
     auto expression = ExpectExpression(finalizers);
     std::filesystem::path path = m_model.GetVariable(VarCurrentSourceDirectory);
@@ -327,11 +437,11 @@ std::filesystem::path ScriptParser::ExpectPath(const std::set<Terminal>& finaliz
     return path;
 }
 
-std::string ScriptParser::ExpectExpression(const std::set<Terminal>& finalizers)
+std::string ScriptParser::ExpectExpression(const TerminalSet& finalizers)
 {
     std::string value{};
 
-    while (finalizers.find(CurrentToken().Type().TypeCode()) == finalizers.end())
+    while (!finalizers.Contains(CurrentTokenType()))
     {
         value += ExpectExpressionPart();
     }
@@ -354,6 +464,12 @@ std::string ScriptParser::ExpectExpressionPart()
         break;
     }
 
+    // The expression is not terminated before an invalid token or the end of the script
+    if (CurrentToken().IsNull() || CurrentToken().IsInvalid())
+    {
+        OnParseError(CurrentToken());
+        throw UnexpectedToken(CurrentToken(), __FILE__, __LINE__);
+    }
     result = CurrentToken().Value();
     NextToken();
     return result;
@@ -361,8 +477,7 @@ std::string ScriptParser::ExpectExpressionPart()
 
 std::string ScriptParser::Evaluate(const std::string& expression) const
 {
-    expression::Expression expr(GetModel(), expression);
-    return expr.Evaluate();
+    return expression::Expression::Evaluate(GetModel(), expression);
 }
 
 bool ScriptParser::HandleCMakeMinimumRequired()
@@ -496,13 +611,23 @@ bool ScriptParser::IsValidMessageMode(const std::string& mode)
 
 // Variable attributes
 static const std::string EnvironmentPrefix{ "ENV" };
-static const std::string KeywordCache{ "CACHE" };
-static const std::string KeywordParentScope{ "PARENT_SCOPE" };
-static const std::string KeywordForce{ "FORCE" };
+
+enum class VariableKeyword {
+    None,
+    Cache,
+    Force,
+    ParentScope,
+};
+
+static constexpr auto VariableKeywords = MakeKeywordTable<VariableKeyword>({
+    { "CACHE", VariableKeyword::Cache },
+    { "FORCE", VariableKeyword::Force },
+    { "PARENT_SCOPE", VariableKeyword::ParentScope },
+});
 
 bool ScriptParser::HandleSet()
 {
-    std::set<Terminal> finalizers = { Terminal::Whitespace , Terminal::NewLine, Terminal::ParenthesisClose };
+    constexpr TerminalSet finalizers{ Terminal::Whitespace , Terminal::NewLine, Terminal::ParenthesisClose };
 
     Expect_SkipWhitespace(Terminal::ParenthesisOpen);
     SkipWhitespace();
@@ -535,7 +660,8 @@ bool ScriptParser::HandleSet()
             {
                 if (CurrentToken().Type() == Terminal::Identifier)
                 {
-                    if (IsEqualIgnoreCase(KeywordCache, CurrentToken().Value()))
+                    auto keyword = VariableKeywords.Find(CurrentToken().Value(), VariableKeyword::None);
+                    if (keyword == VariableKeyword::Cache)
                     {
                         Expect(Terminal::Identifier);
                         variableAttributes = variableAttributes | VariableAttribute::Cache;
@@ -544,7 +670,7 @@ bool ScriptParser::HandleSet()
                         SkipWhitespace();
                         if (CurrentToken().Type() != Terminal::ParenthesisClose)
                         {
-                            if (IsEqualIgnoreCase(KeywordForce, CurrentToken().Value()))
+                            if (VariableKeywords.Find(CurrentToken().Value(), VariableKeyword::None) == VariableKeyword::Force)
                             {
                                 Expect(Terminal::Identifier);
                                 variableAttributes = variableAttributes | VariableAttribute::Force;
@@ -554,7 +680,7 @@ bool ScriptParser::HandleSet()
                         }
                         break;
                     }
-                    else if (IsEqualIgnoreCase(KeywordParentScope, CurrentToken().Value()))
+                    else if (keyword == VariableKeyword::ParentScope)
                     {
                         variableAttributes = variableAttributes | VariableAttribute::ParentScope;
                         break;
@@ -600,13 +726,14 @@ bool ScriptParser::HandleUnset()
             SkipWhitespace();
             if (CurrentToken().Type() == Terminal::Identifier)
             {
-                if (IsEqualIgnoreCase(KeywordCache, CurrentToken().Value()))
+                auto keyword = VariableKeywords.Find(CurrentToken().Value(), VariableKeyword::None);
+                if (keyword == VariableKeyword::Cache)
                 {
                     Expect(Terminal::Identifier);
                     variableAttributes = variableAttributes | VariableAttribute::Cache;
                     SkipWhitespace();
                 }
-                else if (IsEqualIgnoreCase(KeywordParentScope, CurrentToken().Value()))
+                else if (keyword == VariableKeyword::ParentScope)
                 {
                     Expect(Terminal::Identifier);
                     variableAttributes = variableAttributes | VariableAttribute::ParentScope;
@@ -625,20 +752,39 @@ bool ScriptParser::HandleUnset()
 
 bool ScriptParser::HandleAddSubdirectory()
 {
-    std::set<Terminal> finalizers = { Terminal::Whitespace , Terminal::NewLine, Terminal::ParenthesisClose };
+    constexpr TerminalSet finalizers{ Terminal::Whitespace , Terminal::NewLine, Terminal::ParenthesisClose };
 
     Expect_SkipWhitespace(Terminal::ParenthesisOpen);
     auto path = ExpectPath(finalizers);
     Expect_SkipWhitespace(Terminal::ParenthesisClose);
     m_model.EnterDirectory(std::filesystem::relative(path, m_model.GetCurrentDirectory()->SourcePath()).generic_string());
 
-    std::ifstream stream(path / CMakeScriptFileName);
-    ScriptParser parser(m_model, path, stream);
-
-    auto result = parser.Parse();
+    bool result{};
+    Diagnostics diagnostics;
+    if (m_prefetcher != nullptr)
+    {
+        // The script was read and lexed ahead when the script adding it was lexed
+        ScriptParser parser(m_model, m_prefetcher->Get(path), *m_prefetcher, m_arena);
+        result = parser.Parse(ParseMode::Parallel, m_errorMode);
+        diagnostics = parser.GetDiagnostics();
+    }
+    else
+    {
+        std::ifstream stream(path / CMakeScriptFileName);
+        ScriptParser parser(m_model, path, stream, m_arena, m_tokenCache);
+        result = parser.Parse(m_parseMode, m_errorMode);
+        diagnostics = parser.GetDiagnostics();
+    }
 
     m_model.LeaveDirectory();
 
+    if (m_errorMode == ErrorMode::Recover)
+    {
+        // Errors in the subdirectory were recovered from, and are reported as errors of this script
+        m_diagnostics.insert(m_diagnostics.end(), diagnostics.begin(), diagnostics.end());
+        m_errorCount += static_cast<int>(diagnostics.size());
+        return true;
+    }
     return result;
 }
 
@@ -656,12 +802,11 @@ static const std::string KeywordInterface{ "INTERFACE" };
 
 bool ScriptParser::HandleAddExecutable()
 {
-    std::set<Terminal> finalizers = { Terminal::Whitespace , Terminal::NewLine, Terminal::ParenthesisClose };
+    constexpr TerminalSet finalizers{ Terminal::Whitespace , Terminal::NewLine, Terminal::ParenthesisClose };
 
     Expect_SkipWhitespace(Terminal::ParenthesisOpen);
     auto expressionText = ExpectExpression(finalizers);
-    expression::Expression expressionTargetName(m_model, expressionText);
-    auto targetName = expressionTargetName.Evaluate();
+    auto targetName = expression::Expression::Evaluate(m_model, expressionText);
     TargetAttribute targetAttributes{};
     std::string targetAlias;
     SkipWhitespace();
@@ -717,8 +862,7 @@ bool ScriptParser::HandleAddExecutable()
     while (CurrentToken().Type() != Terminal::ParenthesisClose)
     {
         expressionText = ExpectExpression(finalizers);
-        expression::Expression expressionTargetSources(m_model, expressionText);
-        auto sources = expressionTargetSources.Evaluate();
+        auto sources = expression::Expression::Evaluate(m_model, expressionText);
         targetSources.Append(sources);
         SkipWhitespace();
     }
@@ -736,12 +880,11 @@ bool ScriptParser::HandleAddExecutable()
 
 bool ScriptParser::HandleAddLibrary()
 {
-    std::set<Terminal> finalizers = { Terminal::Whitespace , Terminal::NewLine, Terminal::ParenthesisClose };
+    constexpr TerminalSet finalizers{ Terminal::Whitespace , Terminal::NewLine, Terminal::ParenthesisClose };
 
     Expect_SkipWhitespace(Terminal::ParenthesisOpen);
     auto expressionText = ExpectExpression(finalizers);
-    expression::Expression expressionTargetName(m_model, expressionText);
-    auto targetName = expressionTargetName.Evaluate();
+    auto targetName = expression::Expression::Evaluate(m_model, expressionText);
     TargetType type{};
     TargetAttribute targetAttributes{};
     std::string targetAlias;
@@ -821,8 +964,7 @@ bool ScriptParser::HandleAddLibrary()
     while (CurrentToken().Type() != Terminal::ParenthesisClose)
     {
         expressionText = ExpectExpression(finalizers);
-        expression::Expression expressionTargetSources(m_model, expressionText);
-        auto sources = expressionTargetSources.Evaluate();
+        auto sources = expression::Expression::Evaluate(m_model, expressionText);
         targetSources.Append(sources);
         SkipWhitespace();
     }
@@ -854,12 +996,23 @@ bool ScriptParser::HandleAddLibrary()
 static const std::string KeywordSystem{ "SYSTEM" };
 static const std::string KeywordAfter{ "AFTER" };
 static const std::string KeywordBefore{ "BEFORE" };
-static const std::string KeywordPrivate{ "PRIVATE" };
-static const std::string KeywordPublic{ "PUBLIC" };
+
+enum class Scope {
+    None,
+    Private,
+    Public,
+    Interface,
+};
+
+static constexpr auto ScopeKeywords = MakeKeywordTable<Scope>({
+    { "PRIVATE", Scope::Private },
+    { "PUBLIC", Scope::Public },
+    { "INTERFACE", Scope::Interface },
+});
 
 bool ScriptParser::HandleTargetIncludeDirectories()
 {
-    std::set<Terminal> finalizers = { Terminal::Whitespace , Terminal::NewLine, Terminal::ParenthesisClose };
+    constexpr TerminalSet finalizers{ Terminal::Whitespace , Terminal::NewLine, Terminal::ParenthesisClose };
 
     if (m_currentTarget == nullptr)
     {
@@ -869,8 +1022,7 @@ bool ScriptParser::HandleTargetIncludeDirectories()
 
     Expect_SkipWhitespace(Terminal::ParenthesisOpen);
     auto expressionText = ExpectExpression(finalizers);
-    expression::Expression expressionTargetName(m_model, expressionText);
-    auto targetName = expressionTargetName.Evaluate();
+    auto targetName = expression::Expression::Evaluate(m_model, expressionText);
     SkipWhitespace();
     bool systemFound{};
     if (CurrentToken().Type() == Terminal::Identifier)
@@ -902,9 +1054,9 @@ bool ScriptParser::HandleTargetIncludeDirectories()
 
     while (CurrentToken().Type() == Terminal::Identifier)
     {
-        std::string scope = CurrentToken().Value();
+        auto scope = ScopeKeywords.Find(CurrentToken().Value(), Scope::None);
 
-        if (IsEqualIgnoreCase(KeywordPrivate, scope))
+        if (scope == Scope::Private)
         {
             Expect(Terminal::Identifier);
             SkipWhitespace();
@@ -913,7 +1065,7 @@ bool ScriptParser::HandleTargetIncludeDirectories()
             value.Append(arguments);
             m_currentTarget->SetProperty(TargetPropertyIncludeDirectories, value.ToString());
         }
-        else if (IsEqualIgnoreCase(KeywordPublic, scope))
+        else if (scope == Scope::Public)
         {
             Expect(Terminal::Identifier);
             SkipWhitespace();
@@ -925,7 +1077,7 @@ bool ScriptParser::HandleTargetIncludeDirectories()
             value2.Append(arguments);
             m_currentTarget->SetProperty(TargetPropertyInterfaceIncludeDirectories, value2.ToString());
         }
-        else if (IsEqualIgnoreCase(KeywordInterface, scope))
+        else if (scope == Scope::Interface)
         {
             Expect(Terminal::Identifier);
             SkipWhitespace();
@@ -945,7 +1097,7 @@ bool ScriptParser::HandleTargetIncludeDirectories()
 
 bool ScriptParser::HandleTargetCompileDefinitions()
 {
-    std::set<Terminal> finalizers = { Terminal::Whitespace , Terminal::NewLine, Terminal::ParenthesisClose };
+    constexpr TerminalSet finalizers{ Terminal::Whitespace , Terminal::NewLine, Terminal::ParenthesisClose };
 
     if (m_currentTarget == nullptr)
     {
@@ -955,15 +1107,14 @@ bool ScriptParser::HandleTargetCompileDefinitions()
 
     Expect_SkipWhitespace(Terminal::ParenthesisOpen);
     auto expressionText = ExpectExpression(finalizers);
-    expression::Expression expressionTargetName(m_model, expressionText);
-    auto targetName = expressionTargetName.Evaluate();
+    auto targetName = expression::Expression::Evaluate(m_model, expressionText);
     SkipWhitespace();
 
     while (CurrentToken().Type() == Terminal::Identifier)
     {
-        std::string scope = CurrentToken().Value();
+        auto scope = ScopeKeywords.Find(CurrentToken().Value(), Scope::None);
 
-        if (IsEqualIgnoreCase(KeywordPrivate, scope))
+        if (scope == Scope::Private)
         {
             Expect(Terminal::Identifier);
             SkipWhitespace();
@@ -972,7 +1123,7 @@ bool ScriptParser::HandleTargetCompileDefinitions()
             value.Append(arguments);
             m_currentTarget->SetProperty(TargetPropertyCompileDefinitions, value.ToString());
         }
-        else if (IsEqualIgnoreCase(KeywordPublic, scope))
+        else if (scope == Scope::Public)
         {
             Expect(Terminal::Identifier);
             SkipWhitespace();
@@ -984,7 +1135,7 @@ bool ScriptParser::HandleTargetCompileDefinitions()
             value2.Append(arguments);
             m_currentTarget->SetProperty(TargetPropertyInterfaceCompileDefinitions, value2.ToString());
         }
-        else if (IsEqualIgnoreCase(KeywordInterface, scope))
+        else if (scope == Scope::Interface)
         {
             Expect(Terminal::Identifier);
             SkipWhitespace();
@@ -1004,7 +1155,7 @@ bool ScriptParser::HandleTargetCompileDefinitions()
 
 bool ScriptParser::HandleTargetCompileOptions()
 {
-    std::set<Terminal> finalizers = { Terminal::Whitespace , Terminal::NewLine, Terminal::ParenthesisClose };
+    constexpr TerminalSet finalizers{ Terminal::Whitespace , Terminal::NewLine, Terminal::ParenthesisClose };
 
     if (m_currentTarget == nullptr)
     {
@@ -1014,15 +1165,14 @@ bool ScriptParser::HandleTargetCompileOptions()
 
     Expect_SkipWhitespace(Terminal::ParenthesisOpen);
     auto expressionText = ExpectExpression(finalizers);
-    expression::Expression expressionTargetName(m_model, expressionText);
-    auto targetName = expressionTargetName.Evaluate();
+    auto targetName = expression::Expression::Evaluate(m_model, expressionText);
     SkipWhitespace();
 
     while (CurrentToken().Type() == Terminal::Identifier)
     {
-        std::string scope = CurrentToken().Value();
+        auto scope = ScopeKeywords.Find(CurrentToken().Value(), Scope::None);
 
-        if (IsEqualIgnoreCase(KeywordPrivate, scope))
+        if (scope == Scope::Private)
         {
             Expect(Terminal::Identifier);
             SkipWhitespace();
@@ -1031,7 +1181,7 @@ bool ScriptParser::HandleTargetCompileOptions()
             value.Append(arguments);
             m_currentTarget->SetProperty(TargetPropertyCompileOptions, value.ToString());
         }
-        else if (IsEqualIgnoreCase(KeywordPublic, scope))
+        else if (scope == Scope::Public)
         {
             Expect(Terminal::Identifier);
             SkipWhitespace();
@@ -1043,7 +1193,7 @@ bool ScriptParser::HandleTargetCompileOptions()
             value2.Append(arguments);
             m_currentTarget->SetProperty(TargetPropertyInterfaceCompileOptions, value2.ToString());
         }
-        else if (IsEqualIgnoreCase(KeywordInterface, scope))
+        else if (scope == Scope::Interface)
         {
             Expect(Terminal::Identifier);
             SkipWhitespace();
@@ -1069,6 +1219,8 @@ bool ScriptParser::HandleUnsupported()
         SkipWhitespace();
         if (CurrentToken().Type() == Terminal::ParenthesisOpen)
             HandleUnsupported();
+        else if (CurrentToken().IsNull())
+            Expect(Terminal::ParenthesisClose);
         else if (CurrentToken().Type() != Terminal::ParenthesisClose)
             NextToken();
     } while (CurrentToken().Type() != Terminal::ParenthesisClose);
@@ -1079,10 +1231,30 @@ bool ScriptParser::HandleUnsupported()
 bool ScriptParser::OnToken(const parser::Token<Terminal>& token, bool& done)
 {
     PrintToken(token);
+    done = false;
+    if (m_errorMode != ErrorMode::Recover)
+        return HandleCommand(token);
+
+    try
+    {
+        if (HandleCommand(token))
+            return true;
+        AddDiagnostic(token.BeginLocation(), "Invalid arguments for " + token.Value());
+    }
+    catch (std::exception& e)
+    {
+        // An error at the end of the script has no current token
+        AddDiagnostic(CurrentToken().IsNull() ? GetCurrentLocation() : CurrentToken().BeginLocation(), e.what());
+    }
+    return false;
+}
+
+bool ScriptParser::HandleCommand(const parser::Token<Terminal>& token)
+{
     NextToken();
-    Keyword keyword;
+    Keyword keyword{};
     bool result{};
-    if (!LookupKeyword(token, keyword))
+    if (!Keywords.Lookup(token.Value(), keyword))
     {
         if (token.Type() == Terminal::Comment)
             return true;
@@ -1151,7 +1323,6 @@ bool ScriptParser::OnToken(const parser::Token<Terminal>& token, bool& done)
         break;
     }
 
-    done = false;
     return result;
 }
 
@@ -1170,6 +1341,34 @@ void ScriptParser::OnParseError(const parser::Token<Terminal>& token)
 {
     m_errorCount++;
     TRACE_ERROR("Parse error: unexpected token {}", token);
+    if ((m_errorMode == ErrorMode::Recover) && token.IsInvalid())
+    {
+        AddDiagnostic(token.BeginLocation(), "Invalid token: " + token.Value());
+    }
+}
+
+// Skips to the end of the command in which the error was found, which is the first line end outside the parentheses
+// of the command. The parentheses are counted from the first token of the command on, so the line ends inside them,
+// and a command without parentheses ends at the end of its line.
+bool ScriptParser::OnRecover(parser::ITokenizer<Terminal>& tokenizer)
+{
+    if (m_commandEnded)
+    {
+        // The line end was read while handling the command, so the current token was read after it and starts the
+        // next command
+        if (!CurrentToken().IsNull() && (CurrentTokenType() != Terminal::NewLine))
+            UngetCurrentToken();
+    }
+    else
+    {
+        do
+        {
+            NextToken();
+        } while (!CurrentToken().IsNull() && !m_commandEnded);
+    }
+    m_currentToken = {};
+    TRACE_INFO("Continue parsing after error at {}", tokenizer.GetCurrentLocation());
+    return true;
 }
 
 std::string ScriptParser::Serialize() const
@@ -1177,19 +1376,27 @@ std::string ScriptParser::Serialize() const
     return m_model.Serialize(SerializationFormat::JSON, 0);
 }
 
+// Only the first error found at a location is reported, as an error is often reported again while handling it
+void ScriptParser::AddDiagnostic(const parser::SourceLocation& location, const std::string& message)
+{
+    if (!m_diagnostics.empty() && (m_diagnostics.back().location == location))
+        return;
+    TRACE_ERROR("{}: {}", location, message);
+    m_diagnostics.push_back(Diagnostic{ location, message });
+}
+
 std::string ScriptParser::ReadScopedArguments()
 {
-    std::set<Terminal> finalizers = { Terminal::ParenthesisClose, Terminal::Identifier };
+    constexpr TerminalSet finalizers{ Terminal::ParenthesisClose, Terminal::Identifier };
     List arguments{};
     bool haveNormalIdentifier{};
     do
     {
         auto expr = ExpectExpression(finalizers);
-        expression::Expression expressionDirs(m_model, expr);
-        arguments.Append(expressionDirs.Evaluate());
+        arguments.Append(expression::Expression::Evaluate(m_model, expr));
         SkipWhitespace();
         haveNormalIdentifier = ((CurrentToken().Type() == Terminal::Identifier) &&
-            (!IsEqualIgnoreCase(KeywordPrivate, CurrentToken().Value()) && !IsEqualIgnoreCase(KeywordPublic, CurrentToken().Value()) && !IsEqualIgnoreCase(KeywordInterface, CurrentToken().Value())));
+            (ScopeKeywords.Find(CurrentToken().Value(), Scope::None) == Scope::None));
         if (haveNormalIdentifier)
         {
             arguments.Append(Expect(Terminal::Identifier));
@@ -1198,4 +1405,102 @@ std::string ScriptParser::ReadScopedArguments()
     return arguments.ToString();
 }
 
+parser::TokenView<Terminal> ScriptParser::GetTokenView()
+{
+    parser::TokenView<Terminal> view;
+    if (m_recoveryLexer != nullptr)
+        view = m_recoveryLexer->GetTokenView();
+    else if (m_streamLexer != nullptr)
+        view = m_streamLexer->GetTokenView();
+    else
+        view = (m_pipelinedLexer != nullptr) ? m_pipelinedLexer->GetTokenView() : m_lexer.GetTokenView();
+    if ((m_errorMode == ErrorMode::Recover) && view.IsInvalid() && !view.IsRestored())
+        view = LimitToLine(view);
+    if (view.Type() == Terminal::ParenthesisOpen)
+        ++m_parenthesisDepth;
+    else if (view.Type() == Terminal::ParenthesisClose)
+        --m_parenthesisDepth;
+    else if ((view.Type() == Terminal::NewLine) && (m_parenthesisDepth <= 0))
+        m_commandEnded = true;
+    else if (view.IsInvalid())
+    {
+        // An invalid token can hold the parenthesis that closes the command
+        for (auto ch : view.Value())
+        {
+            if (ch == '(')
+                ++m_parenthesisDepth;
+            else if (ch == ')')
+                --m_parenthesisDepth;
+        }
+    }
+    return view;
+}
+
+// The lexers make all text from an invalid token on one invalid token. When recovering from errors, the invalid
+// token ends at the end of its line instead, and the text after it is lexed again from there with a lexer of its own.
+parser::TokenView<Terminal> ScriptParser::LimitToLine(const parser::TokenView<Terminal>& view)
+{
+    auto length = view.Value().find('\n');
+    if ((length == std::string_view::npos) || (length == 0))
+        return view;
+    if ((length > 1) && (view.Value()[length - 1] == '\r'))
+        --length;
+    auto fileId = MakeToken(view).BeginLocation().GetFileId();
+    m_recoveryLexer = std::make_unique<Lexer>(fileId, m_lexer.Source());
+    m_recoveryLexer->Seek(view.Offset() + length);
+    return parser::TokenView<Terminal>(view.Type(), view.Value().substr(0, length), view.Offset());
+}
+
+parser::Token<Terminal> ScriptParser::MakeToken(const parser::TokenView<Terminal>& view) const
+{
+    if (m_recoveryLexer != nullptr)
+        return m_recoveryLexer->MakeToken(view);
+    if (m_streamLexer != nullptr)
+        return m_streamLexer->MakeToken(view);
+    return (m_pipelinedLexer != nullptr) ? m_pipelinedLexer->MakeToken(view) : m_lexer.MakeToken(view);
+}
+
+void ScriptParser::UngetToken(const parser::Token<Terminal>& token)
+{
+    if (token.Type() == Terminal::ParenthesisOpen)
+        --m_parenthesisDepth;
+    else if (token.Type() == Terminal::ParenthesisClose)
+        ++m_parenthesisDepth;
+    if (m_recoveryLexer != nullptr)
+        m_recoveryLexer->UngetToken(token);
+    else if (m_streamLexer != nullptr)
+        m_streamLexer->UngetToken(token);
+    else if (m_pipelinedLexer != nullptr)
+        m_pipelinedLexer->UngetToken(token);
+    else
+        m_lexer.UngetToken(token);
+}
+
+// The parser executor reads the first token of a command, and the tokens between commands
+parser::Token<Terminal> ScriptParser::GetToken()
+{
+    m_parenthesisDepth = 0;
+    m_commandEnded = false;
+    m_currentToken = MakeToken(GetTokenView());
+    return m_currentToken;
+}
+
+parser::SourceLocation ScriptParser::GetCurrentLocation() const
+{
+    if (m_recoveryLexer != nullptr)
+        return m_recoveryLexer->GetCurrentLocation();
+    if (m_streamLexer != nullptr)
+        return m_streamLexer->GetCurrentLocation();
+    return (m_pipelinedLexer != nullptr) ? m_pipelinedLexer->GetCurrentLocation() : m_lexer.GetCurrentLocation();
+}
+
+bool ScriptParser::IsAtEnd() const
+{
+    if (m_recoveryLexer != nullptr)
+        return m_recoveryLexer->IsAtEnd();
+    if (m_streamLexer != nullptr)
+        return m_streamLexer->IsAtEnd();
+    return (m_pipelinedLexer != nullptr) ? m_pipelinedLexer->IsAtEnd() : m_lexer.IsAtEnd();
+}
+
 } // namespace cmake_parser
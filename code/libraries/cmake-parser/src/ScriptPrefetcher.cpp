@@ -0,0 +1,119 @@
+#include "cmake-parser/ScriptPrefetcher.h"
+
+#include <fstream>
+#include <iterator>
+#include "utility/StringFunctions.h"
+#include "cmake-parser/CMakeModel.h"
+
+namespace cmake_parser {
+
+static const std::string AddSubdirectoryCommand{ "add_subdirectory" };
+
+ScriptPrefetcher::ScriptPrefetcher(std::size_t numThreads, const parser::TokenCache* tokenCache)
+    : m_mutex{}
+    , m_scripts{}
+    , m_tokenCache{ tokenCache }
+    , m_pool(numThreads)
+{
+}
+
+void ScriptPrefetcher::Prefetch(const std::filesystem::path& directory)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_scripts.find(directory) != m_scripts.end())
+        return;
+    m_scripts.emplace(directory, m_pool.Async([this, directory]() { return LoadAndPrefetch(directory); }).share());
+}
+
+void ScriptPrefetcher::PrefetchSubdirectories(const std::filesystem::path& directory, const parser::TokenStream<Terminal>& tokens)
+{
+    auto skipWhitespace = [&tokens](std::size_t index)
+    {
+        while ((index < tokens.Size()) && ((tokens.Type(index) == Terminal::Whitespace) || (tokens.Type(index) == Terminal::NewLine)))
+            ++index;
+        return index;
+    };
+    for (std::size_t index = 0; index < tokens.Size(); ++index)
+    {
+        if ((tokens.Type(index) != Terminal::Identifier) || !utility::IsEqualIgnoreCase(AddSubdirectoryCommand, std::string(tokens.Value(index))))
+            continue;
+        index = skipWhitespace(index + 1);
+        if ((index >= tokens.Size()) || (tokens.Type(index) != Terminal::ParenthesisOpen))
+            continue;
+        index = skipWhitespace(index + 1);
+        // The path is the text up to the next separator, it can only be read ahead when it has no variable references
+        std::string path;
+        bool isLiteral{ true };
+        for (; index < tokens.Size(); ++index)
+        {
+            auto type = tokens.Type(index);
+            if ((type == Terminal::Whitespace) || (type == Terminal::NewLine) || (type == Terminal::ParenthesisClose))
+                break;
+            if ((type == Terminal::Dollar) || (type == Terminal::String) || (type == Terminal::Comment) || type.IsInvalid())
+                isLiteral = false;
+            path += tokens.Value(index);
+        }
+        if (!isLiteral || path.empty())
+            continue;
+        std::error_code error;
+        auto subdirectory = std::filesystem::canonical(directory / path, error);
+        if (!error)
+            Prefetch(subdirectory);
+    }
+}
+
+LexedScriptPtr ScriptPrefetcher::Get(const std::filesystem::path& directory)
+{
+    std::shared_future<LexedScriptPtr> script;
+    std::promise<LexedScriptPtr> promise;
+    bool prefetched{};
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto it = m_scripts.find(directory);
+        prefetched = (it != m_scripts.end());
+        if (prefetched)
+        {
+            script = it->second;
+        }
+        else
+        {
+            // Not prefetched, it is read now, and registered so that it is not read again
+            script = promise.get_future().share();
+            m_scripts.emplace(directory, script);
+        }
+    }
+    if (!prefetched)
+    {
+        try
+        {
+            promise.set_value(LoadAndPrefetch(directory));
+        }
+        catch (...)
+        {
+            promise.set_exception(std::current_exception());
+        }
+    }
+    return script.get();
+}
+
+LexedScriptPtr ScriptPrefetcher::Load(const std::filesystem::path& directory, const parser::TokenCache* tokenCache)
+{
+    auto script = std::make_shared<LexedScript>();
+    script->directory = directory;
+    std::ifstream stream(directory / CMakeScriptFileName);
+    script->text.assign(std::istreambuf_iterator<char>(stream), std::istreambuf_iterator<char>());
+    if (tokenCache != nullptr)
+        script->tokens.emplace(Lexer::Tokenize(directory / CMakeScriptFileName, script->text, *tokenCache));
+    else
+        script->tokens.emplace(Lexer::Tokenize(directory / CMakeScriptFileName, script->text));
+    return script;
+}
+
+LexedScriptPtr ScriptPrefetcher::LoadAndPrefetch(const std::filesystem::path& directory)
+{
+    auto script = Load(directory, m_tokenCache);
+    PrefetchSubdirectories(directory, *script->tokens);
+    return script;
+}
+
+} // namespace cmake_parser
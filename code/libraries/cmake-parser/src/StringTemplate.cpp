@@ -0,0 +1,115 @@
+#include "cmake-parser/StringTemplate.h"
+
+#include <unordered_map>
+#include "cmake-parser/CMakeModel.h"
+
+namespace cmake_parser {
+namespace expression {
+
+StringTemplate::StringTemplate(std::string_view text)
+    : m_ops{}
+    , m_maxDepth{}
+{
+    std::string literal;
+    std::size_t depth{};
+    std::size_t index{};
+    while (index < text.length())
+    {
+        char ch = text[index++];
+        if (ch == '$')
+        {
+            if ((index < text.length()) && (text[index] == '{'))
+            {
+                ++index;
+                AddLiteral(literal);
+                m_ops.push_back(Op{ OpCode::BeginReference, {}, {} });
+                ++depth;
+                if (depth > m_maxDepth)
+                    m_maxDepth = depth;
+            }
+            // A $ that does not start a reference is dropped
+        }
+        else if ((ch == '}') && (depth > 0))
+        {
+            AddLiteral(literal);
+            Op op{ OpCode::EndReference, {}, {} };
+            auto count = m_ops.size();
+            if ((count >= 2) && (m_ops[count - 2].code == OpCode::BeginReference) && (m_ops[count - 1].code == OpCode::Literal))
+                op.name = Symbol(m_ops[count - 1].text);
+            m_ops.push_back(std::move(op));
+            --depth;
+        }
+        else
+        {
+            literal += ch;
+        }
+    }
+    AddLiteral(literal);
+    for (; depth > 0; --depth)
+    {
+        m_ops.push_back(Op{ OpCode::EndUnterminatedReference, {}, {} });
+    }
+}
+
+std::shared_ptr<const StringTemplate> StringTemplate::Get(const std::string& text)
+{
+    thread_local std::unordered_map<std::string, std::shared_ptr<const StringTemplate>> cache;
+    auto it = cache.find(text);
+    if (it != cache.end())
+        return it->second;
+    if (cache.size() >= MaxCacheSize)
+        cache.clear();
+    auto result = std::make_shared<const StringTemplate>(text);
+    cache.emplace(text, result);
+    return result;
+}
+
+bool StringTemplate::Evaluate(const CMakeModel& model, std::string& result) const
+{
+    // The result is built at level 0, the name of each open reference one level up
+    std::vector<std::string> levels(m_maxDepth + 1);
+    std::size_t level{};
+    for (auto const& op : m_ops)
+    {
+        switch (op.code)
+        {
+        case OpCode::Literal:
+            levels[level] += op.text;
+            break;
+        case OpCode::BeginReference:
+            levels[++level].clear();
+            break;
+        case OpCode::EndReference:
+            {
+                auto const& name = levels[level--];
+                auto variable = op.name.IsEmpty() ? model.FindVariable(name) : model.FindVariable(op.name);
+                std::string cacheValue;
+                if (variable == nullptr)
+                    cacheValue = model.GetCacheVariable(name);
+                auto const& value = (variable != nullptr) ? variable->Value() : cacheValue;
+                if (value.find_first_of("${}") != std::string::npos)
+                    return false;
+                levels[level] += value;
+            }
+            break;
+        case OpCode::EndUnterminatedReference:
+            levels[level - 1] += "${";
+            levels[level - 1] += levels[level];
+            --level;
+            break;
+        }
+    }
+    result = std::move(levels[0]);
+    return true;
+}
+
+void StringTemplate::AddLiteral(std::string& literal)
+{
+    if (literal.empty())
+        return;
+    m_ops.push_back(Op{ OpCode::Literal, std::move(literal), {} });
+    literal.clear();
+}
+
+} // namespace expression
+} // namespace cmake_parser
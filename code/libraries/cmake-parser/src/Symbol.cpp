@@ -0,0 +1,96 @@
+#include "cmake-parser/Symbol.h"
+
+#include <deque>
+#include <limits>
+#include <mutex>
+#include <shared_mutex>
+#include <stdexcept>
+#include <unordered_map>
+
+using namespace cmake_parser;
+
+namespace {
+
+// Names are kept in a deque, which does not move them when it grows, so the index can refer to them
+class SymbolTable
+{
+private:
+    mutable std::shared_mutex m_mutex;
+    std::deque<std::string> m_names;
+    std::unordered_map<std::string_view, std::uint32_t> m_ids;
+
+public:
+    SymbolTable()
+        : m_mutex{}
+        , m_names{}
+        , m_ids{}
+    {
+        m_names.emplace_back();
+        m_ids.emplace(m_names.back(), 0);
+    }
+
+    bool Find(std::string_view name, std::uint32_t& id) const
+    {
+        std::shared_lock<std::shared_mutex> lock(m_mutex);
+        auto it = m_ids.find(name);
+        if (it == m_ids.end())
+            return false;
+        id = it->second;
+        return true;
+    }
+    std::uint32_t Intern(std::string_view name)
+    {
+        std::uint32_t id{};
+        if (Find(name, id))
+            return id;
+        std::unique_lock<std::shared_mutex> lock(m_mutex);
+        // Another thread can have added the name in the meantime
+        auto it = m_ids.find(name);
+        if (it != m_ids.end())
+            return it->second;
+        if (m_names.size() > std::numeric_limits<std::uint32_t>::max())
+            throw std::length_error("Symbol table is full");
+        id = static_cast<std::uint32_t>(m_names.size());
+        m_names.emplace_back(name);
+        m_ids.emplace(m_names.back(), id);
+        return id;
+    }
+    const std::string& Name(std::uint32_t id) const
+    {
+        std::shared_lock<std::shared_mutex> lock(m_mutex);
+        return m_names[id];
+    }
+    std::size_t Size() const
+    {
+        std::shared_lock<std::shared_mutex> lock(m_mutex);
+        return m_names.size();
+    }
+};
+
+SymbolTable& GetSymbolTable()
+{
+    static SymbolTable table;
+    return table;
+}
+
+} // namespace
+
+Symbol::Symbol(std::string_view name)
+    : m_id{ GetSymbolTable().Intern(name) }
+{
+}
+
+bool Symbol::Find(std::string_view name, Symbol& symbol)
+{
+    return GetSymbolTable().Find(name, symbol.m_id);
+}
+
+std::size_t Symbol::TableSize()
+{
+    return GetSymbolTable().Size();
+}
+
+const std::string& Symbol::Name() const
+{
+    return GetSymbolTable().Name(m_id);
+}
@@ -6,13 +6,17 @@ using namespace cmake_parser;
 
 TypedVariableList::TypedVariableList()
     : m_variables{}
+    , m_ordered{}
+    , m_orderedIsValid{}
 {
 }
 
 TypedVariableList::TypedVariableList(const TypedVariableList& other)
     : m_variables{}
+    , m_ordered{}
+    , m_orderedIsValid{}
 {
-    for (auto const& var : other.m_variables)
+    for (auto const& var : other.GetVariables())
     {
         if (var.second != nullptr)
         {
@@ -25,8 +29,10 @@ TypedVariableList& TypedVariableList::operator = (const TypedVariableList& other
 {
     if (this != &other)
     {
+        TypedVariables variables = other.GetVariables();
         m_variables.clear();
-        for (auto const& var : other.m_variables)
+        m_ordered.clear();
+        for (auto const& var : variables)
         {
             if (var.second != nullptr)
             {
@@ -37,6 +43,20 @@ TypedVariableList& TypedVariableList::operator = (const TypedVariableList& other
     return *this;
 }
 
+const TypedVariables& TypedVariableList::GetVariables() const
+{
+    if (!m_orderedIsValid)
+    {
+        m_ordered.clear();
+        for (auto const& var : m_variables)
+        {
+            m_ordered.insert(std::pair(var.first.Name(), var.second));
+        }
+        m_orderedIsValid = true;
+    }
+    return m_ordered;
+}
+
 std::string TypedVariableList::GetVariable(const std::string& name) const
 {
     auto var = FindVariable(name);
@@ -52,13 +72,21 @@ void TypedVariableList::SetVariable(const std::string& name, const std::string&
 
 void TypedVariableList::UnsetVariable(const std::string& name)
 {
-    if (FindVariable(name) != nullptr)
+    Symbol symbol;
+    if (Symbol::Find(name, symbol) && (m_variables.erase(symbol) != 0) && m_orderedIsValid)
     {
-        m_variables.erase(name);
+        m_ordered.erase(name);
     }
 }
 
 TypedVariablePtr TypedVariableList::FindVariable(const std::string& name) const
+{
+    // A name that was never interned cannot be the name of a variable
+    Symbol symbol;
+    return Symbol::Find(name, symbol) ? FindVariable(symbol) : nullptr;
+}
+
+TypedVariablePtr TypedVariableList::FindVariable(Symbol name) const
 {
     auto it = m_variables.find(name);
     return (it == m_variables.end()) ? nullptr : it->second;
@@ -66,7 +94,10 @@ TypedVariablePtr TypedVariableList::FindVariable(const std::string& name) const
 
 void TypedVariableList::AddVariable(const std::string& name, TypedVariablePtr variable)
 {
-    m_variables.insert(std::pair(name, variable));
+    if (m_variables.insert(std::pair(Symbol(name), variable)).second && m_orderedIsValid)
+    {
+        m_ordered.insert(std::pair(name, variable));
+    }
 }
 
 std::string TypedVariableList::Serialize(SerializationFormat format, unsigned indent) const
@@ -76,7 +107,7 @@ std::string TypedVariableList::Serialize(SerializationFormat format, unsigned in
     {
     case SerializationFormat::Text:
         stream << "TypedVariableList:" << std::endl;
-        for (auto const& var : m_variables)
+        for (auto const& var : GetVariables())
         {
             if (var.second != nullptr)
                 stream << var.second->Serialize() << std::endl;
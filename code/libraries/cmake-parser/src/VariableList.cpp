@@ -1,18 +1,25 @@
 #include "cmake-parser/VariableList.h"
 
 #include <sstream>
+#include <vector>
 
 using namespace cmake_parser;
 
 VariableList::VariableList()
     : m_variables{}
+    , m_frozen{}
+    , m_merged{}
+    , m_mergedIsValid{}
 {
 }
 
 VariableList::VariableList(const VariableList& other)
     : m_variables{}
+    , m_frozen{}
+    , m_merged{}
+    , m_mergedIsValid{}
 {
-    for (auto const& var : other.m_variables)
+    for (auto const& var : other.GetVariables())
     {
         if (var.second != nullptr)
         {
@@ -25,18 +32,50 @@ VariableList& VariableList::operator = (const VariableList& other)
 {
     if (this != &other)
     {
-        m_variables.clear();
-        for (auto const& var : other.m_variables)
+        VariableMap variables;
+        for (auto const& var : other.GetVariables())
         {
             if (var.second != nullptr)
             {
-                SetVariable(var.first, var.second->Value());
+                Symbol name(var.first);
+                variables.insert(std::pair(name, std::make_shared<Variable>(name, var.second->Value())));
             }
         }
+        m_variables = std::move(variables);
+        m_frozen = nullptr;
+        if (m_mergedIsValid)
+        {
+            m_mergedIsValid = false;
+            GetVariables();
+        }
     }
     return *this;
 }
 
+VariableList VariableList::CreateChildScope()
+{
+    Freeze();
+    VariableList result;
+    result.m_frozen = m_frozen;
+    return result;
+}
+
+const Variables& VariableList::GetVariables() const
+{
+    if (!m_mergedIsValid)
+    {
+        VariableMap variables;
+        Merge(variables);
+        m_merged.clear();
+        for (auto const& var : variables)
+        {
+            m_merged.insert(std::pair(var.first.Name(), var.second));
+        }
+        m_mergedIsValid = true;
+    }
+    return m_merged;
+}
+
 std::string VariableList::GetVariable(const std::string& name) const
 {
     auto var = FindVariable(name);
@@ -47,18 +86,49 @@ std::string VariableList::GetVariable(const std::string& name) const
 
 void VariableList::SetVariable(const std::string& name, const std::string& value)
 {
-    AddVariable(name, std::make_shared<Variable>(name, value));
+    Symbol symbol(name);
+    AddVariable(symbol, std::make_shared<Variable>(symbol, value));
 }
 
 void VariableList::UnsetVariable(const std::string& name)
+{
+    Symbol symbol;
+    if (Symbol::Find(name, symbol))
+        UnsetVariable(symbol);
+}
+
+void VariableList::UnsetVariable(Symbol name)
 {
     if (FindVariable(name) != nullptr)
     {
         m_variables.erase(name);
+        if (FindFrozenVariable(name) != nullptr)
+            m_variables.insert(std::pair(name, nullptr));
+        if (m_mergedIsValid)
+            m_merged.erase(name.Name());
     }
 }
 
 VariablePtr VariableList::FindVariable(const std::string& name) const
+{
+    // A name that was never interned cannot be the name of a variable
+    Symbol symbol;
+    return Symbol::Find(name, symbol) ? FindVariable(symbol) : nullptr;
+}
+
+VariablePtr VariableList::FindVariable(Symbol name) const
+{
+    auto it = m_variables.find(name);
+    return (it == m_variables.end()) ? FindFrozenVariable(name) : it->second;
+}
+
+VariablePtr VariableList::FindLocalVariable(const std::string& name) const
+{
+    Symbol symbol;
+    return Symbol::Find(name, symbol) ? FindLocalVariable(symbol) : nullptr;
+}
+
+VariablePtr VariableList::FindLocalVariable(Symbol name) const
 {
     auto it = m_variables.find(name);
     return (it == m_variables.end()) ? nullptr : it->second;
@@ -66,7 +136,79 @@ VariablePtr VariableList::FindVariable(const std::string& name) const
 
 void VariableList::AddVariable(const std::string& name, VariablePtr variable)
 {
-    m_variables.insert(std::pair(name, variable));
+    AddVariable(Symbol(name), variable);
+}
+
+void VariableList::AddVariable(Symbol name, VariablePtr variable)
+{
+    auto result = m_variables.insert(std::pair(name, variable));
+    // An unset variable of a frozen layer can be set again
+    if (!result.second && (result.first->second == nullptr))
+        result.first->second = variable;
+    else if (!result.second)
+        return;
+    if (m_mergedIsValid)
+    {
+        if (variable == nullptr)
+            m_merged.erase(name.Name());
+        else
+            m_merged[name.Name()] = variable;
+    }
+}
+
+VariablePtr VariableList::FindFrozenVariable(Symbol name) const
+{
+    for (auto layer = m_frozen.get(); layer != nullptr; layer = layer->parent.get())
+    {
+        auto it = layer->variables.find(name);
+        if (it != layer->variables.end())
+            return it->second;
+    }
+    return nullptr;
+}
+
+void VariableList::Freeze()
+{
+    if (m_variables.empty())
+        return;
+    auto depth = (m_frozen == nullptr) ? std::size_t{ 1 } : m_frozen->depth + 1;
+    if (depth > MaxLayerDepth)
+    {
+        VariableMap variables;
+        Merge(variables);
+        m_frozen = std::make_shared<const Layer>(Layer{ std::move(variables), nullptr, 1 });
+    }
+    else
+    {
+        m_frozen = std::make_shared<const Layer>(Layer{ std::move(m_variables), m_frozen, depth });
+    }
+    // The visible variables do not change
+    m_variables.clear();
+}
+
+// Adds all visible variables, the variables of newer layers replace those of older ones
+void VariableList::Merge(VariableMap& variables) const
+{
+    std::vector<const Layer*> layers;
+    for (auto layer = m_frozen.get(); layer != nullptr; layer = layer->parent.get())
+    {
+        layers.push_back(layer);
+    }
+    auto mergeLayer = [&variables](const VariableMap& layer)
+    {
+        for (auto const& var : layer)
+        {
+            if (var.second == nullptr)
+                variables.erase(var.first);
+            else
+                variables[var.first] = var.second;
+        }
+    };
+    for (auto it = layers.rbegin(); it != layers.rend(); ++it)
+    {
+        mergeLayer((*it)->variables);
+    }
+    mergeLayer(m_variables);
 }
 
 std::string VariableList::Serialize(SerializationFormat format, unsigned indent) const
@@ -76,7 +218,7 @@ std::string VariableList::Serialize(SerializationFormat format, unsigned indent)
     {
     case SerializationFormat::Text:
         stream << "VariableList:" << std::endl;
-        for (auto const& var : m_variables)
+        for (auto const& var : GetVariables())
         {
             if (var.second != nullptr)
                 stream << std::string(indent, ' ') << var.second->Serialize() << std::endl;
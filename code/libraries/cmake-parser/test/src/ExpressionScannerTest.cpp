@@ -0,0 +1,105 @@
+#include "cmake-parser/ExpressionScanner.h"
+
+#include <sstream>
+#include <vector>
+#include "test-platform/GoogleTest.h"
+
+namespace cmake_parser {
+namespace expression {
+
+TEST(ExpressionScannerTest, Next)
+{
+    Scanner scanner("${A}/b-1.txt 12;\"x\\\"y\"");
+    std::vector<std::pair<Terminal, std::string_view>> expected{
+        { Terminal::Dollar, "$" },
+        { Terminal::CurlyBraceOpen, "{" },
+        { Terminal::Name, "A" },
+        { Terminal::CurlyBraceClose, "}" },
+        { Terminal::ForwardSlash, "/" },
+        { Terminal::Name, "b-1" },
+        { Terminal::Dot, "." },
+        { Terminal::Name, "txt" },
+        { Terminal::Whitespace, " " },
+        { Terminal::DigitSequence, "12" },
+        { Terminal::SemiColon, ";" },
+        { Terminal::String, "\"x\\\"y\"" },
+    };
+    Terminal type{};
+    std::string_view value;
+    for (auto const& token : expected)
+    {
+        ASSERT_TRUE(scanner.Next(type, value));
+        EXPECT_EQ(token.first, type);
+        EXPECT_EQ(token.second, value);
+    }
+    EXPECT_TRUE(scanner.IsAtEnd());
+    EXPECT_FALSE(scanner.Next(type, value));
+}
+
+TEST(ExpressionScannerTest, InvalidTextEndsScan)
+{
+    Scanner scanner("a:b c");
+    Terminal type{};
+    std::string_view value;
+
+    ASSERT_TRUE(scanner.Next(type, value));
+    EXPECT_EQ(Terminal::Name, type);
+    ASSERT_TRUE(scanner.Next(type, value));
+    EXPECT_EQ(Terminal::None, type);
+    EXPECT_EQ(":b c", value);
+    EXPECT_FALSE(scanner.Next(type, value));
+}
+
+TEST(ExpressionScannerTest, SameTokensAsLexer)
+{
+    const std::vector<std::string> inputs{
+        "",
+        "text",
+        "${CMAKE_SOURCE_DIR}/output/${PLATFORM_NAME}",
+        "\"text ${A}\"",
+        "a b\t\tc\nd\r\ne",
+        "1.2.3",
+        "1-2",
+        "_x-y_z9",
+        "#comment\nnext",
+        "#comment\r\nnext",
+        "a=b;c{d}e$",
+        "\"a\\\\\" \"b\"",
+        "\"unterminated",
+        "\"escaped newline\\\n\"",
+        "a\rb",
+        "a:b",
+        "-x",
+        "${A}(b)",
+    };
+    for (auto const& input : inputs)
+    {
+        SCOPED_TRACE(input);
+        std::istringstream stream(input);
+        Lexer lexer("", stream);
+        Scanner scanner(input);
+        Terminal type{};
+        std::string_view value;
+        while (true)
+        {
+            auto token = lexer.GetToken();
+            if (token.IsNull())
+            {
+                EXPECT_FALSE(scanner.Next(type, value));
+                break;
+            }
+            ASSERT_TRUE(scanner.Next(type, value));
+            if (token.IsInvalid())
+            {
+                // The rest of the text is invalid, the lexer does not necessarily return it as a single token
+                EXPECT_EQ(Terminal::None, type);
+                break;
+            }
+            EXPECT_EQ(token.Type().TypeCode(), type);
+            EXPECT_EQ(token.Value(), value);
+        }
+    }
+}
+
+} // namespace expression
+} // namespace cmake_parser
@@ -99,5 +99,23 @@ TEST_F(ExpressionTest, ParseExpressionWithVariables)
     EXPECT_EQ(std::filesystem::path(TEST_DATA_DIR) / "output" / "Windows", expression.Evaluate());
 }
 
+TEST_F(ExpressionTest, WhitespaceIsSkipped)
+{
+    EXPECT_EQ("avarAb", Expression::Evaluate(model, "a ${A}\tb"));
+}
+
+TEST_F(ExpressionTest, InvalidTextGivesEmptyResult)
+{
+    EXPECT_EQ("", Expression::Evaluate(model, "${A}:b"));
+    EXPECT_EQ("", Expression::Evaluate(model, "\"unterminated"));
+}
+
+TEST_F(ExpressionTest, MalformedReferenceThrows)
+{
+    EXPECT_THROW(Expression::Evaluate(model, "${A"), std::exception);
+    EXPECT_THROW(Expression::Evaluate(model, "$A"), std::exception);
+    EXPECT_THROW(Expression::Evaluate(model, "${ A}"), std::exception);
+}
+
 } // namespace expression
 } // namespace cmake_parser
@@ -0,0 +1,130 @@
+#include "cmake-parser/IncrementalLexer.h"
+
+#include "test-platform/GoogleTest.h"
+
+using namespace parser;
+
+namespace cmake_parser {
+
+namespace {
+
+const std::string Script =
+    "cmake_minimum_required(VERSION 3.5.1)\n"
+    "project(Test)\n"
+    "\n"
+    "# Sources\n"
+    "set(SOURCES\n"
+    "    main.cpp # Main\n"
+    "    \"lib.cpp\")\n"
+    "add_executable(${PROJECT_NAME} ${SOURCES})\n";
+
+std::string CommandText(const IncrementalLexer& lexer, std::size_t index)
+{
+    auto const& command = lexer.Commands()[index];
+    auto const& tokens = lexer.Tokens();
+    auto begin = tokens.Offset(command.firstToken);
+    auto last = command.firstToken + command.numTokens - 1;
+    return lexer.Source().substr(begin, tokens.Offset(last) + tokens.Length(last) - begin);
+}
+
+void ExpectSameCommands(const IncrementalLexer& expected, const IncrementalLexer& actual)
+{
+    ASSERT_EQ(expected.Commands().size(), actual.Commands().size());
+    for (std::size_t index = 0; index < expected.Commands().size(); ++index)
+    {
+        EXPECT_EQ(expected.Commands()[index].firstToken, actual.Commands()[index].firstToken) << "Command " << index;
+        EXPECT_EQ(expected.Commands()[index].numTokens, actual.Commands()[index].numTokens) << "Command " << index;
+    }
+}
+
+} // namespace
+
+TEST(IncrementalLexerTest, Construct)
+{
+    IncrementalLexer lexer("CMakeLists.txt", Script);
+
+    EXPECT_EQ(Script, lexer.Source());
+    ASSERT_EQ(size_t{ 4 }, lexer.Commands().size());
+    EXPECT_EQ("cmake_minimum_required(VERSION 3.5.1)", CommandText(lexer, 0));
+    EXPECT_EQ("project(Test)", CommandText(lexer, 1));
+    EXPECT_EQ("set(SOURCES\n    main.cpp # Main\n    \"lib.cpp\")", CommandText(lexer, 2));
+    EXPECT_EQ("add_executable(${PROJECT_NAME} ${SOURCES})", CommandText(lexer, 3));
+}
+
+TEST(IncrementalLexerTest, CommandWithoutArguments)
+{
+    IncrementalLexer lexer("CMakeLists.txt", "abc # x\n  def\nghi(\n");
+
+    ASSERT_EQ(size_t{ 3 }, lexer.Commands().size());
+    EXPECT_EQ("abc ", CommandText(lexer, 0));
+    EXPECT_EQ("def", CommandText(lexer, 1));
+    EXPECT_EQ("ghi(\n", CommandText(lexer, 2));
+}
+
+TEST(IncrementalLexerTest, ApplyWithinCommand)
+{
+    IncrementalLexer lexer("CMakeLists.txt", Script);
+
+    auto change = lexer.Apply(TextEdit{ Script.find("Test"), 4, "Other" });
+    EXPECT_EQ(size_t{ 1 }, change.first);
+    EXPECT_EQ(size_t{ 1 }, change.removed);
+    EXPECT_EQ(size_t{ 1 }, change.inserted);
+    EXPECT_EQ("project(Other)", CommandText(lexer, 1));
+    EXPECT_EQ("add_executable(${PROJECT_NAME} ${SOURCES})", CommandText(lexer, 3));
+}
+
+TEST(IncrementalLexerTest, ApplySplitsCommand)
+{
+    IncrementalLexer lexer("CMakeLists.txt", Script);
+
+    auto change = lexer.Apply(TextEdit{ Script.find("    main.cpp"), 0, ")\nmessage(" });
+    EXPECT_EQ(size_t{ 2 }, change.first);
+    EXPECT_EQ(size_t{ 1 }, change.removed);
+    EXPECT_EQ(size_t{ 2 }, change.inserted);
+    ASSERT_EQ(size_t{ 5 }, lexer.Commands().size());
+    EXPECT_EQ("set(SOURCES\n)", CommandText(lexer, 2));
+    EXPECT_EQ("message(    main.cpp # Main\n    \"lib.cpp\")", CommandText(lexer, 3));
+}
+
+TEST(IncrementalLexerTest, ApplyInComment)
+{
+    IncrementalLexer lexer("CMakeLists.txt", Script);
+
+    auto change = lexer.Apply(TextEdit{ Script.find("Sources"), 0, "All " });
+    EXPECT_EQ(size_t{ 0 }, change.removed);
+    EXPECT_EQ(size_t{ 0 }, change.inserted);
+    ASSERT_EQ(size_t{ 4 }, lexer.Commands().size());
+    EXPECT_EQ("add_executable(${PROJECT_NAME} ${SOURCES})", CommandText(lexer, 3));
+}
+
+TEST(IncrementalLexerTest, ApplySameAsConstruct)
+{
+    std::string text;
+    for (int index = 0; index < 20; ++index)
+    {
+        text += Script;
+    }
+    IncrementalLexer lexer("CMakeLists.txt", text);
+
+    const std::string insertions[] = { "", "\"", "#", "\n", "(", ")", "a", " ", "set(x)", "\\" };
+    std::uint32_t random = 54321;
+    for (int edit = 0; edit < 300; ++edit)
+    {
+        random = random * 1103515245u + 12345u;
+        auto size = lexer.Source().size();
+        std::size_t offset = (random >> 8) % (size + 1);
+        std::size_t removed = std::min<std::size_t>((random >> 4) % 4, size - offset);
+        auto const& inserted = insertions[(random >> 16) % 10];
+        lexer.Apply(TextEdit{ offset, removed, inserted });
+        IncrementalLexer expected("CMakeLists.txt", lexer.Source());
+        EXPECT_EQ(expected.Tokens().Types(), lexer.Tokens().Types());
+        EXPECT_EQ(expected.Tokens().Offsets(), lexer.Tokens().Offsets());
+        ExpectSameCommands(expected, lexer);
+        if (::testing::Test::HasFailure())
+        {
+            FAIL() << "Edit " << edit << " at " << offset << " removing " << removed << " inserting \"" << inserted << "\"";
+        }
+    }
+}
+
+} // namespace cmake_parser
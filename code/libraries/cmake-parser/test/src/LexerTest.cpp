@@ -71,6 +71,78 @@ TEST_F(LexerTest, SimpleTerminals)
     EXPECT_TRUE(lexer.IsAtEnd());
 }
 
+TEST_F(LexerTest, Tokenize)
+{
+    std::string compilationUnit("ABC");
+    std::string text("set(A 1)\n");
+
+    auto tokens = Lexer::Tokenize(compilationUnit, text);
+    ASSERT_EQ(size_t{ 7 }, tokens.Size());
+    EXPECT_EQ(TokenType(Terminal::Identifier), tokens.Type(0));
+    EXPECT_EQ("set", tokens.Value(0));
+    EXPECT_EQ(TokenType(Terminal::ParenthesisOpen), tokens.Type(1));
+    EXPECT_EQ(TokenType(Terminal::NewLine), tokens.Type(6));
+    EXPECT_EQ(Token(TokenType(Terminal::ParenthesisClose), ")", SourceLocation("ABC", 1, 8), SourceLocation("ABC", 1, 9)), tokens.MakeToken(5));
+}
+
+TEST_F(LexerTest, TokenizeSameAsRuleSet)
+{
+    std::string compilationUnit("ABC");
+    std::string text(
+        "cmake_minimum_required(VERSION 3.5.1)\r\n"
+        "# Comment with \"quote\"\r\n"
+        "set(NAME-1 ${VAR_2}/path.txt -DX=1 +a:b {}) # trailing\n"
+        "\t  message(\"escaped \\\" \\\\ ${X}\" \"line\nbreak\" \"bad\\\nescape\")\r"
+        "123abc _x-y- 0\n"
+        "\"unterminated ? ;");
+    std::istringstream stream(text);
+    Lexer lexer(compilationUnit, stream);
+
+    auto expected = lexer.Tokenize();
+    auto tokens = Lexer::Tokenize(compilationUnit, text);
+    ASSERT_EQ(expected.Size(), tokens.Size());
+    for (std::size_t index = 0; index < tokens.Size(); ++index)
+    {
+        EXPECT_EQ(expected.MakeToken(index), tokens.MakeToken(index)) << "Token " << index;
+    }
+}
+
+TEST_F(LexerTest, TokenizeTestDataSameAsRuleSet)
+{
+    std::filesystem::path path(TEST_DATA_DIR);
+    path /= "CMakeLists.txt";
+    std::ifstream file(path);
+    std::string text((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    std::istringstream stream(text);
+    Lexer lexer(path, stream);
+
+    auto expected = lexer.Tokenize();
+    auto tokens = Lexer::Tokenize(path, text);
+    EXPECT_EQ(expected.Types(), tokens.Types());
+    EXPECT_EQ(expected.Offsets(), tokens.Offsets());
+    EXPECT_EQ(expected.Lengths(), tokens.Lengths());
+}
+
+TEST_F(LexerTest, TokenizeCached)
+{
+    std::filesystem::path path(TEST_DATA_DIR);
+    path /= "CMakeLists.txt";
+    std::ifstream file(path);
+    std::string text((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    TokenCache cache(std::filesystem::temp_directory_path() / "cmake-parser-lexer-test");
+    std::filesystem::remove_all(cache.Directory());
+
+    auto expected = Lexer::Tokenize(path, text);
+    auto stored = Lexer::Tokenize(path, text, cache);
+    EXPECT_TRUE(std::filesystem::exists(cache.EntryPath(TokenCacheKey::Make(text, Lexer::GrammarId()))));
+    auto loaded = Lexer::Tokenize(path, text, cache);
+    EXPECT_EQ(expected.Types(), stored.Types());
+    EXPECT_EQ(expected.Types(), loaded.Types());
+    EXPECT_EQ(expected.Offsets(), loaded.Offsets());
+    EXPECT_EQ(expected.Lengths(), loaded.Lengths());
+    std::filesystem::remove_all(cache.Directory());
+}
+
 TEST_F(LexerTest, String)
 {
     std::string compilationUnit("ABC");
@@ -0,0 +1,206 @@
+#include "cmake-parser/ModelSnapshot.h"
+
+#include <fstream>
+#include <sstream>
+#include "test-platform/GoogleTest.h"
+#include "cmake-parser/CMakeParser.h"
+
+namespace cmake_parser {
+
+namespace {
+
+class ModelSnapshotTest
+    : public ::testing::Test
+{
+public:
+    std::filesystem::path m_directory;
+
+    ModelSnapshotTest()
+        : m_directory{ std::filesystem::temp_directory_path() / "cmake-parser-model-snapshot-test" }
+    {
+    }
+    void SetUp() override
+    {
+        std::filesystem::remove_all(m_directory);
+        std::filesystem::create_directories(m_directory);
+    }
+    void TearDown() override
+    {
+        std::filesystem::remove_all(m_directory);
+    }
+    void WriteFile(const std::filesystem::path& path, const std::string& text)
+    {
+        std::filesystem::create_directories(path.parent_path());
+        std::ofstream stream(path, std::ios::binary | std::ios::trunc);
+        stream << text;
+    }
+    // Moves the modification time of a file, as if it was written again
+    void Touch(const std::filesystem::path& path)
+    {
+        std::filesystem::last_write_time(path, std::filesystem::last_write_time(path) - std::chrono::hours(1));
+    }
+    void WriteProject()
+    {
+        WriteFile(m_directory / "project" / CMakeScriptFileName,
+            "project(main-project VERSION 1.2.3 DESCRIPTION \"Main project\" LANGUAGES CXX)\n"
+            "set(MAIN_VARIABLE main)\n"
+            "add_subdirectory(lib)\n");
+        WriteFile(m_directory / "project" / "lib" / CMakeScriptFileName,
+            "project(lib)\n"
+            "set(LIB_VARIABLE lib)\n"
+            "unset(MAIN_VARIABLE)\n"
+            "add_library(${PROJECT_NAME} STATIC lib.cpp lib.h)\n"
+            "set_property(TARGET ${PROJECT_NAME} PROPERTY CXX_STANDARD 17)\n");
+    }
+    // Parses the project with a snapshot, and returns the serialized model and the variables of the lib directory
+    bool Parse(std::string& serialized, std::string& libVariables, bool& loadedFromSnapshot)
+    {
+        auto rootDirectory = m_directory / "project";
+        std::ifstream stream(rootDirectory / CMakeScriptFileName);
+        CMakeParser parser(rootDirectory, "cmake-x64-Debug", stream);
+        parser.SetSnapshotPath(m_directory / "model.snapshot");
+        auto result = parser.Parse();
+        serialized = parser.Serialize();
+        auto libDirectory = parser.GetModel().GetDirectories().find(rootDirectory / "lib");
+        libVariables = (libDirectory != parser.GetModel().GetDirectories().end()) ? libDirectory->second->GetVariableList().Serialize() : std::string{};
+        loadedFromSnapshot = parser.IsLoadedFromSnapshot();
+        return result;
+    }
+};
+
+} // namespace
+
+TEST_F(ModelSnapshotTest, InputUnchanged)
+{
+    auto path = m_directory / "input.txt";
+    WriteFile(path, "abc");
+    SnapshotInput input;
+
+    ASSERT_TRUE(SnapshotInput::Make(path, input));
+    EXPECT_EQ(std::uint64_t{ 3 }, input.size);
+    EXPECT_TRUE(input.IsUnchanged());
+}
+
+TEST_F(ModelSnapshotTest, InputTouchedWithSameContents)
+{
+    auto path = m_directory / "input.txt";
+    WriteFile(path, "abc");
+    SnapshotInput input;
+
+    ASSERT_TRUE(SnapshotInput::Make(path, input));
+    Touch(path);
+    EXPECT_TRUE(input.IsUnchanged());
+}
+
+TEST_F(ModelSnapshotTest, InputChanged)
+{
+    auto path = m_directory / "input.txt";
+    WriteFile(path, "abc");
+    SnapshotInput input;
+
+    ASSERT_TRUE(SnapshotInput::Make(path, input));
+    WriteFile(path, "abd");
+    Touch(path);
+    EXPECT_FALSE(input.IsUnchanged());
+    std::filesystem::remove(path);
+    EXPECT_FALSE(input.IsUnchanged());
+}
+
+TEST_F(ModelSnapshotTest, ManifestIsClean)
+{
+    auto path = m_directory / "input.txt";
+    WriteFile(path, "abc");
+    SnapshotManifest manifest(1234);
+
+    EXPECT_FALSE(manifest.AddInput(m_directory / "does_not_exist.txt"));
+    ASSERT_TRUE(manifest.AddInput(path));
+    EXPECT_EQ(size_t{ 1 }, manifest.Inputs().size());
+    EXPECT_TRUE(manifest.IsClean(1234));
+    EXPECT_FALSE(manifest.IsClean(1235));
+    WriteFile(path, "abcd");
+    EXPECT_FALSE(manifest.IsClean(1234));
+}
+
+TEST_F(ModelSnapshotTest, ManifestWriteRead)
+{
+    auto path = m_directory / "input.txt";
+    WriteFile(path, "abc");
+    SnapshotManifest manifest(1234);
+    ASSERT_TRUE(manifest.AddInput(path));
+    std::ostringstream outputStream;
+    SnapshotWriter writer(outputStream);
+    manifest.Write(writer);
+    ASSERT_TRUE(writer.IsValid());
+
+    auto data = outputStream.str();
+    std::istringstream inputStream(data);
+    SnapshotReader reader(inputStream, data.size());
+    SnapshotManifest actual;
+    ASSERT_TRUE(actual.Read(reader));
+    EXPECT_TRUE(reader.IsAtEnd());
+    EXPECT_EQ(manifest.ConfigurationHash(), actual.ConfigurationHash());
+    ASSERT_EQ(size_t{ 1 }, actual.Inputs().size());
+    EXPECT_EQ(path, actual.Inputs()[0].path);
+    EXPECT_EQ(manifest.Inputs()[0].size, actual.Inputs()[0].size);
+    EXPECT_EQ(manifest.Inputs()[0].modificationTime, actual.Inputs()[0].modificationTime);
+    EXPECT_EQ(manifest.Inputs()[0].contentHash, actual.Inputs()[0].contentHash);
+
+    // Truncated data is rejected
+    std::istringstream truncatedStream(data.substr(0, data.size() - 1));
+    SnapshotReader truncatedReader(truncatedStream, data.size() - 1);
+    EXPECT_FALSE(SnapshotManifest().Read(truncatedReader));
+}
+
+TEST_F(ModelSnapshotTest, ParseSavesAndLoadsSnapshot)
+{
+    WriteProject();
+    std::string parsed;
+    std::string parsedLibVariables;
+    std::string loaded;
+    std::string loadedLibVariables;
+    bool loadedFromSnapshot{};
+
+    ASSERT_TRUE(Parse(parsed, parsedLibVariables, loadedFromSnapshot));
+    EXPECT_FALSE(loadedFromSnapshot);
+    EXPECT_TRUE(std::filesystem::exists(m_directory / "model.snapshot"));
+    ASSERT_TRUE(Parse(loaded, loadedLibVariables, loadedFromSnapshot));
+    EXPECT_TRUE(loadedFromSnapshot);
+    EXPECT_EQ(parsed, loaded);
+    EXPECT_NE(std::string::npos, loadedLibVariables.find("LIB_VARIABLE"));
+    EXPECT_EQ(parsedLibVariables, loadedLibVariables);
+}
+
+TEST_F(ModelSnapshotTest, ParseAfterSubdirectoryScriptChanged)
+{
+    WriteProject();
+    std::string parsed;
+    std::string reparsed;
+    std::string libVariables;
+    bool loadedFromSnapshot{};
+
+    ASSERT_TRUE(Parse(parsed, libVariables, loadedFromSnapshot));
+    WriteFile(m_directory / "project" / "lib" / CMakeScriptFileName, "project(lib)\nset(LIB_VARIABLE changed)\n");
+    Touch(m_directory / "project" / "lib" / CMakeScriptFileName);
+    ASSERT_TRUE(Parse(reparsed, libVariables, loadedFromSnapshot));
+    EXPECT_FALSE(loadedFromSnapshot);
+    EXPECT_NE(parsed, reparsed);
+    EXPECT_NE(std::string::npos, libVariables.find("changed"));
+    // The snapshot is saved again for the new scripts
+    ASSERT_TRUE(Parse(parsed, libVariables, loadedFromSnapshot));
+    EXPECT_TRUE(loadedFromSnapshot);
+    EXPECT_EQ(reparsed, parsed);
+}
+
+TEST_F(ModelSnapshotTest, LoadInvalidSnapshotLeavesModelUnchanged)
+{
+    WriteFile(m_directory / "model.snapshot", "not a snapshot");
+    CMakeModel model;
+    model.SetupSourceRoot(m_directory, "cmake-x64-Debug");
+    auto expected = model.Serialize();
+
+    EXPECT_FALSE(model.LoadSnapshot(m_directory / "model.snapshot", 0));
+    EXPECT_FALSE(model.LoadSnapshot(m_directory / "does_not_exist.snapshot", 0));
+    EXPECT_EQ(expected, model.Serialize());
+}
+
+} // namespace cmake_parser
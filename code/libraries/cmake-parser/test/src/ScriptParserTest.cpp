@@ -400,6 +400,193 @@ TEST_F(ScriptParserTest, SimpleProject)
     EXPECT_EQ(expectedOutput, actualOutput);
 }
 
+TEST_F(ScriptParserTest, SimpleProjectPipelined)
+{
+    std::filesystem::path rootDirectory{ std::filesystem::path(TEST_DATA_DIR) / "simple_project" };
+    std::string buildDir{ "cmake-x64-Debug" };
+    std::ifstream stream(rootDirectory / CMakeScriptFileName);
+    CMakeParser topLevelParser(rootDirectory, buildDir, stream);
+    ScriptParser parser(topLevelParser.GetModel(), rootDirectory, stream);
+    std::ifstream pipelinedStream(rootDirectory / CMakeScriptFileName);
+    CMakeParser pipelinedTopLevelParser(rootDirectory, buildDir, pipelinedStream);
+    ScriptParser pipelinedParser(pipelinedTopLevelParser.GetModel(), rootDirectory, pipelinedStream);
+
+    EXPECT_TRUE(parser.Parse());
+    EXPECT_TRUE(pipelinedParser.Parse(parser::ParseMode::Pipelined));
+    EXPECT_EQ(parser.Serialize(), pipelinedParser.Serialize());
+}
+
+TEST_F(ScriptParserTest, CMakeProjectPipelined)
+{
+    std::filesystem::path rootDirectory{ std::filesystem::path(TEST_DATA_DIR) };
+    std::string buildDir{ "cmake-x64-Debug" };
+    std::ifstream stream(rootDirectory / CMakeScriptFileName);
+    CMakeParser topLevelParser(rootDirectory, buildDir, stream);
+    ScriptParser parser(topLevelParser.GetModel(), rootDirectory, stream);
+    std::ifstream pipelinedStream(rootDirectory / CMakeScriptFileName);
+    CMakeParser pipelinedTopLevelParser(rootDirectory, buildDir, pipelinedStream);
+    ScriptParser pipelinedParser(pipelinedTopLevelParser.GetModel(), rootDirectory, pipelinedStream);
+
+    EXPECT_TRUE(parser.Parse());
+    // The subdirectories are parsed in pipelined mode as well
+    EXPECT_TRUE(pipelinedParser.Parse(parser::ParseMode::Pipelined));
+    EXPECT_EQ(parser.Serialize(), pipelinedParser.Serialize());
+}
+
+TEST_F(ScriptParserTest, CMakeProjectParallel)
+{
+    std::filesystem::path rootDirectory{ std::filesystem::path(TEST_DATA_DIR) };
+    std::string buildDir{ "cmake-x64-Debug" };
+    std::ifstream stream(rootDirectory / CMakeScriptFileName);
+    CMakeParser topLevelParser(rootDirectory, buildDir, stream);
+    ScriptParser parser(topLevelParser.GetModel(), rootDirectory, stream);
+    std::ifstream parallelStream(rootDirectory / CMakeScriptFileName);
+    CMakeParser parallelTopLevelParser(rootDirectory, buildDir, parallelStream);
+    ScriptParser parallelParser(parallelTopLevelParser.GetModel(), rootDirectory, parallelStream);
+
+    EXPECT_TRUE(parser.Parse());
+    EXPECT_TRUE(parallelParser.Parse(parser::ParseMode::Parallel));
+    EXPECT_EQ(parser.Serialize(), parallelParser.Serialize());
+    EXPECT_EQ(parser.GetModel().GetVariables().size(), parallelParser.GetModel().GetVariables().size());
+}
+
+TEST_F(ScriptParserTest, CMakeProjectParallelWithTokenCache)
+{
+    std::filesystem::path rootDirectory{ std::filesystem::path(TEST_DATA_DIR) };
+    std::string buildDir{ "cmake-x64-Debug" };
+    auto cacheDirectory = std::filesystem::temp_directory_path() / "cmake-parser-script-parser-test";
+    std::filesystem::remove_all(cacheDirectory);
+    std::ifstream stream(rootDirectory / CMakeScriptFileName);
+    CMakeParser parser(rootDirectory, buildDir, stream);
+    std::ifstream cachedStream(rootDirectory / CMakeScriptFileName);
+    CMakeParser cachedParser(rootDirectory, buildDir, cachedStream);
+    cachedParser.SetTokenCacheDirectory(cacheDirectory);
+    EXPECT_EQ(cacheDirectory, cachedParser.TokenCacheDirectory());
+
+    EXPECT_TRUE(parser.Parse());
+    EXPECT_TRUE(cachedParser.Parse(parser::ParseMode::Parallel));
+    EXPECT_EQ(parser.Serialize(), cachedParser.Serialize());
+    // All scripts were stored, the main script and those of the subdirectories
+    auto numEntries = std::distance(std::filesystem::directory_iterator(cacheDirectory), std::filesystem::directory_iterator());
+    EXPECT_LT(1, numEntries);
+
+    std::ifstream reparsedStream(rootDirectory / CMakeScriptFileName);
+    CMakeParser reparsedParser(rootDirectory, buildDir, reparsedStream);
+    reparsedParser.SetTokenCacheDirectory(cacheDirectory);
+    EXPECT_TRUE(reparsedParser.Parse(parser::ParseMode::Parallel));
+    EXPECT_EQ(parser.Serialize(), reparsedParser.Serialize());
+    EXPECT_EQ(numEntries, std::distance(std::filesystem::directory_iterator(cacheDirectory), std::filesystem::directory_iterator()));
+    std::filesystem::remove_all(cacheDirectory);
+}
+
+TEST_F(ScriptParserTest, ParseErrorStops)
+{
+    std::filesystem::path rootDirectory{ std::filesystem::path(TEST_DATA_DIR) / "minimal" };
+    std::string buildDir{ "cmake-x64-Debug" };
+    std::istringstream stream(
+        "set(A one)\n"
+        "message(BAD_MODE \"text\")\n"
+        "set(B two)\n");
+    CMakeParser topLevelParser(rootDirectory, buildDir, stream);
+    ScriptParser parser(topLevelParser.GetModel(), rootDirectory, stream);
+
+    EXPECT_FALSE(parser.Parse());
+    EXPECT_EQ("one", parser.GetModel().GetVariable("A"));
+    EXPECT_NULL(parser.GetModel().FindVariable("B"));
+    EXPECT_EQ(size_t{ 0 }, parser.GetDiagnostics().size());
+}
+
+TEST_F(ScriptParserTest, ParseErrorRecover)
+{
+    std::filesystem::path rootDirectory{ std::filesystem::path(TEST_DATA_DIR) / "minimal" };
+    std::string buildDir{ "cmake-x64-Debug" };
+    std::istringstream stream(
+        "set(A one)\n"
+        "message(BAD_MODE \"text\")\n"
+        "set(B two)\n"
+        "set(ENV)\n"
+        "set(C three)\n");
+    CMakeParser topLevelParser(rootDirectory, buildDir, stream);
+    ScriptParser parser(topLevelParser.GetModel(), rootDirectory, stream);
+
+    EXPECT_FALSE(parser.Parse(parser::ParseMode::Sequential, parser::ErrorMode::Recover));
+    EXPECT_EQ("one", parser.GetModel().GetVariable("A"));
+    EXPECT_EQ("two", parser.GetModel().GetVariable("B"));
+    EXPECT_EQ("three", parser.GetModel().GetVariable("C"));
+    auto const& diagnostics = parser.GetDiagnostics();
+    ASSERT_EQ(size_t{ 2 }, diagnostics.size());
+    EXPECT_EQ(2, diagnostics[0].location.Line());
+    EXPECT_EQ(1, diagnostics[0].location.Column());
+    EXPECT_EQ("Invalid arguments for message", diagnostics[0].message);
+    EXPECT_EQ(4, diagnostics[1].location.Line());
+    EXPECT_EQ(8, diagnostics[1].location.Column());
+    EXPECT_EQ(rootDirectory / CMakeScriptFileName, diagnostics[1].location.UnitPath());
+}
+
+TEST_F(ScriptParserTest, ParseErrorRecoverCommandWithoutParentheses)
+{
+    std::filesystem::path rootDirectory{ std::filesystem::path(TEST_DATA_DIR) / "minimal" };
+    std::string buildDir{ "cmake-x64-Debug" };
+    std::istringstream stream(
+        "foo bar\n"
+        "set(C three)\n");
+    CMakeParser topLevelParser(rootDirectory, buildDir, stream);
+    ScriptParser parser(topLevelParser.GetModel(), rootDirectory, stream);
+
+    EXPECT_FALSE(parser.Parse(parser::ParseMode::Sequential, parser::ErrorMode::Recover));
+    EXPECT_EQ("three", parser.GetModel().GetVariable("C"));
+    auto const& diagnostics = parser.GetDiagnostics();
+    ASSERT_EQ(size_t{ 1 }, diagnostics.size());
+    EXPECT_EQ(1, diagnostics[0].location.Line());
+    EXPECT_EQ(5, diagnostics[0].location.Column());
+}
+
+TEST_F(ScriptParserTest, ParseErrorRecoverNestedParentheses)
+{
+    std::filesystem::path rootDirectory{ std::filesystem::path(TEST_DATA_DIR) / "minimal" };
+    std::string buildDir{ "cmake-x64-Debug" };
+    std::istringstream stream(
+        "message(STATUS (a)\n"
+        "    b)\n"
+        "set(C three)\n");
+    CMakeParser topLevelParser(rootDirectory, buildDir, stream);
+    ScriptParser parser(topLevelParser.GetModel(), rootDirectory, stream);
+
+    EXPECT_FALSE(parser.Parse(parser::ParseMode::Sequential, parser::ErrorMode::Recover));
+    EXPECT_EQ("three", parser.GetModel().GetVariable("C"));
+    auto const& diagnostics = parser.GetDiagnostics();
+    ASSERT_EQ(size_t{ 1 }, diagnostics.size());
+    EXPECT_EQ(1, diagnostics[0].location.Line());
+}
+
+TEST_F(ScriptParserTest, ParseErrorRecoverInvalidToken)
+{
+    std::filesystem::path rootDirectory{ std::filesystem::path(TEST_DATA_DIR) / "minimal" };
+    std::string buildDir{ "cmake-x64-Debug" };
+    std::string text{
+        "set(A one)\n"
+        "set(B 2 < 3)\n"
+        "set(C three)\n" };
+
+    for (auto mode : { parser::ParseMode::Sequential, parser::ParseMode::Pipelined, parser::ParseMode::Parallel })
+    {
+        SCOPED_TRACE(static_cast<int>(mode));
+        std::istringstream stream(text);
+        CMakeParser topLevelParser(rootDirectory, buildDir, stream);
+        ScriptParser parser(topLevelParser.GetModel(), rootDirectory, stream);
+
+        EXPECT_FALSE(parser.Parse(mode, parser::ErrorMode::Recover));
+        EXPECT_EQ("one", parser.GetModel().GetVariable("A"));
+        EXPECT_NULL(parser.GetModel().FindVariable("B"));
+        EXPECT_EQ("three", parser.GetModel().GetVariable("C"));
+        auto const& diagnostics = parser.GetDiagnostics();
+        ASSERT_EQ(size_t{ 1 }, diagnostics.size());
+        EXPECT_EQ(2, diagnostics[0].location.Line());
+        EXPECT_EQ(9, diagnostics[0].location.Column());
+        EXPECT_EQ("Invalid token: < 3)", diagnostics[0].message);
+    }
+}
+
 TEST_F(ScriptParserTest, CMakeProject)
 {
     std::filesystem::path rootDirectory{ std::filesystem::path(TEST_DATA_DIR) };
@@ -0,0 +1,79 @@
+#include "cmake-parser/ScriptPrefetcher.h"
+
+#include "test-platform/GoogleTest.h"
+#include <filesystem>
+#include "cmake-parser/CMakeModel.h"
+
+namespace cmake_parser {
+
+TEST(ScriptPrefetcherTest, Load)
+{
+    auto directory = std::filesystem::canonical(std::filesystem::path(TEST_DATA_DIR) / "code");
+    auto script = ScriptPrefetcher::Load(directory);
+
+    EXPECT_EQ(directory, script->directory);
+    EXPECT_EQ("add_subdirectory(applications)", script->text.substr(0, 30));
+    ASSERT_TRUE(script->tokens.has_value());
+    EXPECT_EQ(Lexer::Tokenize(directory / CMakeScriptFileName, script->text).Types(), script->tokens->Types());
+}
+
+TEST(ScriptPrefetcherTest, LoadWithTokenCache)
+{
+    auto directory = std::filesystem::canonical(std::filesystem::path(TEST_DATA_DIR) / "code");
+    parser::TokenCache cache(std::filesystem::temp_directory_path() / "cmake-parser-prefetcher-test");
+    std::filesystem::remove_all(cache.Directory());
+
+    auto script = ScriptPrefetcher::Load(directory, &cache);
+    EXPECT_TRUE(std::filesystem::exists(cache.EntryPath(parser::TokenCacheKey::Make(script->text, Lexer::GrammarId()))));
+    auto cachedScript = ScriptPrefetcher::Load(directory, &cache);
+    EXPECT_EQ(script->tokens->Types(), cachedScript->tokens->Types());
+    EXPECT_EQ(script->tokens->Offsets(), cachedScript->tokens->Offsets());
+    std::filesystem::remove_all(cache.Directory());
+}
+
+TEST(ScriptPrefetcherTest, LoadMissingScript)
+{
+    auto script = ScriptPrefetcher::Load(std::filesystem::path(TEST_DATA_DIR) / "does_not_exist");
+
+    EXPECT_EQ("", script->text);
+    EXPECT_EQ(size_t{ 0 }, script->tokens->Size());
+}
+
+TEST(ScriptPrefetcherTest, GetPrefetched)
+{
+    auto directory = std::filesystem::canonical(std::filesystem::path(TEST_DATA_DIR) / "code");
+    ScriptPrefetcher prefetcher(2);
+
+    prefetcher.Prefetch(directory);
+    auto script = prefetcher.Get(directory);
+    EXPECT_EQ(directory, script->directory);
+    EXPECT_EQ(script, prefetcher.Get(directory));
+    // Subdirectories added by the script are read ahead, recursively
+    auto serialization = prefetcher.Get(directory / "libraries" / "serialization");
+    EXPECT_NE("", serialization->text);
+    EXPECT_EQ(serialization, prefetcher.Get(directory / "libraries" / "serialization"));
+}
+
+TEST(ScriptPrefetcherTest, GetNotPrefetched)
+{
+    auto directory = std::filesystem::canonical(std::filesystem::path(TEST_DATA_DIR) / "minimal");
+    ScriptPrefetcher prefetcher(1);
+
+    auto script = prefetcher.Get(directory);
+    EXPECT_EQ(directory, script->directory);
+    EXPECT_NE("", script->text);
+}
+
+TEST(ScriptPrefetcherTest, PrefetchSubdirectoriesSkipsVariables)
+{
+    auto directory = std::filesystem::canonical(std::filesystem::path(TEST_DATA_DIR));
+    std::string text{ "add_subdirectory(${CMAKE_SOURCE_DIR}/code)\nADD_SUBDIRECTORY( minimal )\n" };
+    auto tokens = Lexer::Tokenize("CMakeLists.txt", text);
+    ScriptPrefetcher prefetcher(1);
+
+    prefetcher.PrefetchSubdirectories(directory, tokens);
+    // Reading the prefetched script gives the same result as reading it now
+    EXPECT_EQ(ScriptPrefetcher::Load(directory / "minimal")->text, prefetcher.Get(directory / "minimal")->text);
+}
+
+} // namespace cmake_parser
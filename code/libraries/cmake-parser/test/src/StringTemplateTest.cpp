@@ -0,0 +1,137 @@
+#include "cmake-parser/StringTemplate.h"
+
+#include "test-platform/GoogleTest.h"
+#include "cmake-parser/CMakeModel.h"
+#include "cmake-parser/Expression.h"
+
+namespace cmake_parser {
+namespace expression {
+
+namespace {
+
+// Expansion until nothing changes, as EvaluateString did before templates were compiled
+std::string ExpandUntilFixedPoint(const CMakeModel& model, const std::string& text)
+{
+    std::string prevResult;
+    std::string result = text;
+    while (prevResult != result)
+    {
+        prevResult = result;
+        result = {};
+        size_t index{};
+        while (index < prevResult.length())
+        {
+            char ch = prevResult[index++];
+            if (ch != '$')
+            {
+                result += ch;
+                continue;
+            }
+            if ((index >= prevResult.length()) || (prevResult[index] != '{'))
+                continue;
+            index++;
+            std::string variableName;
+            while ((index < prevResult.length()) && (prevResult[index] != '}') && (prevResult[index] != '$'))
+            {
+                variableName += prevResult[index++];
+            }
+            if ((index < prevResult.length()) && (prevResult[index] == '}'))
+            {
+                result += (model.FindVariable(variableName) == nullptr) ? model.GetCacheVariable(variableName) : model.GetVariable(variableName);
+                index++;
+            }
+            else
+            {
+                result += "${" + variableName;
+            }
+        }
+    }
+    return result;
+}
+
+} // namespace
+
+class StringTemplateTest
+    : public ::testing::Test
+{
+public:
+    CMakeModel model;
+
+    void SetUp() override
+    {
+        model.SetupSourceRoot(TEST_DATA_DIR, "cmake-x64-Debug");
+        model.SetVariable("A", "varA");
+        model.SetVariable("NAME", "A");
+        model.SetVariable("PREFIX", "NA");
+        model.SetVariable("ab", "AB");
+        // Unterminated references are kept when the value is set
+        model.SetVariable("REF", "${NAME");
+        model.SetVariable("CLOSE", "}");
+        model.SetVariable("C", "C", VariableAttribute::Cache, "STRING", "Cached");
+    }
+};
+
+TEST_F(StringTemplateTest, Compile)
+{
+    StringTemplate compiled("a${b}c");
+
+    ASSERT_EQ(size_t{ 5 }, compiled.Ops().size());
+    EXPECT_EQ(StringTemplate::OpCode::Literal, compiled.Ops()[0].code);
+    EXPECT_EQ("a", compiled.Ops()[0].text);
+    EXPECT_EQ(StringTemplate::OpCode::BeginReference, compiled.Ops()[1].code);
+    EXPECT_EQ(StringTemplate::OpCode::Literal, compiled.Ops()[2].code);
+    EXPECT_EQ("b", compiled.Ops()[2].text);
+    EXPECT_EQ(StringTemplate::OpCode::EndReference, compiled.Ops()[3].code);
+    EXPECT_EQ("c", compiled.Ops()[4].text);
+    EXPECT_TRUE(compiled.HasReferences());
+    EXPECT_FALSE(StringTemplate("abc").HasReferences());
+}
+
+TEST_F(StringTemplateTest, Evaluate)
+{
+    std::string result;
+    EXPECT_TRUE(StringTemplate("x${A}y").Evaluate(model, result));
+    EXPECT_EQ("xvarAy", result);
+    EXPECT_TRUE(StringTemplate("${${NAME}}").Evaluate(model, result));
+    EXPECT_EQ("varA", result);
+    EXPECT_TRUE(StringTemplate("${${PREFIX}ME}").Evaluate(model, result));
+    EXPECT_EQ("A", result);
+    EXPECT_TRUE(StringTemplate("${C}").Evaluate(model, result));
+    EXPECT_EQ("C", result);
+    EXPECT_TRUE(StringTemplate("${UNDEFINED}").Evaluate(model, result));
+    EXPECT_EQ("", result);
+    EXPECT_TRUE(StringTemplate("${A").Evaluate(model, result));
+    EXPECT_EQ("${A", result);
+}
+
+TEST_F(StringTemplateTest, EvaluateNeedsFixedPoint)
+{
+    std::string result;
+    ASSERT_EQ("${NAME", model.GetVariable("REF"));
+    EXPECT_FALSE(StringTemplate("${REF}").Evaluate(model, result));
+    EXPECT_FALSE(StringTemplate("${CLOSE}").Evaluate(model, result));
+}
+
+TEST_F(StringTemplateTest, Get)
+{
+    auto compiled = StringTemplate::Get("${A}");
+
+    EXPECT_EQ(compiled, StringTemplate::Get("${A}"));
+    EXPECT_NE(compiled, StringTemplate::Get("${B}"));
+}
+
+TEST_F(StringTemplateTest, EvaluateStringSameAsFixedPoint)
+{
+    const std::vector<std::string> texts{
+        "", "text", "$", "a$b", "$$", "{}", "}", "${", "${}", "${A}", "${A}}", "x${A}y${C}z", "${A", "${A${NAME}",
+        "${${NAME}}", "${${NAME}", "${a$b}", "${a$}", "$${A}", "${${PREFIX}ME}", "${A${NAME}}x", "${REF}", "${REF}}", "${${REF}}",
+        "${CLOSE}", "${A${CLOSE}", "${UNDEFINED}", "${N${UNDEFINED}AME}", "pre ${A} ${A} post",
+    };
+    for (auto const& text : texts)
+    {
+        EXPECT_EQ(ExpandUntilFixedPoint(model, text), Expression::EvaluateString(model, text)) << "Text " << text;
+    }
+}
+
+} // namespace expression
+} // namespace cmake_parser
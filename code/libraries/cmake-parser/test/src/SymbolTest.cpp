@@ -0,0 +1,79 @@
+#include "cmake-parser/Symbol.h"
+
+#include <thread>
+#include <unordered_set>
+#include <vector>
+#include "test-platform/GoogleTest.h"
+
+namespace cmake_parser {
+
+TEST(SymbolTest, Construct)
+{
+    Symbol symbol;
+
+    EXPECT_TRUE(symbol.IsEmpty());
+    EXPECT_EQ(std::uint32_t{ 0 }, symbol.Id());
+    EXPECT_EQ("", symbol.Name());
+    EXPECT_EQ(Symbol(""), symbol);
+}
+
+TEST(SymbolTest, Intern)
+{
+    Symbol symbol("SymbolTest_Intern");
+    Symbol same(std::string("SymbolTest_") + "Intern");
+    Symbol other("SymbolTest_Other");
+
+    EXPECT_FALSE(symbol.IsEmpty());
+    EXPECT_EQ("SymbolTest_Intern", symbol.Name());
+    EXPECT_EQ(symbol, same);
+    EXPECT_EQ(symbol.Id(), same.Id());
+    EXPECT_EQ(&symbol.Name(), &same.Name());
+    EXPECT_NE(symbol, other);
+    EXPECT_EQ(std::hash<Symbol>()(symbol), std::hash<Symbol>()(same));
+}
+
+TEST(SymbolTest, Find)
+{
+    Symbol symbol;
+    auto size = Symbol::TableSize();
+
+    EXPECT_FALSE(Symbol::Find("SymbolTest_NotInterned", symbol));
+    EXPECT_EQ(size, Symbol::TableSize());
+
+    Symbol interned("SymbolTest_Find");
+
+    EXPECT_TRUE(Symbol::Find("SymbolTest_Find", symbol));
+    EXPECT_EQ(interned, symbol);
+}
+
+TEST(SymbolTest, InternConcurrently)
+{
+    const int NumThreads = 4;
+    const int NumNames = 1000;
+    std::vector<std::vector<Symbol>> symbols(NumThreads);
+    std::vector<std::thread> threads;
+    for (int thread = 0; thread < NumThreads; ++thread)
+    {
+        threads.emplace_back([&symbols, thread]()
+        {
+            for (int index = 0; index < NumNames; ++index)
+            {
+                symbols[thread].push_back(Symbol("SymbolTest_Concurrent" + std::to_string(index)));
+            }
+        });
+    }
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+
+    std::unordered_set<Symbol> distinct(symbols[0].begin(), symbols[0].end());
+    EXPECT_EQ(std::size_t{ NumNames }, distinct.size());
+    for (int thread = 1; thread < NumThreads; ++thread)
+    {
+        EXPECT_EQ(symbols[0], symbols[thread]);
+    }
+    EXPECT_EQ("SymbolTest_Concurrent42", symbols[NumThreads - 1][42].Name());
+}
+
+} // namespace cmake_parser
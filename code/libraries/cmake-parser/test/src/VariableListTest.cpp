@@ -156,6 +156,73 @@ TEST_F(VariableListTest, AddVariable)
     EXPECT_EQ("y", variables.FindVariable("x")->Value());
 }
 
+TEST_F(VariableListTest, CreateChildScope)
+{
+    VariableList parent;
+    parent.SetVariable("a", "x");
+    parent.SetVariable("b", "y");
+
+    auto child = parent.CreateChildScope();
+
+    EXPECT_EQ(size_t{ 2 }, child.GetVariables().size());
+    EXPECT_EQ("x", child.GetVariable("a"));
+    EXPECT_EQ("y", child.GetVariable("b"));
+    EXPECT_EQ(parent.FindVariable("a"), child.FindVariable("a"));
+    EXPECT_NULL(child.FindLocalVariable("a"));
+    EXPECT_EQ("VariableList:\nVariable a = x\nVariable b = y\n", child.Serialize());
+}
+
+TEST_F(VariableListTest, ChildScopeCopiesOnWrite)
+{
+    VariableList parent;
+    parent.SetVariable("a", "x");
+    parent.SetVariable("b", "y");
+    auto child = parent.CreateChildScope();
+
+    child.SetVariable("a", "z");
+    child.UnsetVariable("b");
+    child.SetVariable("c", "w");
+    parent.SetVariable("d", "v");
+
+    EXPECT_EQ(size_t{ 2 }, child.GetVariables().size());
+    EXPECT_EQ("z", child.GetVariable("a"));
+    EXPECT_NULL(child.FindVariable("b"));
+    EXPECT_EQ("w", child.GetVariable("c"));
+    EXPECT_NULL(child.FindVariable("d"));
+    EXPECT_EQ(size_t{ 3 }, parent.GetVariables().size());
+    EXPECT_EQ("x", parent.GetVariable("a"));
+    EXPECT_EQ("y", parent.GetVariable("b"));
+    EXPECT_NULL(parent.FindVariable("c"));
+    EXPECT_EQ("v", parent.GetVariable("d"));
+
+    child.SetVariable("b", "u");
+
+    EXPECT_EQ("u", child.GetVariable("b"));
+    EXPECT_EQ("y", parent.GetVariable("b"));
+}
+
+TEST_F(VariableListTest, NestedChildScopes)
+{
+    VariableList scope;
+    for (int index = 0; index < 40; ++index)
+    {
+        scope.SetVariable("v" + std::to_string(index), std::to_string(index));
+        scope = scope.CreateChildScope();
+        scope.UnsetVariable("v0");
+    }
+
+    EXPECT_EQ(size_t{ 39 }, scope.GetVariables().size());
+    EXPECT_NULL(scope.FindVariable("v0"));
+    EXPECT_EQ("1", scope.GetVariable("v1"));
+    EXPECT_EQ("39", scope.GetVariable("v39"));
+
+    VariableList copy(scope);
+
+    EXPECT_EQ(size_t{ 39 }, copy.GetVariables().size());
+    EXPECT_NE(scope.FindVariable("v1"), copy.FindVariable("v1"));
+    EXPECT_EQ("1", copy.FindLocalVariable("v1")->Value());
+}
+
 TEST_F(VariableListTest, SerializeJSONEmpty)
 {
     VariableList variables;
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <string_view>
 #include "parser/Tokenizer.h"
 
 namespace parser {
@@ -61,6 +62,10 @@ private:
     TokenList<TokenTypes> m_tokens;
 
 public:
+    static const TokenizerRuleSet<TokenTypes>& GetRuleSet();
+    // Sets type to the reserved keyword type for text and returns true, returns false if text is not a reserved keyword
+    static bool LookupReservedKeyword(std::string_view text, TokenTypes& type);
+
     Lexer(const std::string& path, std::istream& stream);
     bool Parse();
 
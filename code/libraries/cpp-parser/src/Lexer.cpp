@@ -1,6 +1,7 @@
 #include "cpp-parser/Lexer.h"
 
-#include "parser/TokenizerRule.h"
+#include "parser/KeywordTable.h"
+#include "parser/TokenizerRuleSet.h"
 
 namespace parser {
 
@@ -55,19 +56,19 @@ static TokenDefinitions<TokenTypes> tokenDefinitions {
     TOKEN_DEF(ForwardSlash),    
 };
 
-static TokenizerRules<TokenTypes> reservedKeywordRules{
-    { "class", ClassKeyword},
-    { "struct", StructKeyword},
-    { "virtual", VirtualKeyword},
-    { "override", OverrideKeyword},
-    { "final", FinalKeyword},
-    { "char", CharKeyword},
-    { "int", IntKeyword},
-    { "unsigned", UnsignedKeyword},
-    { "long", LongKeyword},
-    { "float", FloatKeyword},
-    { "double", DoubleKeyword},
-};
+static constexpr auto reservedKeywordTable = MakeKeywordTable<TokenTypes, KeywordCase::Sensitive>({
+    { "class", ClassKeyword },
+    { "struct", StructKeyword },
+    { "virtual", VirtualKeyword },
+    { "override", OverrideKeyword },
+    { "final", FinalKeyword },
+    { "char", CharKeyword },
+    { "int", IntKeyword },
+    { "unsigned", UnsignedKeyword },
+    { "long", LongKeyword },
+    { "float", FloatKeyword },
+    { "double", DoubleKeyword },
+});
 static TokenizerRules<TokenTypes> tokenizerRules{
     { "[ \t]+", Whitespace},
     { "(\r)?\n", NewLine},
@@ -105,20 +106,42 @@ static TokenizerRules<TokenTypes> tokenizerRules{
     { "(?:/|$)(?:/|$).*$", SingleLineComment},
 };
 
+static TokenDefinitions<TokenTypes> AllTokenDefinitions()
+{
+    TokenDefinitions<TokenTypes> allTokenDefinitions{ tokenDefinitions };
+    allTokenDefinitions.insert(allTokenDefinitions.end(), reservedKeywords.begin(), reservedKeywords.end());
+    return allTokenDefinitions;
+}
+
+static TokenizerRules<TokenTypes> AllTokenizerRules()
+{
+    TokenizerRules<TokenTypes> allTokenizerRules{ tokenizerRules };
+    for (auto const& keyword : reservedKeywordTable)
+    {
+        allTokenizerRules.emplace_back(std::string(keyword.text), keyword.value);
+    }
+    return allTokenizerRules;
+}
+
+const TokenizerRuleSet<TokenTypes>& Lexer::GetRuleSet()
+{
+    static const TokenizerRuleSet<TokenTypes> ruleSet(AllTokenDefinitions(), AllTokenizerRules());
+    return ruleSet;
+}
+
+bool Lexer::LookupReservedKeyword(std::string_view text, TokenTypes& type)
+{
+    return reservedKeywordTable.Lookup(text, type);
+}
+
 Lexer::Lexer(const std::string& path, std::istream& stream)
-    : m_tokenizer(path, stream)
+    : m_tokenizer(GetRuleSet(), path, stream)
     , m_tokens{}
 {
 }
 
 bool Lexer::Parse()
 {
-    TokenDefinitions<TokenTypes> allTokenDefinitions{ tokenDefinitions };
-    allTokenDefinitions.insert(allTokenDefinitions.end(), reservedKeywords.begin(), reservedKeywords.end());
-    SetupTokenDefinitions(allTokenDefinitions);
-    TokenizerRules<TokenTypes> allTokenizerRules{ tokenizerRules };
-    allTokenizerRules.insert(allTokenizerRules.end(), reservedKeywordRules.begin(), reservedKeywordRules.end());
-    SetTokenizerRules(allTokenizerRules);
     bool result{ true };
     while (!m_tokenizer.IsAtEnd())
     {
@@ -121,4 +121,16 @@ TEST_F(LexerTest, ReservedKeywords)
     EXPECT_EQ(Token(TokenType(DoubleKeyword), "double", SourceLocation("ABC", 1, 66), SourceLocation("ABC", 1, 72)), lexer.GetTokens()[20]);
 }
 
+TEST_F(LexerTest, LookupReservedKeyword)
+{
+    TokenTypes type{};
+    EXPECT_TRUE(Lexer::LookupReservedKeyword("class", type));
+    EXPECT_EQ(ClassKeyword, type);
+    EXPECT_TRUE(Lexer::LookupReservedKeyword("double", type));
+    EXPECT_EQ(DoubleKeyword, type);
+    EXPECT_FALSE(Lexer::LookupReservedKeyword("Class", type));
+    EXPECT_FALSE(Lexer::LookupReservedKeyword("classes", type));
+    EXPECT_FALSE(Lexer::LookupReservedKeyword("", type));
+}
+
 } // namespace parser
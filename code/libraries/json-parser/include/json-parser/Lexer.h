@@ -1,6 +1,8 @@
 #pragma once
 
+#include "parser/TokenCache.h"
 #include "parser/Tokenizer.h"
+#include "parser/TokenTypeSet.h"
 
 namespace json_parser {
 
@@ -31,11 +33,27 @@ private:
     parser::TokenList<TokenTypes> m_tokens;
 
 public:
+    // Identity of the token types and rules, as tokens in a TokenCache depend on them
+    static std::uint64_t GrammarId();
+
+    static const parser::TokenizerRuleSet<TokenTypes>& GetRuleSet();
+    // Lexes a caller owned source buffer at once, with a matcher built at compile time. The token stream refers to the buffer.
+    static parser::TokenStream<TokenTypes> Tokenize(const std::filesystem::path& path, std::string_view source,
+                                                  std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+    // Same as Tokenize, loading the tokens from the cache if the source text was lexed before
+    static parser::TokenStream<TokenTypes> Tokenize(const std::filesystem::path& path, std::string_view source, const parser::TokenCache& cache);
+    // Same as Tokenize, splitting large buffers into chunks that are lexed on multiple threads
+    static parser::TokenStream<TokenTypes> TokenizeParallel(const std::filesystem::path& path, std::string_view source, std::size_t numThreads = 0);
+
     Lexer(const std::string& path, std::istream& stream);
 
     parser::SourceLocation GetCurrentLocation() const override;
     parser::Token<TokenTypes> GetToken() override;
+    parser::TokenView<TokenTypes> GetTokenView();
+    const parser::TokenView<TokenTypes>& PeekTokenView(std::size_t index = 0);
+    parser::Token<TokenTypes> MakeToken(const parser::TokenView<TokenTypes>& view) const;
     void UngetToken(const parser::Token<TokenTypes>& token) override;
+    parser::TokenStream<TokenTypes> Tokenize();
     bool IsAtEnd() const override;
 };
 
@@ -1,7 +1,6 @@
 #pragma once
 
 #include <memory>
-#include <set>
 #include "json-parser/Lexer.h"
 #include "json-parser/JSONValue.h"
 
@@ -28,7 +27,7 @@ public:
     JSONValuePtr ParseObject();
 
     bool Expect(TokenTypes type, parser::Token<TokenTypes>& token);
-    bool Expect(std::set<TokenTypes> oneOfTypes, parser::Token<TokenTypes>& token);
+    bool Expect(const parser::TokenTypeSet<TokenTypes>& oneOfTypes, parser::Token<TokenTypes>& token);
 
     void OnNoMoreToken(const parser::SourceLocation& location);
     void OnParseError(const std::string& text, const parser::SourceLocation& startLocation, const parser::SourceLocation& endLocation);
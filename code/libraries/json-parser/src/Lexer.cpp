@@ -1,6 +1,8 @@
 #include "json-parser/Lexer.h"
 
-#include "parser/TokenizerRule.h"
+#include "parser/ParallelTokenizer.h"
+#include "parser/StaticGrammar.h"
+#include "parser/TokenizerRuleSet.h"
 
 using namespace json_parser;
 
@@ -24,30 +26,99 @@ static const parser::TokenDefinitions<TokenTypes> tokenDefinitions {
     TOKEN_DEF(String),
 };
 
-static const parser::TokenizerRules<TokenTypes> tokenizerRules {
-    { "[[:space:]]+", {TokenTypes::Whitespace} },
-    { "\\[", TokenTypes::SquareBracketOpen},
-    { "\\]", TokenTypes::SquareBracketClose },
-    { "\\{", TokenTypes::CurlyBraceOpen},
-    { "\\}", TokenTypes::CurlyBraceClose },
-    { ",", TokenTypes::Comma },
-    { ":", TokenTypes::Colon },
-    { "[Nn][Uu][Ll][Ll]", TokenTypes::Null },
-    { "[Tt][Rr][Uu][Ee]", TokenTypes::True },
-    { "[Ff][Aa][Ll][Ss][Ee]", TokenTypes::False },
-    { "[+-]?[0-9]*[.][0-9]+|[0-9]+[.]?", { TokenTypes::Number } },
-    { "[Ee][+-]?[0-9]+", { TokenTypes::NumberExponent } },
-    { "\"(?:[^\"\\\\]|\\\\.)*\"", { TokenTypes::String } },
+static constexpr bool IsDigit(char ch)
+{
+    return (ch >= '0') && (ch <= '9');
+}
+
+static constexpr std::size_t SkipDigits(std::string_view text, std::size_t index)
+{
+    while ((index < text.length()) && IsDigit(text[index]))
+        ++index;
+    return index;
+}
+
+// Longest match of [+-]?[0-9]*[.][0-9]+|[0-9]+[.]?
+static constexpr std::size_t MatchNumber(std::string_view text)
+{
+    std::size_t result{};
+    auto integerEnd = SkipDigits(text, 0);
+    if (integerEnd > 0)
+        result = ((integerEnd < text.length()) && (text[integerEnd] == '.')) ? integerEnd + 1 : integerEnd;
+    std::size_t index = ((text[0] == '+') || (text[0] == '-')) ? 1 : 0;
+    index = SkipDigits(text, index);
+    if ((index < text.length()) && (text[index] == '.'))
+    {
+        auto fractionEnd = SkipDigits(text, index + 1);
+        if ((fractionEnd > index + 1) && (fractionEnd > result))
+            result = fractionEnd;
+    }
+    return result;
+}
+
+// Longest match of [Ee][+-]?[0-9]+
+static constexpr std::size_t MatchNumberExponent(std::string_view text)
+{
+    std::size_t index = 1;
+    if ((index < text.length()) && ((text[index] == '+') || (text[index] == '-')))
+        ++index;
+    auto end = SkipDigits(text, index);
+    return (end > index) ? end : 0;
+}
+
+// The grammar, which is matched directly when lexing a buffer, and from which the rule set for lexing streams is built
+using StaticTerminal = parser::StaticTerminal<TokenTypes>;
+static constexpr StaticTerminal staticTerminals[] = {
+    StaticTerminal::Repeat(parser::CharacterClass::Of(" \t\n\v\f\r"), TokenTypes::Whitespace),
+    StaticTerminal::Literal("[", TokenTypes::SquareBracketOpen),
+    StaticTerminal::Literal("]", TokenTypes::SquareBracketClose),
+    StaticTerminal::Literal("{", TokenTypes::CurlyBraceOpen),
+    StaticTerminal::Literal("}", TokenTypes::CurlyBraceClose),
+    StaticTerminal::Literal(",", TokenTypes::Comma),
+    StaticTerminal::Literal(":", TokenTypes::Colon),
+    StaticTerminal::Literal("null", TokenTypes::Null, true),
+    StaticTerminal::Literal("true", TokenTypes::True, true),
+    StaticTerminal::Literal("false", TokenTypes::False, true),
+    StaticTerminal::Custom(parser::CharacterClass::Of("+-.0123456789"), MatchNumber, "[+-]?[0-9]*[.][0-9]+|[0-9]+[.]?", TokenTypes::Number),
+    StaticTerminal::Custom(parser::CharacterClass::Of("Ee"), MatchNumberExponent, "[Ee][+-]?[0-9]+", TokenTypes::NumberExponent),
+    StaticTerminal::Quoted('"', '\\', TokenTypes::String),
 };
+static constexpr parser::StaticGrammar staticGrammar(staticTerminals);
+
+const parser::TokenizerRuleSet<TokenTypes>& Lexer::GetRuleSet()
+{
+    static const parser::TokenizerRuleSet<TokenTypes> ruleSet(tokenDefinitions, parser::MakeTokenizerRules(staticGrammar));
+    return ruleSet;
+}
+
+std::uint64_t Lexer::GrammarId()
+{
+    static const std::uint64_t grammarId = parser::GrammarId("json_parser::Lexer", staticGrammar);
+    return grammarId;
+}
+
+parser::TokenStream<TokenTypes> Lexer::Tokenize(const std::filesystem::path& path, std::string_view source, std::pmr::memory_resource* resource)
+{
+    return parser::Tokenize(staticGrammar, path, source, resource);
+}
+
+parser::TokenStream<TokenTypes> Lexer::Tokenize(const std::filesystem::path& path, std::string_view source, const parser::TokenCache& cache)
+{
+    return cache.Tokenize<TokenTypes>(GrammarId(), path, source, [](const std::filesystem::path& unit, std::string_view text)
+    {
+        return Tokenize(unit, text);
+    });
+}
+
+parser::TokenStream<TokenTypes> Lexer::TokenizeParallel(const std::filesystem::path& path, std::string_view source, std::size_t numThreads)
+{
+    return parser::TokenizeParallel(GetRuleSet(), path, source, numThreads);
+}
 
 Lexer::Lexer(const std::string& path, std::istream& stream)
-    : m_tokenizer(path, stream)
+    : m_tokenizer(GetRuleSet(), path, stream)
     , m_tokens{}
 {
-    parser::TokenDefinitions<TokenTypes> allTokenDefinitions{ tokenDefinitions };
-    SetupTokenDefinitions(allTokenDefinitions);
-    parser::TokenizerRules<TokenTypes> allTokenizerRules{ tokenizerRules };
-    SetTokenizerRules(allTokenizerRules);
 }
 
 parser::SourceLocation Lexer::GetCurrentLocation() const
@@ -60,11 +131,31 @@ parser::Token<TokenTypes> Lexer::GetToken()
     return m_tokenizer.GetToken();
 }
 
+parser::TokenView<TokenTypes> Lexer::GetTokenView()
+{
+    return m_tokenizer.GetTokenView();
+}
+
+const parser::TokenView<TokenTypes>& Lexer::PeekTokenView(std::size_t index)
+{
+    return m_tokenizer.PeekTokenView(index);
+}
+
+parser::Token<TokenTypes> Lexer::MakeToken(const parser::TokenView<TokenTypes>& view) const
+{
+    return m_tokenizer.MakeToken(view);
+}
+
 void Lexer::UngetToken(const parser::Token<TokenTypes>& token)
 {
     m_tokenizer.UngetToken(token);
 }
 
+parser::TokenStream<TokenTypes> Lexer::Tokenize()
+{
+    return m_tokenizer.Tokenize();
+}
+
 bool Lexer::IsAtEnd() const
 {
     return m_tokenizer.IsAtEnd();
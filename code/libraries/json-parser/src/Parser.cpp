@@ -57,15 +57,9 @@ JSONValuePtr Parser::ParseValue()
             case TokenTypes::Number:
                 {
                     auto value = token.Value();
-                    token = m_lexer.GetToken();
-                    if (token.Type() == TokenTypes::NumberExponent)
+                    if (m_lexer.PeekTokenView().Type() == TokenTypes::NumberExponent)
                     {
-                        value += token.Value();
-                    }
-                    else
-                    {
-                        if (!token.IsNull())
-                            m_lexer.UngetToken(token);
+                        value += m_lexer.GetTokenView().Value();
                     }
                     return std::make_shared<JSONNumber>(value);
                 }
@@ -145,10 +139,12 @@ JSONValuePtr Parser::ParseObject()
 
 bool Parser::Expect(TokenTypes type, Token<TokenTypes>& token)
 {
-    do
+    auto tokenView = m_lexer.GetTokenView();
+    while (tokenView.Type() == TokenTypes::Whitespace)
     {
-        token = m_lexer.GetToken();
-    } while (token.Type() == TokenTypes::Whitespace);
+        tokenView = m_lexer.GetTokenView();
+    }
+    token = m_lexer.MakeToken(tokenView);
     if (token.Type() != type)
     {
         OnParseError(token.Value(), token.BeginLocation(), token.EndLocation());
@@ -157,13 +153,15 @@ bool Parser::Expect(TokenTypes type, Token<TokenTypes>& token)
     return true;
 }
 
-bool Parser::Expect(std::set<TokenTypes> oneOfTypes, Token<TokenTypes>& token)
+bool Parser::Expect(const TokenTypeSet<TokenTypes>& oneOfTypes, Token<TokenTypes>& token)
 {
-    do
+    auto tokenView = m_lexer.GetTokenView();
+    while (tokenView.Type() == TokenTypes::Whitespace)
     {
-        token = m_lexer.GetToken();
-    } while (token.Type() == TokenTypes::Whitespace);
-    if (oneOfTypes.find(token.Type().TypeCode()) == oneOfTypes.end())
+        tokenView = m_lexer.GetTokenView();
+    }
+    token = m_lexer.MakeToken(tokenView);
+    if (!oneOfTypes.Contains(token.Type().TypeCode()))
     {
         OnParseError(token.Value(), token.BeginLocation(), token.EndLocation());
         return false;
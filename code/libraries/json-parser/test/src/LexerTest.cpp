@@ -118,4 +118,22 @@ TEST_F(LexerTest, StringValues)
     EXPECT_TRUE(lexer.IsAtEnd());
 }
 
+TEST_F(LexerTest, TokenizeSameAsRuleSet)
+{
+    std::string compilationUnit("ABC");
+    std::string text(
+        "{ \"a\": [ 1, -2.5, .5, 7., +.25e-3, 1E+09, e5, E ],\r\n\t\"b\\\"c\": NULL, \"d\": True, \"e\": fAlse }\n"
+        "\"escaped \\\\ \\n\" \"unterminated\\\n\" ++ 1.2.3 nul \"open");
+    std::istringstream stream(text);
+    Lexer lexer(compilationUnit, stream);
+
+    auto expected = lexer.Tokenize();
+    auto tokens = Lexer::Tokenize(compilationUnit, text);
+    ASSERT_EQ(expected.Size(), tokens.Size());
+    for (std::size_t index = 0; index < tokens.Size(); ++index)
+    {
+        EXPECT_EQ(expected.MakeToken(index), tokens.MakeToken(index)) << "Token " << index;
+    }
+}
+
 } // namespace json_parser
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <array>
+#include <bitset>
+#include <cstdint>
+#include <string_view>
+
+namespace parser {
+
+// Set of characters for which a scan continues, as at most MaxRanges inclusive ranges of byte values.
+// When the set itself needs too many ranges, the ranges hold the characters that end the scan instead.
+class CharacterRun
+{
+public:
+    static constexpr std::size_t MaxRanges = 4;
+
+private:
+    std::array<std::uint8_t, MaxRanges> m_first;
+    std::array<std::uint8_t, MaxRanges> m_last;
+    std::size_t m_numRanges;
+    bool m_continueInRanges;
+
+public:
+    CharacterRun();
+    // Returns an empty run if neither the set nor its complement fits in MaxRanges ranges
+    static CharacterRun FromSet(const std::bitset<256>& characters);
+
+    bool IsEmpty() const { return m_numRanges == 0; }
+    std::size_t NumRanges() const { return m_numRanges; }
+    std::uint8_t First(std::size_t index) const { return m_first[index]; }
+    std::uint8_t Last(std::size_t index) const { return m_last[index]; }
+    bool ContinueInRanges() const { return m_continueInRanges; }
+    bool Contains(char ch) const
+    {
+        auto value = static_cast<std::uint8_t>(ch);
+        bool inRanges{};
+        for (std::size_t index = 0; index < m_numRanges; ++index)
+        {
+            if (static_cast<std::uint8_t>(value - m_first[index]) <= static_cast<std::uint8_t>(m_last[index] - m_first[index]))
+                inRanges = true;
+        }
+        return inRanges == m_continueInRanges;
+    }
+};
+
+enum class ScanLevel
+{
+    Scalar,
+    SSE2,
+    AVX2,
+};
+
+// Finds the end of a run of characters using the widest vector instructions the processor supports, 16 or 32
+// characters at a time. The level is detected on first use, and can be lowered, for instance to test the fallbacks.
+class CharacterScanner
+{
+public:
+    static ScanLevel SupportedLevel();
+    static ScanLevel Level();
+    // Sets the level used, limited to the supported level
+    static void SetLevel(ScanLevel level);
+
+    // Returns the number of characters at the start of the text that are part of the run
+    static std::size_t Skip(std::string_view text, const CharacterRun& run);
+};
+
+} // namespace parser
@@ -0,0 +1,12 @@
+#pragma once
+
+#include <cstdint>
+#include <string_view>
+
+namespace parser {
+
+// 64-bit hash of a source text, to recognize text that was seen before. The hash is the XXH64 hash, which
+// processes several gigabytes per second, so it is negligible compared to lexing the text.
+std::uint64_t ContentHash(std::string_view text, std::uint64_t seed = 0);
+
+} // namespace parser
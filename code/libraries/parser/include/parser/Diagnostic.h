@@ -0,0 +1,24 @@
+#pragma once
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include "parser/SourceLocation.h"
+
+namespace parser {
+
+// Error found while parsing, with the location in the source text where it was found
+struct Diagnostic
+{
+    SourceLocation location;
+    std::string message;
+};
+
+using Diagnostics = std::vector<Diagnostic>;
+
+inline std::ostream& operator << (std::ostream& stream, const Diagnostic& value)
+{
+    return stream << value.location << ": error: " << value.message;
+}
+
+} // namespace parser
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace parser {
+
+using FileId = std::uint32_t;
+
+// Table of compilation units, shared by all source locations.
+// A unit path is interned once to a 32-bit file id. When the text of a unit is registered, the file id also
+// refers to an index of line starts, so a source location only needs to store the file id and an offset.
+// Every registered text with a different line structure gets its own file id with its own line index, which is never
+// changed, so locations made from an earlier text of a unit, or from another text with the same path, keep their
+// line and column. Texts of a unit with the same line structure share a file id, found through a hash of the line
+// index, so registering a unit again without adding or removing lines does not grow the table.
+class FileTable
+{
+public:
+    static constexpr FileId NoFile = 0;
+
+private:
+    struct Entry
+    {
+        // Refers to the key in m_units, so the path is stored once for all texts of the unit
+        const std::filesystem::path* path;
+        bool hasText;
+        std::vector<std::uint32_t> lineStarts;
+        std::vector<std::uint32_t> carriageReturns;
+    };
+    struct Unit
+    {
+        // File id returned by Intern, the first text registered for the unit uses it as well
+        FileId fileId;
+        // File ids of the registered texts, by hash of their line index
+        std::unordered_multimap<std::uint64_t, FileId> textFileIds;
+    };
+
+    typedef std::shared_mutex Mutex;
+    typedef std::shared_lock<Mutex> ReadLock;
+    typedef std::unique_lock<Mutex> WriteLock;
+    static Mutex m_mutex;
+    static std::vector<std::unique_ptr<Entry>> m_entries;
+    static std::map<std::filesystem::path, Unit> m_units;
+
+public:
+    static FileId Intern(const std::filesystem::path& unitPath);
+    static FileId Register(const std::filesystem::path& unitPath, std::string_view text);
+    static const std::filesystem::path& UnitPath(FileId fileId);
+    static std::pair<int, int> LineAndColumn(FileId fileId, std::uint32_t offset);
+    static std::size_t Size();
+
+private:
+    static const Entry& GetEntry(FileId fileId);
+    static Unit& GetUnit(const std::filesystem::path& unitPath);
+};
+
+} // namespace parser
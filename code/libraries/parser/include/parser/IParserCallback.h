@@ -6,6 +6,8 @@
 namespace parser {
 
 class SourceLocation;
+template<typename UnderlyingType>
+class ITokenizer;
 
 template<typename UnderlyingType>
 class IParserCallback
@@ -16,6 +18,9 @@ public:
     virtual bool OnNoMoreToken(const SourceLocation& location) = 0;
     virtual void OnSkipToken(const Token<UnderlyingType>& token) = 0;
     virtual void OnParseError(const Token<UnderlyingType>& token) = 0;
+    // Called after a parse error when recovering from errors, to skip tokens up to a point where parsing can continue.
+    // Returns false if parsing cannot continue.
+    virtual bool OnRecover(ITokenizer<UnderlyingType>& /*tokenizer*/) { return false; }
 };
 
 } // namespace parser
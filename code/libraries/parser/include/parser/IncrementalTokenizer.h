@@ -0,0 +1,178 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <filesystem>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "parser/FileTable.h"
+#include "parser/Tokenizer.h"
+#include "parser/TokenizerRuleSet.h"
+#include "parser/TokenStream.h"
+
+namespace parser {
+
+// Change of a source text: removedLength characters at offset are replaced by the inserted text
+struct TextEdit
+{
+    std::size_t offset;
+    std::size_t removedLength;
+    std::string_view insertedText;
+};
+
+// Tokens replaced by an edit: the tokens [first, first + removed) of the previous stream are replaced by the tokens
+// [first, first + inserted) of the new stream. The tokens after them are the same, at shifted offsets.
+struct TokenChange
+{
+    std::size_t first;
+    std::size_t removed;
+    std::size_t inserted;
+};
+
+// Keeps the token stream of a source text up to date while the text is edited, such as in an editor.
+// For every token, the tokenizer records how far it looked ahead in the text to read it. As the tokenizer keeps no
+// state between tokens, an edit can only change the tokens that looked at the edited text, and the tokens after them.
+// Lexing restarts at the first token that looked at the edited text, and stops as soon as a token starts where a token
+// after the edit started before, from where the previous tokens are reused. The lexing work therefore depends on the
+// size of the edit and the tokens around it, not on the size of the text.
+template<typename UnderlyingType>
+class IncrementalTokenizer
+{
+private:
+    const TokenizerRuleSet<UnderlyingType>& m_ruleSet;
+    std::filesystem::path m_compilationUnit;
+    std::string m_source;
+    FileId m_fileId;
+    TokenStream<UnderlyingType> m_tokens;
+    // Number of characters after the end of each token that were examined to read it
+    std::vector<std::uint32_t> m_lookAheads;
+    std::uint32_t m_maxLookAhead;
+
+public:
+    IncrementalTokenizer(const TokenizerRuleSet<UnderlyingType>& ruleSet, const std::filesystem::path& compilationUnit, std::string source);
+    IncrementalTokenizer(const IncrementalTokenizer&) = delete;
+    IncrementalTokenizer& operator = (const IncrementalTokenizer&) = delete;
+
+    const std::string& Source() const { return m_source; }
+    const TokenStream<UnderlyingType>& Tokens() const { return m_tokens; }
+    FileId GetFileId() const { return m_fileId; }
+
+    // Applies an edit to the source text and updates the tokens. Throws std::out_of_range if the removed text is not
+    // part of the source text.
+    TokenChange Apply(const TextEdit& edit);
+    // Edits leave the line index of the FileTable as it was for the text before the edits, as registering every
+    // version of the text would take time proportional to its size. Registers the current text, so that tokens made
+    // from the stream have correct line and column numbers.
+    FileId Register();
+
+private:
+    std::size_t FirstAffectedToken(std::size_t offset) const;
+    void AddToken(Tokenizer<UnderlyingType>& tokenizer, const TokenView<UnderlyingType>& view, TokenStream<UnderlyingType>& tokens, std::vector<std::uint32_t>& lookAheads);
+};
+
+template<typename UnderlyingType>
+IncrementalTokenizer<UnderlyingType>::IncrementalTokenizer(const TokenizerRuleSet<UnderlyingType>& ruleSet, const std::filesystem::path& compilationUnit, std::string source)
+    : m_ruleSet(ruleSet)
+    , m_compilationUnit{ compilationUnit }
+    , m_source{ std::move(source) }
+    , m_fileId{ FileTable::Register(compilationUnit, m_source) }
+    , m_tokens(m_source, m_fileId)
+    , m_lookAheads{}
+    , m_maxLookAhead{}
+{
+    Tokenizer<UnderlyingType> tokenizer(m_ruleSet, m_fileId, m_source);
+    for (auto view = tokenizer.GetTokenView(); !view.IsNull(); view = tokenizer.GetTokenView())
+    {
+        AddToken(tokenizer, view, m_tokens, m_lookAheads);
+    }
+}
+
+template<typename UnderlyingType>
+TokenChange IncrementalTokenizer<UnderlyingType>::Apply(const TextEdit& edit)
+{
+    if ((edit.offset > m_source.size()) || (edit.removedLength > m_source.size() - edit.offset))
+        throw std::out_of_range("Edit exceeds source text");
+
+    auto first = FirstAffectedToken(edit.offset);
+    auto restartOffset = (first < m_tokens.Size()) ? m_tokens.Offset(first) : edit.offset;
+    auto shift = static_cast<std::ptrdiff_t>(edit.insertedText.size()) - static_cast<std::ptrdiff_t>(edit.removedLength);
+    auto editEnd = edit.offset + edit.removedLength;
+    auto insertedEnd = edit.offset + edit.insertedText.size();
+    m_source.replace(edit.offset, edit.removedLength, edit.insertedText);
+
+    // Tokens that started after the removed text only depend on the text after the edit, which did not change
+    auto const& offsets = m_tokens.Offsets();
+    auto next = static_cast<std::size_t>(std::lower_bound(offsets.begin() + static_cast<std::ptrdiff_t>(first), offsets.end(), editEnd) - offsets.begin());
+    TokenStream<UnderlyingType> tokens(m_source, m_fileId);
+    std::vector<std::uint32_t> lookAheads;
+    bool inStep{};
+    Tokenizer<UnderlyingType> tokenizer(m_ruleSet, m_fileId, m_source);
+    tokenizer.Seek(restartOffset);
+    for (auto view = tokenizer.GetTokenView(); !view.IsNull(); view = tokenizer.GetTokenView())
+    {
+        if (view.Offset() >= insertedEnd)
+        {
+            auto previousOffset = static_cast<std::size_t>(static_cast<std::ptrdiff_t>(view.Offset()) - shift);
+            while ((next < offsets.size()) && (offsets[next] < previousOffset))
+                ++next;
+            if ((next < offsets.size()) && (offsets[next] == previousOffset))
+            {
+                inStep = true;
+                break;
+            }
+        }
+        AddToken(tokenizer, view, tokens, lookAheads);
+    }
+    if (!inStep)
+        next = m_tokens.Size();
+
+    TokenChange change{ first, next - first, tokens.Size() };
+    m_tokens.Replace(first, change.removed, tokens, shift);
+    ReplaceRange(m_lookAheads, first, change.removed, lookAheads);
+    return change;
+}
+
+template<typename UnderlyingType>
+FileId IncrementalTokenizer<UnderlyingType>::Register()
+{
+    m_fileId = FileTable::Register(m_compilationUnit, m_source);
+    m_tokens.Replace(0, 0, TokenStream<UnderlyingType>(m_source, m_fileId), 0);
+    return m_fileId;
+}
+
+// Returns the index of the first token that looked at the text at the offset or beyond it, which is at most the token
+// containing the offset. Only tokens that end within the largest lookahead before the offset need to be checked.
+template<typename UnderlyingType>
+std::size_t IncrementalTokenizer<UnderlyingType>::FirstAffectedToken(std::size_t offset) const
+{
+    auto const& offsets = m_tokens.Offsets();
+    auto first = static_cast<std::size_t>(std::upper_bound(offsets.begin(), offsets.end(), offset) - offsets.begin());
+    if (first > 0)
+        --first;
+    auto index = first;
+    while (index > 0)
+    {
+        --index;
+        std::size_t end = m_tokens.Offset(index) + m_tokens.Length(index);
+        if (end + m_maxLookAhead < offset)
+            break;
+        // A token that looked up to the end of the text also changes when text is added at the end
+        auto scanEnd = end + m_lookAheads[index];
+        if ((scanEnd > offset) || (scanEnd == m_source.size()))
+            first = index;
+    }
+    return first;
+}
+
+template<typename UnderlyingType>
+void IncrementalTokenizer<UnderlyingType>::AddToken(Tokenizer<UnderlyingType>& tokenizer, const TokenView<UnderlyingType>& view, TokenStream<UnderlyingType>& tokens, std::vector<std::uint32_t>& lookAheads)
+{
+    auto lookAhead = static_cast<std::uint32_t>(tokenizer.ScanEnd() - (view.Offset() + view.Length()));
+    tokens.Add(view);
+    lookAheads.push_back(lookAhead);
+    m_maxLookAhead = std::max(m_maxLookAhead, lookAhead);
+}
+
+} // namespace parser
@@ -0,0 +1,155 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <stdexcept>
+#include <string_view>
+
+namespace parser {
+
+enum class KeywordCase
+{
+    Sensitive,
+    Insensitive,
+};
+
+template<typename Enum>
+struct KeywordEntry
+{
+    std::string_view text;
+    Enum value;
+};
+
+// Table of keywords with a perfect hash, built at compile time.
+// The constructor searches for a hash seed for which all keywords land in a different slot, so a lookup hashes the
+// text once and compares it against at most one keyword, without allocating. Keywords that differ only in case (for
+// a case insensitive table) or duplicate keywords make the search fail, which is a compile error for a constexpr table.
+template<typename Enum, std::size_t NumKeywords, KeywordCase Case = KeywordCase::Insensitive>
+class KeywordTable
+{
+public:
+    // At least eight slots per keyword, so a collision free seed is found in a few attempts
+    static constexpr std::size_t NumSlots = []()
+    {
+        std::size_t size = 16;
+        while (size < 8 * NumKeywords)
+            size *= 2;
+        return size;
+    }();
+
+private:
+    static constexpr std::uint32_t MaxSeeds = 65536;
+
+    std::array<KeywordEntry<Enum>, NumKeywords> m_keywords;
+    // Index of the keyword in each slot plus one, 0 for an empty slot
+    std::array<std::uint16_t, NumSlots> m_slots;
+    std::uint32_t m_seed;
+    std::size_t m_maxLength;
+
+public:
+    constexpr explicit KeywordTable(const KeywordEntry<Enum> (&keywords)[NumKeywords])
+        : m_keywords{}
+        , m_slots{}
+        , m_seed{}
+        , m_maxLength{}
+    {
+        static_assert(NumKeywords < 65536, "Too many keywords for a keyword table");
+        for (std::size_t index = 0; index < NumKeywords; ++index)
+        {
+            m_keywords[index] = keywords[index];
+            if (keywords[index].text.size() > m_maxLength)
+                m_maxLength = keywords[index].text.size();
+        }
+        for (; m_seed < MaxSeeds; ++m_seed)
+        {
+            if (FillSlots())
+                return;
+        }
+        throw std::logic_error("No perfect hash found for keyword table, keywords must be unique");
+    }
+
+    // Sets value to the keyword matching text and returns true, returns false if text is not a keyword
+    constexpr bool Lookup(std::string_view text, Enum& value) const
+    {
+        if (text.size() > m_maxLength)
+            return false;
+        auto slot = m_slots[Hash(text, m_seed) & (NumSlots - 1)];
+        if ((slot == 0) || !IsEqual(m_keywords[slot - 1].text, text))
+            return false;
+        value = m_keywords[slot - 1].value;
+        return true;
+    }
+    // Returns the keyword matching text, or notFound if text is not a keyword
+    constexpr Enum Find(std::string_view text, Enum notFound) const
+    {
+        Enum value{};
+        return Lookup(text, value) ? value : notFound;
+    }
+    constexpr bool Contains(std::string_view text) const
+    {
+        Enum value{};
+        return Lookup(text, value);
+    }
+
+    constexpr std::size_t Size() const { return NumKeywords; }
+    constexpr std::uint32_t Seed() const { return m_seed; }
+    constexpr auto begin() const { return m_keywords.begin(); }
+    constexpr auto end() const { return m_keywords.end(); }
+
+private:
+    static constexpr unsigned char Fold(char ch)
+    {
+        // Case insensitive tables only need 'A' and 'a' to hash the same, the final comparison is exact
+        return (Case == KeywordCase::Insensitive) ? static_cast<unsigned char>(ch | 0x20) : static_cast<unsigned char>(ch);
+    }
+    static constexpr char ToLower(char ch)
+    {
+        return ((ch >= 'A') && (ch <= 'Z')) ? static_cast<char>(ch - 'A' + 'a') : ch;
+    }
+    static constexpr std::uint32_t Hash(std::string_view text, std::uint32_t seed)
+    {
+        // FNV-1a with the seed mixed into the offset basis
+        std::uint32_t hash = 2166136261u ^ (seed * 0x9E3779B9u);
+        for (auto ch : text)
+        {
+            hash = (hash ^ Fold(ch)) * 16777619u;
+        }
+        return hash ^ (hash >> 15);
+    }
+    static constexpr bool IsEqual(std::string_view keyword, std::string_view text)
+    {
+        if (keyword.size() != text.size())
+            return false;
+        for (std::size_t index = 0; index < text.size(); ++index)
+        {
+            if ((Case == KeywordCase::Insensitive) ? (ToLower(keyword[index]) != ToLower(text[index])) : (keyword[index] != text[index]))
+                return false;
+        }
+        return true;
+    }
+    constexpr bool FillSlots()
+    {
+        for (auto& slot : m_slots)
+        {
+            slot = 0;
+        }
+        for (std::size_t index = 0; index < NumKeywords; ++index)
+        {
+            auto& slot = m_slots[Hash(m_keywords[index].text, m_seed) & (NumSlots - 1)];
+            if (slot != 0)
+                return false;
+            slot = static_cast<std::uint16_t>(index + 1);
+        }
+        return true;
+    }
+};
+
+// Makes a keyword table from a list of keywords, e.g.
+//     static constexpr auto Keywords = MakeKeywordTable<Keyword>({ { "if", Keyword::If }, { "else", Keyword::Else } });
+template<typename Enum, KeywordCase Case = KeywordCase::Insensitive, std::size_t NumKeywords>
+constexpr KeywordTable<Enum, NumKeywords, Case> MakeKeywordTable(const KeywordEntry<Enum> (&keywords)[NumKeywords])
+{
+    return KeywordTable<Enum, NumKeywords, Case>(keywords);
+}
+
+} // namespace parser
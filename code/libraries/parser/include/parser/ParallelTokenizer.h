@@ -0,0 +1,257 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <string_view>
+#include <vector>
+#include "parser/FileTable.h"
+#include "parser/ThreadPool.h"
+#include "parser/Tokenizer.h"
+#include "parser/TokenizerRuleSet.h"
+#include "parser/TokenStream.h"
+
+namespace parser {
+
+// Lexes a large caller owned source buffer on multiple threads. The result is identical to Tokenize.
+// The buffer is split into chunks that start after a newline, and every chunk is lexed on its own, assuming a token
+// starts at the beginning of the chunk. That assumption is wrong when a chunk starts inside a token that spans lines,
+// such as a string or comment. Joining the chunks therefore checks where the last token of the previous chunk ends.
+// As the tokenizer keeps no state between tokens, lexing from the same offset always gives the same tokens, so the
+// tokens of a chunk are used from the first one starting at that offset. Until there is such a token, the source is
+// lexed again sequentially.
+// The chunks are lexed on a thread pool, by default the shared ThreadPool::Default(), and on the calling thread.
+template<typename UnderlyingType>
+class ParallelTokenizer
+{
+public:
+    static constexpr std::size_t DefaultMinChunkSize = 1024 * 1024;
+
+private:
+    struct Chunk
+    {
+        std::size_t begin;
+        std::size_t end;
+        TokenStream<UnderlyingType> tokens;
+    };
+
+    // State shared with the pool tasks, which may start after lexing is done when the calling thread lexed their chunks
+    struct LexState
+    {
+        const TokenizerRuleSet<UnderlyingType>* ruleSet;
+        std::vector<Chunk>* chunks;
+        FileId fileId;
+        std::atomic<std::size_t> nextChunk;
+        std::vector<std::exception_ptr> errors;
+        std::mutex mutex;
+        std::condition_variable done;
+        std::size_t remainingChunks;
+    };
+
+    const TokenizerRuleSet<UnderlyingType>& m_ruleSet;
+    ThreadPool& m_pool;
+    std::size_t m_numThreads;
+    std::size_t m_minChunkSize;
+
+public:
+    // Lexes on the shared pool, with at most numThreads threads at once. With numThreads 0, all threads of the pool
+    // are used.
+    explicit ParallelTokenizer(const TokenizerRuleSet<UnderlyingType>& ruleSet, std::size_t numThreads = 0, std::size_t minChunkSize = DefaultMinChunkSize)
+        : ParallelTokenizer(ruleSet, ThreadPool::Default(), numThreads, minChunkSize)
+    {
+    }
+    ParallelTokenizer(const TokenizerRuleSet<UnderlyingType>& ruleSet, ThreadPool& pool, std::size_t numThreads = 0, std::size_t minChunkSize = DefaultMinChunkSize)
+        : m_ruleSet(ruleSet)
+        , m_pool(pool)
+        , m_numThreads{ (numThreads != 0) ? numThreads : pool.NumThreads() }
+        , m_minChunkSize{ std::max(minChunkSize, std::size_t{ 1 }) }
+    {
+    }
+
+    std::size_t NumThreads() const { return m_numThreads; }
+    std::size_t MinChunkSize() const { return m_minChunkSize; }
+
+    TokenStream<UnderlyingType> Tokenize(const std::filesystem::path& compilationUnit, std::string_view source) const;
+
+private:
+    std::vector<Chunk> SplitChunks(std::string_view source, FileId fileId) const;
+    void LexChunks(std::vector<Chunk>& chunks, FileId fileId) const;
+    static void LexNextChunks(LexState& state);
+    static void LexRange(Tokenizer<UnderlyingType>& tokenizer, std::size_t begin, std::size_t end, TokenStream<UnderlyingType>& tokens);
+    TokenStream<UnderlyingType> JoinChunks(const std::vector<Chunk>& chunks, std::string_view source, FileId fileId) const;
+};
+
+template<typename UnderlyingType>
+TokenStream<UnderlyingType> ParallelTokenizer<UnderlyingType>::Tokenize(const std::filesystem::path& compilationUnit, std::string_view source) const
+{
+    auto fileId = FileTable::Register(compilationUnit, source);
+    auto chunks = SplitChunks(source, fileId);
+    if (chunks.size() <= 1)
+    {
+        Tokenizer<UnderlyingType> tokenizer(m_ruleSet, fileId, source);
+        return tokenizer.Tokenize();
+    }
+    LexChunks(chunks, fileId);
+    return JoinChunks(chunks, source, fileId);
+}
+
+template<typename UnderlyingType>
+std::vector<typename ParallelTokenizer<UnderlyingType>::Chunk> ParallelTokenizer<UnderlyingType>::SplitChunks(std::string_view source, FileId fileId) const
+{
+    std::vector<Chunk> chunks;
+    // A few chunks per thread evens out chunks that are slower to lex
+    auto numChunks = std::min(m_numThreads * 4, source.size() / m_minChunkSize);
+    if ((m_numThreads <= 1) || (numChunks <= 1))
+        return chunks;
+    auto chunkSize = source.size() / numChunks;
+    std::size_t begin{};
+    while (begin < source.size())
+    {
+        auto end = source.size();
+        if (source.size() - begin > chunkSize + chunkSize / 2)
+        {
+            auto newLine = source.find('\n', begin + chunkSize);
+            if (newLine != std::string_view::npos)
+                end = newLine + 1;
+        }
+        chunks.push_back(Chunk{ begin, end, TokenStream<UnderlyingType>(source, fileId) });
+        begin = end;
+    }
+    return chunks;
+}
+
+template<typename UnderlyingType>
+void ParallelTokenizer<UnderlyingType>::LexChunks(std::vector<Chunk>& chunks, FileId fileId) const
+{
+    auto state = std::make_shared<LexState>();
+    state->ruleSet = &m_ruleSet;
+    state->chunks = &chunks;
+    state->fileId = fileId;
+    state->nextChunk = 0;
+    state->errors.resize(chunks.size());
+    state->remainingChunks = chunks.size();
+
+    // The calling thread lexes chunks as well, so lexing also completes when all threads of the pool are busy
+    auto numTasks = std::min(m_numThreads, chunks.size());
+    for (std::size_t index = 1; index < numTasks; ++index)
+    {
+        m_pool.Submit([state]() { LexNextChunks(*state); });
+    }
+    LexNextChunks(*state);
+    {
+        std::unique_lock<std::mutex> lock(state->mutex);
+        state->done.wait(lock, [&state]() { return state->remainingChunks == 0; });
+    }
+    for (auto const& error : state->errors)
+    {
+        if (error)
+            std::rethrow_exception(error);
+    }
+}
+
+template<typename UnderlyingType>
+void ParallelTokenizer<UnderlyingType>::LexNextChunks(LexState& state)
+{
+    auto numChunks = state.errors.size();
+    for (auto index = state.nextChunk++; index < numChunks; index = state.nextChunk++)
+    {
+        auto& chunk = (*state.chunks)[index];
+        try
+        {
+            Tokenizer<UnderlyingType> tokenizer(*state.ruleSet, state.fileId, chunk.tokens.Source());
+            LexRange(tokenizer, chunk.begin, chunk.end, chunk.tokens);
+        }
+        catch (...)
+        {
+            state.errors[index] = std::current_exception();
+        }
+        std::lock_guard<std::mutex> lock(state.mutex);
+        if (--state.remainingChunks == 0)
+            state.done.notify_all();
+    }
+}
+
+// Reads the tokens starting in the range [begin, end). The last token may extend beyond the end of the range.
+template<typename UnderlyingType>
+void ParallelTokenizer<UnderlyingType>::LexRange(Tokenizer<UnderlyingType>& tokenizer, std::size_t begin, std::size_t end, TokenStream<UnderlyingType>& tokens)
+{
+    tokenizer.Seek(begin);
+    for (auto view = tokenizer.GetTokenView(); !view.IsNull(); view = tokenizer.GetTokenView())
+    {
+        tokens.Add(view);
+        if (view.Offset() + view.Length() >= end)
+            break;
+    }
+}
+
+template<typename UnderlyingType>
+TokenStream<UnderlyingType> ParallelTokenizer<UnderlyingType>::JoinChunks(const std::vector<Chunk>& chunks, std::string_view source, FileId fileId) const
+{
+    TokenStream<UnderlyingType> result(source, fileId);
+    std::size_t totalSize{};
+    for (auto const& chunk : chunks)
+    {
+        totalSize += chunk.tokens.Size();
+    }
+    result.Reserve(totalSize);
+
+    Tokenizer<UnderlyingType> tokenizer(m_ruleSet, fileId, source);
+    // Offset at which the next token starts when lexing sequentially
+    std::size_t offset{};
+    for (auto const& chunk : chunks)
+    {
+        if (offset >= chunk.end)
+            continue;
+        auto const& offsets = chunk.tokens.Offsets();
+        auto first = static_cast<std::size_t>(std::lower_bound(offsets.begin(), offsets.end(), offset) - offsets.begin());
+        while ((first < offsets.size()) && (offsets[first] != offset))
+        {
+            // Out of step with the tokens of this chunk, so read one token sequentially and look for the next token
+            tokenizer.Seek(offset);
+            auto view = tokenizer.GetTokenView();
+            if (view.IsNull())
+                return result;
+            result.Add(view);
+            offset = view.Offset() + view.Length();
+            while ((first < offsets.size()) && (offsets[first] < offset))
+                ++first;
+        }
+        if (first >= offsets.size())
+        {
+            // No token of this chunk is left in step, so continue sequentially up to the end of the chunk
+            TokenStream<UnderlyingType> tokens(source, fileId);
+            if (offset < chunk.end)
+                LexRange(tokenizer, offset, chunk.end, tokens);
+            result.Append(tokens);
+            if (!tokens.IsEmpty())
+                offset = tokens.Offset(tokens.Size() - 1) + tokens.Length(tokens.Size() - 1);
+            continue;
+        }
+        result.Append(chunk.tokens, first);
+        offset = chunk.tokens.Offset(offsets.size() - 1) + chunk.tokens.Length(offsets.size() - 1);
+    }
+    return result;
+}
+
+// Lexes a caller owned source buffer at once, using multiple threads for large buffers. The token stream refers to
+// the buffer, which must outlive it.
+template<typename UnderlyingType>
+TokenStream<UnderlyingType> TokenizeParallel(const TokenizerRuleSet<UnderlyingType>& ruleSet, const std::filesystem::path& compilationUnit, std::string_view source,
+                                             std::size_t numThreads = 0, std::size_t minChunkSize = ParallelTokenizer<UnderlyingType>::DefaultMinChunkSize)
+{
+    return ParallelTokenizer<UnderlyingType>(ruleSet, numThreads, minChunkSize).Tokenize(compilationUnit, source);
+}
+
+// Same as TokenizeParallel, lexing the chunks on the given pool
+template<typename UnderlyingType>
+TokenStream<UnderlyingType> TokenizeParallel(const TokenizerRuleSet<UnderlyingType>& ruleSet, ThreadPool& pool, const std::filesystem::path& compilationUnit,
+                                             std::string_view source, std::size_t minChunkSize = ParallelTokenizer<UnderlyingType>::DefaultMinChunkSize)
+{
+    return ParallelTokenizer<UnderlyingType>(ruleSet, pool, 0, minChunkSize).Tokenize(compilationUnit, source);
+}
+
+} // namespace parser
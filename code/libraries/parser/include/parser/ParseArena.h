@@ -0,0 +1,92 @@
+#pragma once
+
+#include <cstddef>
+#include <memory_resource>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+namespace parser {
+
+// Memory for the duration of a parse session.
+// Tokens, source text, temporary strings and other short-lived parse structures are allocated by bumping a pointer
+// in large blocks, and are all freed at once when the arena is released or destroyed, instead of one by one.
+// Resource() can be passed to std::pmr containers, which then allocate from the arena. Deallocating separate
+// elements does not free any memory, so containers that grow and shrink repeatedly should not use the arena.
+// An arena is not thread safe, each thread needs its own arena.
+class ParseArena
+{
+public:
+    static constexpr std::size_t DefaultBlockSize = 64 * 1024;
+
+private:
+    // Upstream of the arena, keeping track of the memory taken from the heap
+    class HeapResource
+        : public std::pmr::memory_resource
+    {
+    private:
+        std::size_t m_bytesReserved;
+
+    public:
+        HeapResource();
+
+        std::size_t BytesReserved() const { return m_bytesReserved; }
+
+    private:
+        void* do_allocate(std::size_t bytes, std::size_t alignment) override;
+        void do_deallocate(void* pointer, std::size_t bytes, std::size_t alignment) override;
+        bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override;
+    };
+    // Objects created with Create that need to be destroyed on release, as a list allocated from the arena itself
+    struct Destructor
+    {
+        void (*destroy)(void* object);
+        void* object;
+        Destructor* next;
+    };
+
+    HeapResource m_heap;
+    std::pmr::monotonic_buffer_resource m_resource;
+    Destructor* m_destructors;
+
+public:
+    explicit ParseArena(std::size_t blockSize = DefaultBlockSize);
+    ParseArena(const ParseArena&) = delete;
+    ParseArena& operator = (const ParseArena&) = delete;
+    ~ParseArena();
+
+    std::pmr::memory_resource* Resource() { return &m_resource; }
+
+    void* Allocate(std::size_t bytes, std::size_t alignment = alignof(std::max_align_t));
+    // Copies text into the arena, for strings that only need to live as long as the parse
+    std::string_view CopyString(std::string_view text);
+    // Creates an object in the arena, which is destroyed when the arena is released. If the object is a std::pmr
+    // container, or holds them, they allocate from the arena as well.
+    template<typename Object, typename... Arguments>
+    Object* Create(Arguments&&... arguments);
+
+    // Destroys all created objects, and returns all memory to the heap
+    void Release();
+
+    // Number of bytes the arena holds from the heap
+    std::size_t BytesReserved() const { return m_heap.BytesReserved(); }
+};
+
+template<typename Object, typename... Arguments>
+Object* ParseArena::Create(Arguments&&... arguments)
+{
+    auto object = static_cast<Object*>(Allocate(sizeof(Object), alignof(Object)));
+    std::pmr::polymorphic_allocator<Object> allocator(&m_resource);
+    allocator.construct(object, std::forward<Arguments>(arguments)...);
+    if constexpr (!std::is_trivially_destructible_v<Object>)
+    {
+        auto destructor = static_cast<Destructor*>(Allocate(sizeof(Destructor), alignof(Destructor)));
+        destructor->destroy = [](void* pointer) { static_cast<Object*>(pointer)->~Object(); };
+        destructor->object = object;
+        destructor->next = m_destructors;
+        m_destructors = destructor;
+    }
+    return object;
+}
+
+} // namespace parser
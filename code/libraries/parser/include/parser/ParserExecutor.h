@@ -4,54 +4,101 @@
 #include <memory>
 #include "parser/IParserCallback.h"
 #include "parser/ITokenizer.h"
+#include "parser/PipelinedTokenizer.h"
+#include "parser/TokenTypeSet.h"
 
 namespace parser {
 
+enum class ParseMode
+{
+    // Tokens are read when the parser needs them
+    Sequential,
+    // Tokens are read ahead on a separate thread, see PipelinedTokenizer
+    Pipelined,
+    // Compilation units included by the parsed unit are read and lexed ahead on a thread pool, see ThreadPool
+    Parallel,
+};
+
+enum class ErrorMode
+{
+    // Parsing stops at the first error
+    Stop,
+    // Parsing continues after an error, from where the callback resynchronizes in OnRecover
+    Recover,
+};
+
 template<typename UnderlyingType>
 class ParserExecutor
 {
 private:
     IParserCallback<UnderlyingType>& m_parserCallback;
-    std::set<TokenType<UnderlyingType>> m_skipWhitespaceTokens;
+    TokenTypeSet<UnderlyingType> m_skipWhitespaceTokens;
+    ErrorMode m_errorMode;
 
 public:
-    ParserExecutor(IParserCallback<UnderlyingType>& parserCallback, std::set<TokenType<UnderlyingType>> skipWhiteSpaceTokens)
+    ParserExecutor(IParserCallback<UnderlyingType>& parserCallback, const TokenTypeSet<UnderlyingType>& skipWhiteSpaceTokens,
+                   ErrorMode errorMode = ErrorMode::Stop)
         : m_parserCallback{ parserCallback }
         , m_skipWhitespaceTokens{ skipWhiteSpaceTokens }
+        , m_errorMode{ errorMode }
     {}
+    // Returns false if any error was found, also when parsing continued after it
     bool Parse(ITokenizer<UnderlyingType>& tokenizer)
     {
         bool result{ true };
         bool done{ false };
-        while (result && !done)
+        while (!done)
         {
             Token token = tokenizer.GetToken();
             if (token.IsNull())
             {
-                result = m_parserCallback.OnNoMoreToken(tokenizer.GetCurrentLocation());
+                result = m_parserCallback.OnNoMoreToken(tokenizer.GetCurrentLocation()) && result;
                 break;
             }
             if (token.IsInvalid())
             {
                 m_parserCallback.OnParseError(token);
                 result = false;
-                break;
+                if (!Recover(tokenizer))
+                    break;
+                continue;
             }
-            if (m_skipWhitespaceTokens.find(token.Type()) != m_skipWhitespaceTokens.end())
+            if (m_skipWhitespaceTokens.Contains(token.Type()))
             {
                 m_parserCallback.OnSkipToken(token);
                 continue;
             }
-            if (!m_parserCallback.OnToken(token, done))
+            bool handled = m_parserCallback.OnToken(token, done);
+            if (!handled)
             {
                 m_parserCallback.OnParseError(token);
                 result = false;
             }
             if (done)
                 tokenizer.UngetToken(token);
+            else if (!handled && !Recover(tokenizer))
+                break;
         }
         return result;
     }
+    // Parses in the selected mode. A callback that reads tokens itself must read them from the tokenizer that is
+    // parsed, so such a callback creates the PipelinedTokenizer itself instead.
+    template<typename SourceTokenizer>
+    bool Parse(SourceTokenizer& tokenizer, ParseMode mode)
+    {
+        if (mode == ParseMode::Pipelined)
+        {
+            PipelinedTokenizer<UnderlyingType, SourceTokenizer> pipelinedTokenizer(tokenizer);
+            return Parse(pipelinedTokenizer);
+        }
+        return Parse(tokenizer);
+    }
+
+private:
+    bool Recover(ITokenizer<UnderlyingType>& tokenizer)
+    {
+        return (m_errorMode == ErrorMode::Recover) && m_parserCallback.OnRecover(tokenizer);
+    }
 };
 
 template<typename UnderlyingType>
@@ -0,0 +1,224 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+#include "parser/ITokenizer.h"
+#include "parser/SourceLocation.h"
+#include "parser/SPSCQueue.h"
+#include "parser/Token.h"
+#include "parser/Tokenizer.h"
+#include "parser/TokenView.h"
+
+namespace parser {
+
+// Reads the tokens of a tokenizer on a separate thread, so that lexing overlaps with handling the tokens.
+// A producer thread reads token views from the source tokenizer into a bounded SPSCQueue, and the consumer reads them
+// from the queue. Tokens pushed back with UngetToken are kept on the consumer side, and are read again first.
+// The source tokenizer reads its complete text before lexing, so the views stay valid and MakeToken only reads that
+// text. The source tokenizer is used by the producer thread only, until the pipelined tokenizer is destroyed.
+// Exceptions thrown while lexing are rethrown to the consumer when it reaches the end of the tokens.
+// A side finding the queue empty or full retries for a while, and then waits until the other side changes the queue.
+template<typename UnderlyingType, typename SourceTokenizer = Tokenizer<UnderlyingType>>
+class PipelinedTokenizer
+    : public ITokenizer<UnderlyingType>
+{
+public:
+    static constexpr int SpinCount = 64;
+
+private:
+    SourceTokenizer& m_source;
+    SPSCQueue<TokenView<UnderlyingType>> m_queue;
+    std::atomic<bool> m_stop;
+    // Set while the consumer waits for a token, or the producer for room in the queue
+    std::mutex m_mutex;
+    std::condition_variable m_queueChanged;
+    std::atomic<bool> m_consumerWaiting;
+    std::atomic<bool> m_producerWaiting;
+    // Written by the producer before it queues the final null view
+    std::exception_ptr m_error;
+    SourceLocation m_endLocation;
+    std::vector<Token<UnderlyingType>> m_ungotTokens;
+    Token<UnderlyingType> m_restoredToken;
+    TokenView<UnderlyingType> m_lastView;
+    bool m_atEnd;
+    std::thread m_producer;
+
+public:
+    explicit PipelinedTokenizer(SourceTokenizer& source, std::size_t queueCapacity = SPSCQueue<TokenView<UnderlyingType>>::DefaultCapacity)
+        : m_source(source)
+        , m_queue(queueCapacity)
+        , m_stop{}
+        , m_mutex{}
+        , m_queueChanged{}
+        , m_consumerWaiting{}
+        , m_producerWaiting{}
+        , m_error{}
+        , m_endLocation{}
+        , m_ungotTokens{}
+        , m_restoredToken{}
+        , m_lastView{}
+        , m_atEnd{}
+        , m_producer{}
+    {
+        m_producer = std::thread([this]() { Produce(); });
+    }
+    PipelinedTokenizer(const PipelinedTokenizer&) = delete;
+    PipelinedTokenizer& operator = (const PipelinedTokenizer&) = delete;
+    ~PipelinedTokenizer()
+    {
+        m_stop = true;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+        }
+        m_queueChanged.notify_all();
+        m_producer.join();
+    }
+
+    Token<UnderlyingType> GetToken() override
+    {
+        return MakeToken(GetTokenView());
+    }
+    TokenView<UnderlyingType> GetTokenView();
+    Token<UnderlyingType> MakeToken(const TokenView<UnderlyingType>& view) const;
+    void UngetToken(const Token<UnderlyingType>& token) override
+    {
+        m_ungotTokens.push_back(token);
+    }
+    SourceLocation GetCurrentLocation() const override;
+    bool IsAtEnd() const override
+    {
+        return m_atEnd && m_ungotTokens.empty();
+    }
+
+private:
+    void Produce();
+    bool Push(const TokenView<UnderlyingType>& view);
+    template<typename Operation>
+    bool WaitFor(std::atomic<bool>& waiting, Operation tryOperation);
+    void NotifyQueueChanged(const std::atomic<bool>& waiting);
+};
+
+template<typename UnderlyingType, typename SourceTokenizer>
+TokenView<UnderlyingType> PipelinedTokenizer<UnderlyingType, SourceTokenizer>::GetTokenView()
+{
+    if (!m_ungotTokens.empty())
+    {
+        m_restoredToken = std::move(m_ungotTokens.back());
+        m_ungotTokens.pop_back();
+        return TokenView<UnderlyingType>(m_restoredToken.Type(), m_restoredToken.Value(), TokenView<UnderlyingType>::RestoredOffset);
+    }
+    if (m_atEnd)
+        return {};
+    TokenView<UnderlyingType> view;
+    WaitFor(m_consumerWaiting, [this, &view]() { return m_queue.TryPop(view); });
+    NotifyQueueChanged(m_producerWaiting);
+    if (view.IsNull())
+    {
+        m_atEnd = true;
+        if (m_error)
+            std::rethrow_exception(std::exchange(m_error, nullptr));
+        return view;
+    }
+    m_lastView = view;
+    return view;
+}
+
+template<typename UnderlyingType, typename SourceTokenizer>
+Token<UnderlyingType> PipelinedTokenizer<UnderlyingType, SourceTokenizer>::MakeToken(const TokenView<UnderlyingType>& view) const
+{
+    if (view.IsRestored())
+        return m_restoredToken;
+    if (view.IsNull())
+        return {};
+    return m_source.MakeToken(view);
+}
+
+// Location after the last token read from the queue
+template<typename UnderlyingType, typename SourceTokenizer>
+SourceLocation PipelinedTokenizer<UnderlyingType, SourceTokenizer>::GetCurrentLocation() const
+{
+    if (m_atEnd)
+        return m_endLocation;
+    if (m_lastView.IsNull())
+        return {};
+    return m_source.MakeToken(m_lastView).EndLocation();
+}
+
+template<typename UnderlyingType, typename SourceTokenizer>
+void PipelinedTokenizer<UnderlyingType, SourceTokenizer>::Produce()
+{
+    try
+    {
+        for (auto view = m_source.GetTokenView(); !view.IsNull(); view = m_source.GetTokenView())
+        {
+            if (!Push(view))
+                return;
+        }
+        m_endLocation = m_source.GetCurrentLocation();
+    }
+    catch (...)
+    {
+        m_error = std::current_exception();
+    }
+    Push({});
+}
+
+// Waits for room in the queue, unless the consumer is gone
+template<typename UnderlyingType, typename SourceTokenizer>
+bool PipelinedTokenizer<UnderlyingType, SourceTokenizer>::Push(const TokenView<UnderlyingType>& view)
+{
+    if (!WaitFor(m_producerWaiting, [this, &view]() { return m_queue.TryPush(view); }))
+        return false;
+    NotifyQueueChanged(m_consumerWaiting);
+    return true;
+}
+
+// Retries the queue operation up to SpinCount times, then blocks until the other side changes the queue.
+// Returns false if the tokenizer is destroyed while waiting.
+template<typename UnderlyingType, typename SourceTokenizer>
+template<typename Operation>
+bool PipelinedTokenizer<UnderlyingType, SourceTokenizer>::WaitFor(std::atomic<bool>& waiting, Operation tryOperation)
+{
+    for (int spin = 0; spin < SpinCount; ++spin)
+    {
+        if (tryOperation())
+            return true;
+    }
+    std::unique_lock<std::mutex> lock(m_mutex);
+    waiting.store(true, std::memory_order_relaxed);
+    // Pairs with the fence in NotifyQueueChanged: either this side sees the change, or the other side sees it waiting
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    bool result = true;
+    while (!tryOperation())
+    {
+        if (m_stop.load(std::memory_order_relaxed))
+        {
+            result = false;
+            break;
+        }
+        m_queueChanged.wait(lock);
+    }
+    waiting.store(false, std::memory_order_relaxed);
+    return result;
+}
+
+// Wakes the other side if it waits for the queue. The waiting side holds the mutex until it waits, so taking the
+// mutex here makes sure the notification is not lost.
+template<typename UnderlyingType, typename SourceTokenizer>
+void PipelinedTokenizer<UnderlyingType, SourceTokenizer>::NotifyQueueChanged(const std::atomic<bool>& waiting)
+{
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (!waiting.load(std::memory_order_relaxed))
+        return;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+    }
+    m_queueChanged.notify_all();
+}
+
+} // namespace parser
@@ -2,29 +2,47 @@
 
 #include<filesystem>
 #include <iostream>
+#include <memory_resource>
+#include <string_view>
 #include <vector>
 #include "SourceLocation.h"
 
 namespace parser {
 
+// Character reader for a compilation unit.
+// The input is either a caller owned contiguous buffer, which must outlive the reader, or a stream, which is read
+// into a buffer owned by the reader, allocated from a memory resource. In both cases the source text stays in place for the lifetime of the reader,
+// the position is an offset into it, and restoring characters rewinds the offset. The text is registered with the
+// FileTable, so locations are an offset of which line and column are computed when requested.
 class Reader
 {
 private:
-    std::filesystem::path m_unitPath;
-    std::istream & m_stream;
-    std::string m_buffer;
+    std::pmr::string m_streamData;
+    std::string_view m_source;
+    std::size_t m_offset;
     bool m_endOfBuffer;
-    SourceLocation m_currentLocation;
+    FileId m_fileId;
+    bool m_haveLocation;
 
 public:
-    Reader(const std::filesystem::path& unitPath, std::istream& stream);
+    Reader(const std::filesystem::path& unitPath, std::istream& stream, std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+    Reader(const std::filesystem::path& unitPath, std::string_view source);
+    // Reader on a caller owned buffer that is already registered with the FileTable
+    Reader(FileId fileId, std::string_view source);
+    Reader(const Reader&) = delete;
+    Reader& operator = (const Reader&) = delete;
+
     bool GetChar(char & ch);
     void RestoreChars(const std::string& restoreBuffer, const SourceLocation& restoreLocation);
-    const SourceLocation GetLocation() const { return m_currentLocation; }
+    void Rewind(std::size_t numChars);
+    void Seek(std::size_t offset);
+    const SourceLocation GetLocation() const { return GetLocation(m_offset); }
+    const SourceLocation GetLocation(std::size_t offset) const;
+    std::size_t GetOffset() const { return m_offset; }
+    FileId GetFileId() const { return m_fileId; }
+    std::size_t GetSize() const { return m_source.size(); }
+    std::string_view GetText(std::size_t offset, std::size_t length) const { return m_source.substr(offset, length); }
     bool EndOfStream() const;
-
-private:
-    void Advance(char c);
 };
 
-} // namespace parser
\ No newline at end of file
+} // namespace parser
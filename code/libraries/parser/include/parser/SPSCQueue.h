@@ -0,0 +1,77 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <stdexcept>
+#include <vector>
+
+namespace parser {
+
+// Bounded queue between exactly one producer thread and one consumer thread, without locks.
+// The elements are kept in a ring buffer with a power of two capacity. The producer only writes the tail index and
+// the consumer only writes the head index, each publishing the elements it wrote or read with release ordering.
+// Both keep a copy of the other's index, so the shared indices are only read when the queue seems full or empty.
+template<typename Element>
+class SPSCQueue
+{
+public:
+    static constexpr std::size_t DefaultCapacity = 1024;
+    static constexpr std::size_t CacheLineSize = 64;
+
+private:
+    std::vector<Element> m_elements;
+    std::size_t m_mask;
+    alignas(CacheLineSize) std::atomic<std::size_t> m_head;
+    std::size_t m_cachedTail;
+    alignas(CacheLineSize) std::atomic<std::size_t> m_tail;
+    std::size_t m_cachedHead;
+
+public:
+    // The capacity must be a power of two
+    explicit SPSCQueue(std::size_t capacity = DefaultCapacity)
+        : m_elements(capacity)
+        , m_mask{ capacity - 1 }
+        , m_head{}
+        , m_cachedTail{}
+        , m_tail{}
+        , m_cachedHead{}
+    {
+        if ((capacity == 0) || ((capacity & (capacity - 1)) != 0))
+            throw std::invalid_argument("Queue capacity must be a power of two");
+    }
+    SPSCQueue(const SPSCQueue&) = delete;
+    SPSCQueue& operator = (const SPSCQueue&) = delete;
+
+    std::size_t Capacity() const { return m_elements.size(); }
+
+    // Called by the producer only. Returns false if the queue is full.
+    bool TryPush(const Element& element)
+    {
+        auto tail = m_tail.load(std::memory_order_relaxed);
+        if (tail - m_cachedHead == m_elements.size())
+        {
+            m_cachedHead = m_head.load(std::memory_order_acquire);
+            if (tail - m_cachedHead == m_elements.size())
+                return false;
+        }
+        m_elements[tail & m_mask] = element;
+        m_tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+    // Called by the consumer only. Returns false if the queue is empty.
+    bool TryPop(Element& element)
+    {
+        auto head = m_head.load(std::memory_order_relaxed);
+        if (head == m_cachedTail)
+        {
+            m_cachedTail = m_tail.load(std::memory_order_acquire);
+            if (head == m_cachedTail)
+                return false;
+        }
+        element = m_elements[head & m_mask];
+        m_head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+};
+
+} // namespace parser
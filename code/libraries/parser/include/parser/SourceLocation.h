@@ -3,34 +3,51 @@
 #include<filesystem>
 #include <iostream>
 #include <vector>
+#include "parser/FileTable.h"
 
 namespace parser {
 
+// Location in a compilation unit, packed into a file id and a position.
+// Locations handed out by the reader store the offset into the unit text, and resolve line and column through the
+// line index in the FileTable. Locations constructed from an explicit line and column store those instead, packed
+// for a line up to MaxLine and a column up to MaxColumn. Larger lines and columns, and offsets that do not fit in
+// 31 bits, are kept in a shared overflow table, so they are reported unchanged.
 class SourceLocation
 {
+public:
+    static constexpr int MaxLine = (1 << 20) - 1;
+    static constexpr int MaxColumn = (1 << 11) - 2;
+    static constexpr std::uint32_t MaxOffset = 0x7FFFFFFFu;
+
 private:
-    std::filesystem::path m_unitPath;
-    int m_line;
-    int m_col;
+    FileId m_fileId;
+    std::uint32_t m_position;
 
 public:
     SourceLocation();
     SourceLocation(const std::filesystem::path& unitPath);
     SourceLocation(const std::filesystem::path& unitPath, int line, int column);
+    SourceLocation(FileId fileId, std::uint32_t offset);
 
     void NextCol();
     void NextLine();
     void ResetLine();
-    const std::filesystem::path& UnitPath() const { return m_unitPath; }
-    int Line() const { return m_line; }
-    int Column() const { return m_col; }
+    const std::filesystem::path& UnitPath() const;
+    FileId GetFileId() const { return m_fileId; }
+    bool HasOffset() const;
+    std::uint32_t Offset() const;
+    int Line() const;
+    int Column() const;
     bool IsValid() const;
 
     std::string Serialize() const;
+
+private:
+    void SetLineAndColumn(int line, int column);
 };
 
 bool operator ==(const SourceLocation& lhs, const SourceLocation& rhs);
 bool operator !=(const SourceLocation& lhs, const SourceLocation& rhs);
 std::ostream& operator << (std::ostream& stream, const SourceLocation& value);
 
-} // namespace parser
\ No newline at end of file
+} // namespace parser
@@ -78,13 +78,16 @@ using StateMachineRules = std::vector<StateMachineRule<State, Stimulus, Data>>;
 template<class State, class Stimulus, class Data>
 using HandleInputCallback = std::function<void(State from, State to, Stimulus inputs, Data data)>;
 
+// General state machine for any ordered state and stimulus type.
+// For enumerated states and stimuli, TableStateMachine looks up transitions in a dense table instead.
 template<class State, class Stimulus, class Data>
 class StateMachine
 {
 private:
 	StateMachineRules<State, Stimulus, Data> m_rules;
 	State m_state;
-    std::map<StateStimulusPair<State, Stimulus>, StateMachineRule<State, Stimulus, Data>> m_lookupMap;
+    // Index into m_rules for every state and stimulus
+    std::map<StateStimulusPair<State, Stimulus>, std::size_t> m_lookupMap;
     HandleInputCallback<State, Stimulus, Data> m_handleInputCallback;
 
 public:
@@ -116,7 +119,7 @@ void StateMachine<State, Stimulus, Data>::SetupRules(const StateMachineRules<Sta
         m_rules.push_back(rule);
         for (auto const& stimulus : rule.stimuli)
         {
-            m_lookupMap.emplace(StateStimulusPair<State, Stimulus>(rule.from, stimulus), rule);
+            m_lookupMap.emplace(StateStimulusPair<State, Stimulus>(rule.from, stimulus), m_rules.size() - 1);
         }
     }
 }
@@ -147,9 +150,10 @@ bool StateMachine<State, Stimulus, Data>::HandleInput(Stimulus input, Data data)
     {
         return false;
     }
-    bool result = it->second.RunAction(input, m_state, data);
+    auto& rule = m_rules[it->second];
+    bool result = rule.RunAction(input, m_state, data);
     if (m_handleInputCallback)
-        m_handleInputCallback(it->second.from, m_state, input, data);
+        m_handleInputCallback(rule.from, m_state, input, data);
     return result;
 }
 
@@ -0,0 +1,387 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <string_view>
+#include "parser/ContentHash.h"
+#include "parser/FileTable.h"
+#include "parser/TokenizerRule.h"
+#include "parser/TokenStream.h"
+#include "parser/TokenType.h"
+#include "parser/TokenView.h"
+
+namespace parser {
+
+// Set of byte values that can be built in constant expressions
+class CharacterClass
+{
+private:
+    std::array<std::uint64_t, 4> m_bits;
+
+public:
+    constexpr CharacterClass()
+        : m_bits{}
+    {
+    }
+
+    static constexpr CharacterClass Of(std::string_view characters)
+    {
+        CharacterClass result;
+        for (auto ch : characters)
+        {
+            result.Add(ch);
+        }
+        return result;
+    }
+    static constexpr CharacterClass Range(char first, char last)
+    {
+        CharacterClass result;
+        for (auto value = static_cast<unsigned>(static_cast<unsigned char>(first)); value <= static_cast<unsigned char>(last); ++value)
+        {
+            result.Add(static_cast<char>(value));
+        }
+        return result;
+    }
+
+    constexpr void Add(char ch)
+    {
+        auto value = static_cast<unsigned char>(ch);
+        m_bits[value / 64] |= std::uint64_t{ 1 } << (value % 64);
+    }
+    constexpr bool Contains(char ch) const
+    {
+        auto value = static_cast<unsigned char>(ch);
+        return (m_bits[value / 64] & (std::uint64_t{ 1 } << (value % 64))) != 0;
+    }
+    // Bracket expression for a regular expression, with every character as a hexadecimal escape
+    std::string Pattern(bool negate = false) const
+    {
+        std::string result = negate ? "[^" : "[";
+        for (unsigned value = 0; value < 256; ++value)
+        {
+            if (Contains(static_cast<char>(value)))
+                result += HexEscape(static_cast<char>(value));
+        }
+        return result + "]";
+    }
+    static std::string HexEscape(char ch)
+    {
+        static const char Digits[] = "0123456789ABCDEF";
+        auto value = static_cast<unsigned char>(ch);
+        return std::string{ '\\', 'x', Digits[value / 16], Digits[value % 16] };
+    }
+    constexpr CharacterClass operator | (const CharacterClass& other) const
+    {
+        CharacterClass result;
+        for (std::size_t index = 0; index < m_bits.size(); ++index)
+        {
+            result.m_bits[index] = m_bits[index] | other.m_bits[index];
+        }
+        return result;
+    }
+};
+
+enum class TerminalKind
+{
+    Literal,
+    Repeat,
+    Word,
+    Quoted,
+    LineComment,
+    Custom,
+};
+
+// Returns the length of the longest match at the start of the text, or 0 if there is none
+using TerminalMatchFunction = std::size_t (*)(std::string_view text);
+
+// Terminal of a grammar known at compile time. Each kind corresponds to a common form of tokenizer rule:
+//   Literal      fixed text, optionally case insensitive                       "\\(", "[Nn][Uu][Ll][Ll]"
+//   Repeat       one or more characters of a class                             "[ \t]+"
+//   Word         a character of one class, followed by characters of another   "[_a-zA-Z][_a-zA-Z0-9]*"
+//   Quoted       text between quotes, with escaped characters                  "\"(?:[^\"\\\\]|\\\\.)*\""
+//   LineComment  a prefix, followed by the rest of the line                    "#.*"
+//   Custom       a match function, for anything else, with a regular expression that matches the same text
+// A grammar is declared once as static terminals. Pattern() gives the equivalent regular expression of a terminal,
+// from which MakeTokenizerRules builds the rules for a TokenizerRuleSet, used for lexing streams.
+template<typename UnderlyingType>
+struct StaticTerminal
+{
+    TerminalKind kind;
+    TokenType<UnderlyingType> type;
+    std::string_view text;
+    bool caseInsensitive;
+    CharacterClass first;
+    CharacterClass rest;
+    char escape;
+    TerminalMatchFunction match;
+
+    static constexpr StaticTerminal Literal(std::string_view text, UnderlyingType type, bool caseInsensitive = false)
+    {
+        CharacterClass first;
+        first.Add(text[0]);
+        if (caseInsensitive)
+        {
+            first.Add(ToLower(text[0]));
+            first.Add(ToUpper(text[0]));
+        }
+        return StaticTerminal{ TerminalKind::Literal, type, text, caseInsensitive, first, {}, {}, nullptr };
+    }
+    static constexpr StaticTerminal Repeat(const CharacterClass& characters, UnderlyingType type)
+    {
+        return StaticTerminal{ TerminalKind::Repeat, type, {}, false, characters, characters, {}, nullptr };
+    }
+    static constexpr StaticTerminal Word(const CharacterClass& first, const CharacterClass& rest, UnderlyingType type)
+    {
+        return StaticTerminal{ TerminalKind::Word, type, {}, false, first, rest, {}, nullptr };
+    }
+    // The escape character escapes any character except a line end
+    static constexpr StaticTerminal Quoted(char quote, char escape, UnderlyingType type)
+    {
+        CharacterClass first;
+        first.Add(quote);
+        return StaticTerminal{ TerminalKind::Quoted, type, {}, false, first, {}, escape, nullptr };
+    }
+    static constexpr StaticTerminal LineComment(std::string_view prefix, UnderlyingType type)
+    {
+        return StaticTerminal{ TerminalKind::LineComment, type, prefix, false, CharacterClass::Of(prefix.substr(0, 1)), {}, {}, nullptr };
+    }
+    // The pattern is the regular expression used in a TokenizerRuleSet, it must match the same text as the function
+    static constexpr StaticTerminal Custom(const CharacterClass& first, TerminalMatchFunction match, std::string_view pattern, UnderlyingType type)
+    {
+        return StaticTerminal{ TerminalKind::Custom, type, pattern, false, first, {}, {}, match };
+    }
+
+    constexpr std::size_t Match(std::string_view input) const
+    {
+        if (input.empty() || !first.Contains(input[0]))
+            return 0;
+        switch (kind)
+        {
+        case TerminalKind::Literal:
+            return MatchLiteral(input);
+        case TerminalKind::Repeat:
+            return SkipClass(input, 0, rest);
+        case TerminalKind::Word:
+            return SkipClass(input, 1, rest);
+        case TerminalKind::Quoted:
+            return MatchQuoted(input);
+        case TerminalKind::LineComment:
+            return (input.substr(0, text.length()) == text) ? SkipLine(input, text.length()) : 0;
+        case TerminalKind::Custom:
+            return match(input);
+        }
+        return 0;
+    }
+
+    // Regular expression that matches the same text as the terminal
+    std::string Pattern() const
+    {
+        std::string result;
+        switch (kind)
+        {
+        case TerminalKind::Literal:
+            for (auto ch : text)
+            {
+                if (caseInsensitive && (ToLower(ch) != ToUpper(ch)))
+                    result += "[" + CharacterClass::HexEscape(ToLower(ch)) + CharacterClass::HexEscape(ToUpper(ch)) + "]";
+                else
+                    result += CharacterClass::HexEscape(ch);
+            }
+            return result;
+        case TerminalKind::Repeat:
+            return rest.Pattern() + "+";
+        case TerminalKind::Word:
+            return first.Pattern() + rest.Pattern() + "*";
+        case TerminalKind::Quoted:
+        {
+            auto quote = CharacterClass::HexEscape(QuoteCharacter());
+            auto escapeCharacter = CharacterClass::HexEscape(escape);
+            return quote + "(?:[^" + quote + escapeCharacter + "]|" + escapeCharacter + "[^\\n\\r])*" + quote;
+        }
+        case TerminalKind::LineComment:
+            for (auto ch : text)
+            {
+                result += CharacterClass::HexEscape(ch);
+            }
+            return result + "[^\\n\\r]*";
+        case TerminalKind::Custom:
+            return std::string(text);
+        }
+        return result;
+    }
+
+private:
+    constexpr char QuoteCharacter() const
+    {
+        for (unsigned value = 0; value < 256; ++value)
+        {
+            if (first.Contains(static_cast<char>(value)))
+                return static_cast<char>(value);
+        }
+        return {};
+    }
+    static constexpr char ToLower(char ch) { return ((ch >= 'A') && (ch <= 'Z')) ? static_cast<char>(ch - 'A' + 'a') : ch; }
+    static constexpr char ToUpper(char ch) { return ((ch >= 'a') && (ch <= 'z')) ? static_cast<char>(ch - 'a' + 'A') : ch; }
+    static constexpr bool IsLineEnd(char ch) { return (ch == '\n') || (ch == '\r'); }
+    static constexpr std::size_t SkipClass(std::string_view input, std::size_t index, const CharacterClass& characters)
+    {
+        while ((index < input.length()) && characters.Contains(input[index]))
+            ++index;
+        return index;
+    }
+    static constexpr std::size_t SkipLine(std::string_view input, std::size_t index)
+    {
+        while ((index < input.length()) && !IsLineEnd(input[index]))
+            ++index;
+        return index;
+    }
+    constexpr std::size_t MatchLiteral(std::string_view input) const
+    {
+        if (input.length() < text.length())
+            return 0;
+        for (std::size_t index = 0; index < text.length(); ++index)
+        {
+            if (caseInsensitive ? (ToLower(input[index]) != ToLower(text[index])) : (input[index] != text[index]))
+                return 0;
+        }
+        return text.length();
+    }
+    constexpr std::size_t MatchQuoted(std::string_view input) const
+    {
+        auto quote = input[0];
+        std::size_t index = 1;
+        while (index < input.length())
+        {
+            auto ch = input[index];
+            if (ch == quote)
+                return index + 1;
+            if (ch == escape)
+            {
+                if ((index + 1 >= input.length()) || IsLineEnd(input[index + 1]))
+                    return 0;
+                ++index;
+            }
+            ++index;
+        }
+        return 0;
+    }
+};
+
+// Lexer for a grammar of which the terminals are known at compile time, as an alternative to a TokenizerRuleSet
+// that needs no initialization at runtime:
+//
+//     constexpr StaticTerminal<Terminal> terminals[] = {
+//         StaticTerminal<Terminal>::Repeat(CharacterClass::Of(" \t"), Whitespace),
+//         StaticTerminal<Terminal>::Literal("(", ParenthesisOpen),
+//     };
+//     constexpr StaticGrammar grammar(terminals);
+//
+// The terminals that can start with a character are looked up in a table built at compile time. Like the
+// tokenizer, the longest match wins, and of terminals with the same match length, the first one. Text that no
+// terminal matches results in an invalid token up to the end of the input.
+template<typename UnderlyingType, std::size_t NumTerminals>
+class StaticGrammar
+{
+    static_assert(NumTerminals <= 64, "A static grammar supports at most 64 terminals");
+
+private:
+    std::array<StaticTerminal<UnderlyingType>, NumTerminals> m_terminals;
+    std::array<std::uint64_t, 256> m_candidates;
+
+public:
+    constexpr StaticGrammar(const StaticTerminal<UnderlyingType> (&terminals)[NumTerminals])
+        : m_terminals{}
+        , m_candidates{}
+    {
+        for (std::size_t index = 0; index < NumTerminals; ++index)
+        {
+            m_terminals[index] = terminals[index];
+            for (std::size_t ch = 0; ch < m_candidates.size(); ++ch)
+            {
+                if (terminals[index].first.Contains(static_cast<char>(ch)))
+                    m_candidates[ch] |= std::uint64_t{ 1 } << index;
+            }
+        }
+    }
+
+    constexpr std::size_t NumTerminalsInGrammar() const { return NumTerminals; }
+    constexpr const StaticTerminal<UnderlyingType>& Terminal(std::size_t index) const { return m_terminals[index]; }
+
+    // Returns the token at the start of the text, or a null token at the end of the text
+    constexpr TokenType<UnderlyingType> Match(std::string_view text, std::size_t& length) const
+    {
+        length = 0;
+        if (text.empty())
+            return {};
+        TokenType<UnderlyingType> result{};
+        auto candidates = m_candidates[static_cast<unsigned char>(text[0])];
+        for (std::size_t index = 0; candidates != 0; ++index, candidates >>= 1)
+        {
+            if ((candidates & 1) == 0)
+                continue;
+            auto matchLength = m_terminals[index].Match(text);
+            if (matchLength > length)
+            {
+                length = matchLength;
+                result = m_terminals[index].type;
+            }
+        }
+        if (length == 0)
+        {
+            length = text.length();
+            return TokenType<UnderlyingType>::InvalidToken;
+        }
+        return result;
+    }
+};
+
+// Rules for a TokenizerRuleSet that lexes the same tokens as the static grammar, in the same order, so that of
+// matches with the same length the first terminal wins in both
+template<typename UnderlyingType, std::size_t NumTerminals>
+TokenizerRules<UnderlyingType> MakeTokenizerRules(const StaticGrammar<UnderlyingType, NumTerminals>& grammar)
+{
+    TokenizerRules<UnderlyingType> rules;
+    for (std::size_t index = 0; index < grammar.NumTerminalsInGrammar(); ++index)
+    {
+        rules.emplace_back(grammar.Terminal(index).Pattern(), grammar.Terminal(index).type);
+    }
+    return rules;
+}
+
+// Identity of a grammar, for the keys of a TokenCache: a hash of the name of the lexer and of the type and pattern of
+// each terminal, so that tokens cached by one lexer are not used by another, nor after its terminals change
+template<typename UnderlyingType, std::size_t NumTerminals>
+std::uint64_t GrammarId(std::string_view lexerName, const StaticGrammar<UnderlyingType, NumTerminals>& grammar)
+{
+    std::string description(lexerName);
+    for (std::size_t index = 0; index < grammar.NumTerminalsInGrammar(); ++index)
+    {
+        description += '\n';
+        description += std::to_string(static_cast<long long>(grammar.Terminal(index).type.TypeCode()));
+        description += ' ';
+        description += grammar.Terminal(index).Pattern();
+    }
+    return ContentHash(description);
+}
+
+// Lexes a caller owned source buffer at once with a static grammar. The token stream refers to the buffer, which
+// must outlive it.
+template<typename UnderlyingType, std::size_t NumTerminals>
+TokenStream<UnderlyingType> Tokenize(const StaticGrammar<UnderlyingType, NumTerminals>& grammar, const std::filesystem::path& compilationUnit, std::string_view source,
+                                     std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+{
+    TokenStream<UnderlyingType> result(source, FileTable::Register(compilationUnit, source), resource);
+    std::size_t offset{};
+    while (offset < source.length())
+    {
+        std::size_t length{};
+        auto type = grammar.Match(source.substr(offset), length);
+        result.Add(TokenView<UnderlyingType>(type, source.substr(offset, length), offset));
+        offset += length;
+    }
+    return result;
+}
+
+} // namespace parser
@@ -0,0 +1,139 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <initializer_list>
+#include <stdexcept>
+
+namespace parser {
+
+// State machine for states and stimuli that are enumerations (or integers) with a known number of values.
+// Transitions are stored in a dense [state][stimulus] table of plain function pointers, so handling an input is an
+// index computation and at most two direct calls. The table can be built at compile time:
+//
+//     constexpr StateTable<State, Stimulus, Data, NumStates, NumStimuli> table{
+//         StateTableRule<State, Stimulus, Data>::Transition(State::A, State::B, Stimulus::X, OnTransition),
+//     };
+//     TableStateMachine<State, Stimulus, Data, NumStates, NumStimuli> stateMachine(table);
+
+template<class State, class Stimulus, class Data>
+using StateTransitionFunction = bool(*)(State from, State to, Stimulus input, Data data);
+
+template<class State, class Stimulus, class Data>
+using StateInputFunction = State(*)(State from, Stimulus input, Data data);
+
+template<class State, class Stimulus, class Data>
+using HandleInputFunction = void(*)(State from, State to, Stimulus input, Data data);
+
+template<class State, class Stimulus, class Data>
+struct StateTableRule
+{
+    State from;
+    State to;
+    Stimulus input;
+    StateTransitionFunction<State, Stimulus, Data> transitionAction;
+    StateInputFunction<State, Stimulus, Data> handleInputAction;
+
+    static constexpr StateTableRule Transition(State from, State to, Stimulus input, StateTransitionFunction<State, Stimulus, Data> action = nullptr)
+    {
+        return StateTableRule{ from, to, input, action, nullptr };
+    }
+    static constexpr StateTableRule HandleInput(State from, Stimulus input, StateInputFunction<State, Stimulus, Data> action)
+    {
+        return StateTableRule{ from, from, input, nullptr, action };
+    }
+};
+
+template<class State, class Stimulus, class Data, std::size_t NumStates, std::size_t NumStimuli>
+class StateTable
+{
+public:
+    struct Entry
+    {
+        bool isValid{};
+        State to{};
+        StateTransitionFunction<State, Stimulus, Data> transitionAction{};
+        StateInputFunction<State, Stimulus, Data> handleInputAction{};
+    };
+
+private:
+    std::array<Entry, NumStates * NumStimuli> m_entries;
+
+public:
+    constexpr StateTable()
+        : m_entries{}
+    {
+    }
+    // For a state and stimulus with more than one rule, the first rule wins, as in StateMachine
+    constexpr StateTable(std::initializer_list<StateTableRule<State, Stimulus, Data>> rules)
+        : m_entries{}
+    {
+        for (auto const& rule : rules)
+        {
+            Add(rule);
+        }
+    }
+
+    // Ignores the rule if the state and stimulus already have one
+    constexpr void Add(const StateTableRule<State, Stimulus, Data>& rule)
+    {
+        auto state = static_cast<std::size_t>(rule.from);
+        auto stimulus = static_cast<std::size_t>(rule.input);
+        if ((state >= NumStates) || (stimulus >= NumStimuli))
+            throw std::out_of_range("State or stimulus out of range for state table");
+        auto& entry = m_entries[state * NumStimuli + stimulus];
+        if (entry.isValid)
+            return;
+        entry.isValid = true;
+        entry.to = rule.to;
+        entry.transitionAction = rule.transitionAction;
+        entry.handleInputAction = rule.handleInputAction;
+    }
+    // Returns nullptr if there is no rule for the state and stimulus
+    constexpr const Entry* Find(State from, Stimulus input) const
+    {
+        auto state = static_cast<std::size_t>(from);
+        auto stimulus = static_cast<std::size_t>(input);
+        if ((state >= NumStates) || (stimulus >= NumStimuli))
+            return nullptr;
+        auto const& entry = m_entries[state * NumStimuli + stimulus];
+        return entry.isValid ? &entry : nullptr;
+    }
+};
+
+template<class State, class Stimulus, class Data, std::size_t NumStates, std::size_t NumStimuli>
+class TableStateMachine
+{
+private:
+    const StateTable<State, Stimulus, Data, NumStates, NumStimuli>& m_table;
+    State m_state;
+    HandleInputFunction<State, Stimulus, Data> m_handleInputCallback;
+
+public:
+    explicit TableStateMachine(const StateTable<State, Stimulus, Data, NumStates, NumStimuli>& table)
+        : m_table(table)
+        , m_state{}
+        , m_handleInputCallback{}
+    {
+    }
+    // The state machine refers to the table, which must outlive it
+    explicit TableStateMachine(StateTable<State, Stimulus, Data, NumStates, NumStimuli>&& table) = delete;
+
+    void SetCallback(HandleInputFunction<State, Stimulus, Data> callback) { m_handleInputCallback = callback; }
+    State GetState() const { return m_state; }
+    void SetState(State state) { m_state = state; }
+    bool HandleInput(Stimulus input, Data data)
+    {
+        auto entry = m_table.Find(m_state, input);
+        if (entry == nullptr)
+            return false;
+        auto from = m_state;
+        m_state = entry->handleInputAction ? entry->handleInputAction(from, input, data) : entry->to;
+        bool result = entry->transitionAction ? entry->transitionAction(from, m_state, input, data) : true;
+        if (m_handleInputCallback)
+            m_handleInputCallback(from, m_state, input, data);
+        return result;
+    }
+};
+
+} // namespace parser
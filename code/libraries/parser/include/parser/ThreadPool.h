@@ -0,0 +1,74 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace parser {
+
+// Pool of worker threads with a work stealing scheduler.
+// Every worker has its own task queue. A task submitted from a worker is added to the queue of that worker, which
+// takes its own tasks last in first out, so tasks spawned by a task run close to it. A worker without tasks steals
+// the oldest task of another worker. Tasks submitted from other threads are spread over the workers in turn.
+// Tasks must not wait for other tasks of the pool, as all workers could then be waiting.
+// Destroying the pool runs the tasks that are still queued.
+class ThreadPool
+{
+public:
+    using Task = std::function<void()>;
+
+private:
+    struct Worker
+    {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+
+    std::vector<std::unique_ptr<Worker>> m_workers;
+    std::vector<std::thread> m_threads;
+    std::mutex m_mutex;
+    std::condition_variable m_wakeUp;
+    std::size_t m_queuedTasks;
+    bool m_stop;
+    std::atomic<std::size_t> m_nextWorker;
+
+public:
+    // With numThreads 0, the number of hardware threads is used
+    explicit ThreadPool(std::size_t numThreads = 0);
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator = (const ThreadPool&) = delete;
+    ~ThreadPool();
+
+    std::size_t NumThreads() const { return m_threads.size(); }
+    // Pool with a thread per hardware thread, shared by users that do not have a pool of their own
+    static ThreadPool& Default();
+
+    void Submit(Task task);
+    // Runs function on the pool, the future holds its result or the exception it throws
+    template<typename Function>
+    auto Async(Function function) -> std::future<decltype(function())>;
+
+private:
+    void Run(std::size_t index);
+    bool TryPop(std::size_t index, Task& task);
+    bool TrySteal(std::size_t index, Task& task);
+};
+
+template<typename Function>
+auto ThreadPool::Async(Function function) -> std::future<decltype(function())>
+{
+    // std::function needs a copyable task
+    auto task = std::make_shared<std::packaged_task<decltype(function())()>>(std::move(function));
+    auto result = task->get_future();
+    Submit([task]() { (*task)(); });
+    return result;
+}
+
+} // namespace parser
@@ -36,7 +36,7 @@ public:
     bool IsNull() const { return m_type == TokenType<UnderlyingType>{}; }
     bool IsInvalid() const { return m_type == TokenType<UnderlyingType>::InvalidToken; }
     TokenType<UnderlyingType> Type() const { return m_type; }
-    std::string Value() const { return m_value; }
+    const std::string& Value() const { return m_value; }
     SourceLocation Location() const { return m_startLocation; }
     SourceLocation BeginLocation() const { return m_startLocation; }
     SourceLocation EndLocation() const { return m_endLocation; }
@@ -0,0 +1,131 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <memory_resource>
+#include <string_view>
+#include <system_error>
+#include <vector>
+#include "parser/ContentHash.h"
+#include "parser/FileTable.h"
+#include "parser/TokenStream.h"
+
+namespace parser {
+
+// Identifies the tokens of a source text: the hash and size of the text, and the identity of the grammar it was lexed
+// with, see GrammarId, which changes with the token types and rules of the lexer.
+struct TokenCacheKey
+{
+    std::uint64_t contentHash;
+    std::uint64_t sourceSize;
+    std::uint64_t grammarId;
+
+    static TokenCacheKey Make(std::string_view source, std::uint64_t grammarId)
+    {
+        return TokenCacheKey{ ContentHash(source), source.size(), grammarId };
+    }
+};
+
+// Cache of lexed token streams in a directory, so that unchanged files are not lexed again.
+// Each entry is a file named after its key, with a fixed size header followed by the arrays of token types,
+// offsets and lengths as 32-bit values, which can be read in bulk or mapped into memory as is. Entries are written
+// to a temporary file first and then renamed, so processes sharing the directory never see a partial entry.
+// Entries that do not match their key or the source text are ignored, and any error reading or writing an entry
+// results in lexing the text as if there were no cache.
+class TokenCache
+{
+public:
+    static constexpr std::uint32_t FormatVersion = 1;
+
+private:
+    struct Entry
+    {
+        std::vector<std::uint32_t> types;
+        std::vector<std::uint32_t> offsets;
+        std::vector<std::uint32_t> lengths;
+    };
+
+    // Type codes are stored with the invalid and null flags in the top bits
+    static constexpr std::uint32_t InvalidFlag = 0x40000000u;
+    static constexpr std::uint32_t NullFlag = 0x80000000u;
+    static constexpr std::uint32_t TypeCodeMask = 0x3FFFFFFFu;
+
+    std::filesystem::path m_directory;
+
+public:
+    explicit TokenCache(const std::filesystem::path& directory);
+
+    const std::filesystem::path& Directory() const { return m_directory; }
+    std::filesystem::path EntryPath(const TokenCacheKey& key) const;
+
+    // Adds the tokens of the source text of an empty token stream, returns false if there is no valid entry for it
+    template<typename UnderlyingType>
+    bool Load(const TokenCacheKey& key, TokenStream<UnderlyingType>& tokens) const;
+    template<typename UnderlyingType>
+    bool Store(const TokenCacheKey& key, const TokenStream<UnderlyingType>& tokens) const;
+    // Returns the tokens of a source text from the cache, or lexes it with tokenize(compilationUnit, source) and
+    // stores the result. Tokens loaded from the cache are allocated from the memory resource.
+    template<typename UnderlyingType, typename TokenizeFunction>
+    TokenStream<UnderlyingType> Tokenize(std::uint64_t grammarId, const std::filesystem::path& compilationUnit, std::string_view source,
+                                         TokenizeFunction tokenize, std::pmr::memory_resource* resource = std::pmr::get_default_resource()) const;
+
+private:
+    bool ReadEntry(const TokenCacheKey& key, Entry& entry) const;
+    bool WriteEntry(const TokenCacheKey& key, const Entry& entry) const;
+};
+
+template<typename UnderlyingType>
+bool TokenCache::Load(const TokenCacheKey& key, TokenStream<UnderlyingType>& tokens) const
+{
+    Entry entry;
+    if ((tokens.Source().size() != key.sourceSize) || !ReadEntry(key, entry))
+        return false;
+    tokens.Reserve(entry.types.size());
+    for (std::size_t index = 0; index < entry.types.size(); ++index)
+    {
+        auto code = entry.types[index];
+        TokenType<UnderlyingType> type{};
+        if ((code & NullFlag) == 0)
+            type = TokenType<UnderlyingType>(static_cast<UnderlyingType>(code & TypeCodeMask), (code & InvalidFlag) != 0);
+        tokens.Add(TokenView<UnderlyingType>(type, tokens.Source().substr(entry.offsets[index], entry.lengths[index]), entry.offsets[index]));
+    }
+    return true;
+}
+
+template<typename UnderlyingType>
+bool TokenCache::Store(const TokenCacheKey& key, const TokenStream<UnderlyingType>& tokens) const
+{
+    Entry entry;
+    entry.types.reserve(tokens.Size());
+    for (auto const& type : tokens.Types())
+    {
+        auto code = static_cast<std::uint32_t>(type.TypeCode()) & TypeCodeMask;
+        if (type.IsInvalid())
+            code |= InvalidFlag;
+        if (type.IsNull())
+            code |= NullFlag;
+        entry.types.push_back(code);
+    }
+    entry.offsets.assign(tokens.Offsets().begin(), tokens.Offsets().end());
+    entry.lengths.assign(tokens.Lengths().begin(), tokens.Lengths().end());
+    return WriteEntry(key, entry);
+}
+
+template<typename UnderlyingType, typename TokenizeFunction>
+TokenStream<UnderlyingType> TokenCache::Tokenize(std::uint64_t grammarId, const std::filesystem::path& compilationUnit, std::string_view source,
+                                                 TokenizeFunction tokenize, std::pmr::memory_resource* resource) const
+{
+    auto key = TokenCacheKey::Make(source, grammarId);
+    std::error_code error;
+    if (std::filesystem::exists(EntryPath(key), error))
+    {
+        TokenStream<UnderlyingType> tokens(source, FileTable::Register(compilationUnit, source), resource);
+        if (Load(key, tokens))
+            return tokens;
+    }
+    auto tokens = tokenize(compilationUnit, source);
+    Store(key, tokens);
+    return tokens;
+}
+
+} // namespace parser
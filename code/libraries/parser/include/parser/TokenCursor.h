@@ -0,0 +1,46 @@
+#pragma once
+
+#include "parser/TokenStream.h"
+
+namespace parser {
+
+// Position in a TokenStream, for parsers running over a lexed compilation unit.
+// Moving the cursor and looking at tokens before or after it is constant time. Positions outside the stream
+// read as null tokens.
+template<typename UnderlyingType>
+class TokenCursor
+{
+private:
+    const TokenStream<UnderlyingType>& m_stream;
+    std::size_t m_position;
+
+public:
+    explicit TokenCursor(const TokenStream<UnderlyingType>& stream, std::size_t position = 0)
+        : m_stream(stream)
+        , m_position{ position }
+    {
+    }
+
+    std::size_t Position() const { return m_position; }
+    bool IsAtEnd() const { return m_position >= m_stream.Size(); }
+    void Seek(std::size_t position) { m_position = position; }
+    void Next(std::size_t count = 1) { m_position += count; }
+    void Back(std::size_t count = 1) { m_position = (count < m_position) ? m_position - count : 0; }
+
+    TokenType<UnderlyingType> Type() const { return PeekType(0); }
+    TokenView<UnderlyingType> View() const { return PeekView(0); }
+    Token<UnderlyingType> GetToken() const
+    {
+        return IsAtEnd() ? Token<UnderlyingType>{} : m_stream.MakeToken(m_position);
+    }
+    TokenType<UnderlyingType> PeekType(std::size_t index) const
+    {
+        return (m_position + index < m_stream.Size()) ? m_stream.Type(m_position + index) : TokenType<UnderlyingType>{};
+    }
+    TokenView<UnderlyingType> PeekView(std::size_t index) const
+    {
+        return (m_position + index < m_stream.Size()) ? m_stream.View(m_position + index) : TokenView<UnderlyingType>{};
+    }
+};
+
+} // namespace parser
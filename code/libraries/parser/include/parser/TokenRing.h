@@ -0,0 +1,80 @@
+#pragma once
+
+#include <stdexcept>
+#include <vector>
+#include "parser/TokenView.h"
+
+namespace parser {
+
+// Fixed capacity ring buffer of token views, used by the tokenizer for lookahead and pushing back tokens.
+// Views are added at the back when reading ahead, and at the front when a token is pushed back, both in constant time.
+// The capacity is rounded up to a power of two, and storage is allocated once, on construction.
+template<typename UnderlyingType>
+class TokenRing
+{
+public:
+    static constexpr std::size_t DefaultCapacity = 16;
+
+private:
+    std::vector<TokenView<UnderlyingType>> m_entries;
+    std::size_t m_mask;
+    std::size_t m_head;
+    std::size_t m_size;
+
+public:
+    explicit TokenRing(std::size_t capacity = DefaultCapacity)
+        : m_entries{}
+        , m_mask{}
+        , m_head{}
+        , m_size{}
+    {
+        std::size_t roundedCapacity{ 1 };
+        while (roundedCapacity < capacity)
+            roundedCapacity <<= 1;
+        m_entries.resize(roundedCapacity);
+        m_mask = roundedCapacity - 1;
+    }
+
+    std::size_t Capacity() const { return m_entries.size(); }
+    std::size_t Size() const { return m_size; }
+    bool IsEmpty() const { return m_size == 0; }
+    bool IsFull() const { return m_size == m_entries.size(); }
+
+    const TokenView<UnderlyingType>& operator[](std::size_t index) const
+    {
+        return m_entries[(m_head + index) & m_mask];
+    }
+    const TokenView<UnderlyingType>& Front() const
+    {
+        return m_entries[m_head];
+    }
+    void PushFront(const TokenView<UnderlyingType>& view)
+    {
+        if (IsFull())
+            throw std::length_error("Token ring buffer capacity exceeded");
+        m_head = (m_head + m_mask) & m_mask;
+        m_entries[m_head] = view;
+        ++m_size;
+    }
+    void PushBack(const TokenView<UnderlyingType>& view)
+    {
+        if (IsFull())
+            throw std::length_error("Token ring buffer capacity exceeded");
+        m_entries[(m_head + m_size) & m_mask] = view;
+        ++m_size;
+    }
+    TokenView<UnderlyingType> PopFront()
+    {
+        auto result = m_entries[m_head];
+        m_head = (m_head + 1) & m_mask;
+        --m_size;
+        return result;
+    }
+    void Clear()
+    {
+        m_head = 0;
+        m_size = 0;
+    }
+};
+
+} // namespace parser
@@ -0,0 +1,121 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <memory_resource>
+#include <string_view>
+#include <vector>
+#include "parser/SourceLocation.h"
+#include "parser/Token.h"
+#include "parser/TokenView.h"
+
+namespace parser {
+
+// Replaces the elements [first, first + count) of a vector. Elements are overwritten where possible, so the elements
+// after the range only move when the number of elements changes.
+template<typename Vector>
+void ReplaceRange(Vector& elements, std::size_t first, std::size_t count, const Vector& replacement)
+{
+    auto common = std::min(count, replacement.size());
+    std::copy(replacement.begin(), replacement.begin() + static_cast<std::ptrdiff_t>(common), elements.begin() + static_cast<std::ptrdiff_t>(first));
+    auto position = elements.begin() + static_cast<std::ptrdiff_t>(first + common);
+    if (count > common)
+        elements.erase(position, position + static_cast<std::ptrdiff_t>(count - common));
+    else
+        elements.insert(position, replacement.begin() + static_cast<std::ptrdiff_t>(common), replacement.end());
+}
+
+// Tokens of a complete compilation unit, stored as separate arrays of types, offsets and lengths.
+// The values of the tokens refer to the source text, which must outlive the stream. Owning tokens with their
+// locations are only created when requested through MakeToken.
+// The arrays are allocated from a memory resource, such as a ParseArena for the tokens of a parse session.
+template<typename UnderlyingType>
+class TokenStream
+{
+private:
+    std::string_view m_source;
+    FileId m_fileId;
+    std::pmr::vector<TokenType<UnderlyingType>> m_types;
+    std::pmr::vector<std::uint32_t> m_offsets;
+    std::pmr::vector<std::uint32_t> m_lengths;
+
+public:
+    TokenStream()
+        : m_source{}
+        , m_fileId{ FileTable::NoFile }
+        , m_types{}
+        , m_offsets{}
+        , m_lengths{}
+    {
+    }
+    TokenStream(std::string_view source, FileId fileId, std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+        : m_source{ source }
+        , m_fileId{ fileId }
+        , m_types{ resource }
+        , m_offsets{ resource }
+        , m_lengths{ resource }
+    {
+    }
+
+    void Add(const TokenView<UnderlyingType>& view)
+    {
+        m_types.push_back(view.Type());
+        m_offsets.push_back(static_cast<std::uint32_t>(view.Offset()));
+        m_lengths.push_back(static_cast<std::uint32_t>(view.Length()));
+    }
+
+    // Appends the tokens of another stream on the same source text, starting at token index first
+    void Append(const TokenStream& other, std::size_t first = 0)
+    {
+        m_types.insert(m_types.end(), other.m_types.begin() + static_cast<std::ptrdiff_t>(first), other.m_types.end());
+        m_offsets.insert(m_offsets.end(), other.m_offsets.begin() + static_cast<std::ptrdiff_t>(first), other.m_offsets.end());
+        m_lengths.insert(m_lengths.end(), other.m_lengths.begin() + static_cast<std::ptrdiff_t>(first), other.m_lengths.end());
+    }
+    // Replaces the tokens [first, first + count) by the tokens of another stream, and moves the offsets of the tokens
+    // after them by shift characters. The stream then refers to the source text of the other stream.
+    void Replace(std::size_t first, std::size_t count, const TokenStream& other, std::ptrdiff_t shift)
+    {
+        for (auto index = first + count; index < m_offsets.size(); ++index)
+        {
+            m_offsets[index] = static_cast<std::uint32_t>(static_cast<std::ptrdiff_t>(m_offsets[index]) + shift);
+        }
+        ReplaceRange(m_types, first, count, other.m_types);
+        ReplaceRange(m_offsets, first, count, other.m_offsets);
+        ReplaceRange(m_lengths, first, count, other.m_lengths);
+        m_source = other.m_source;
+        m_fileId = other.m_fileId;
+    }
+    void Reserve(std::size_t size)
+    {
+        m_types.reserve(size);
+        m_offsets.reserve(size);
+        m_lengths.reserve(size);
+    }
+
+    std::string_view Source() const { return m_source; }
+    FileId GetFileId() const { return m_fileId; }
+    std::size_t Size() const { return m_types.size(); }
+    bool IsEmpty() const { return m_types.empty(); }
+
+    TokenType<UnderlyingType> Type(std::size_t index) const { return m_types[index]; }
+    std::uint32_t Offset(std::size_t index) const { return m_offsets[index]; }
+    std::uint32_t Length(std::size_t index) const { return m_lengths[index]; }
+    std::string_view Value(std::size_t index) const { return m_source.substr(m_offsets[index], m_lengths[index]); }
+    TokenView<UnderlyingType> View(std::size_t index) const
+    {
+        return TokenView<UnderlyingType>(m_types[index], Value(index), m_offsets[index]);
+    }
+    Token<UnderlyingType> MakeToken(std::size_t index) const
+    {
+        return Token<UnderlyingType>(m_types[index], std::string(Value(index)),
+            SourceLocation(m_fileId, m_offsets[index]), SourceLocation(m_fileId, m_offsets[index] + m_lengths[index]));
+    }
+
+    std::pmr::memory_resource* Resource() const { return m_types.get_allocator().resource(); }
+
+    const std::pmr::vector<TokenType<UnderlyingType>>& Types() const { return m_types; }
+    const std::pmr::vector<std::uint32_t>& Offsets() const { return m_offsets; }
+    const std::pmr::vector<std::uint32_t>& Lengths() const { return m_lengths; }
+};
+
+} // namespace parser
@@ -0,0 +1,99 @@
+#pragma once
+
+#include <vector>
+#include "parser/ITokenizer.h"
+#include "parser/SourceLocation.h"
+#include "parser/Token.h"
+#include "parser/TokenCursor.h"
+#include "parser/TokenStream.h"
+#include "parser/TokenView.h"
+
+namespace parser {
+
+// Tokenizer reading the tokens of a compilation unit that was lexed before, for instance on another thread.
+// It has the interface of the other tokenizers, so a parser reads lexed tokens as if it were lexing. Pushing back
+// the token that was read last moves back in the stream, other tokens pushed back are kept and read again first.
+template<typename UnderlyingType>
+class TokenStreamTokenizer
+    : public ITokenizer<UnderlyingType>
+{
+private:
+    const TokenStream<UnderlyingType>& m_tokens;
+    TokenCursor<UnderlyingType> m_cursor;
+    std::vector<Token<UnderlyingType>> m_ungotTokens;
+    Token<UnderlyingType> m_restoredToken;
+
+public:
+    explicit TokenStreamTokenizer(const TokenStream<UnderlyingType>& tokens)
+        : m_tokens(tokens)
+        , m_cursor(tokens)
+        , m_ungotTokens{}
+        , m_restoredToken{}
+    {
+    }
+
+    Token<UnderlyingType> GetToken() override
+    {
+        return MakeToken(GetTokenView());
+    }
+    TokenView<UnderlyingType> GetTokenView();
+    Token<UnderlyingType> MakeToken(const TokenView<UnderlyingType>& view) const;
+    void UngetToken(const Token<UnderlyingType>& token) override;
+    SourceLocation GetCurrentLocation() const override;
+    bool IsAtEnd() const override
+    {
+        return m_cursor.IsAtEnd() && m_ungotTokens.empty();
+    }
+};
+
+template<typename UnderlyingType>
+TokenView<UnderlyingType> TokenStreamTokenizer<UnderlyingType>::GetTokenView()
+{
+    if (!m_ungotTokens.empty())
+    {
+        m_restoredToken = std::move(m_ungotTokens.back());
+        m_ungotTokens.pop_back();
+        return TokenView<UnderlyingType>(m_restoredToken.Type(), m_restoredToken.Value(), TokenView<UnderlyingType>::RestoredOffset);
+    }
+    auto view = m_cursor.View();
+    if (!m_cursor.IsAtEnd())
+        m_cursor.Next();
+    return view;
+}
+
+template<typename UnderlyingType>
+Token<UnderlyingType> TokenStreamTokenizer<UnderlyingType>::MakeToken(const TokenView<UnderlyingType>& view) const
+{
+    if (view.IsRestored())
+        return m_restoredToken;
+    if (view.IsNull())
+        return {};
+    return Token<UnderlyingType>(view.Type(), std::string(view.Value()),
+        SourceLocation(m_tokens.GetFileId(), static_cast<std::uint32_t>(view.Offset())),
+        SourceLocation(m_tokens.GetFileId(), static_cast<std::uint32_t>(view.Offset() + view.Length())));
+}
+
+template<typename UnderlyingType>
+void TokenStreamTokenizer<UnderlyingType>::UngetToken(const Token<UnderlyingType>& token)
+{
+    auto const& location = token.BeginLocation();
+    if (m_ungotTokens.empty() && (m_cursor.Position() > 0) && location.HasOffset() && (location.GetFileId() == m_tokens.GetFileId()) &&
+        (location.Offset() == m_tokens.Offsets()[m_cursor.Position() - 1]))
+    {
+        m_cursor.Back();
+        return;
+    }
+    m_ungotTokens.push_back(token);
+}
+
+// Location after the last token read from the stream
+template<typename UnderlyingType>
+SourceLocation TokenStreamTokenizer<UnderlyingType>::GetCurrentLocation() const
+{
+    if (m_cursor.Position() == 0)
+        return SourceLocation(m_tokens.GetFileId(), 0);
+    auto index = m_cursor.Position() - 1;
+    return SourceLocation(m_tokens.GetFileId(), m_tokens.Offsets()[index] + m_tokens.Lengths()[index]);
+}
+
+} // namespace parser
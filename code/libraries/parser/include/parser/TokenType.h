@@ -40,7 +40,9 @@ public:
         , m_isNull{}
     {}
 
-    UnderlyingType TypeCode() const { return m_type; }
+    constexpr UnderlyingType TypeCode() const { return m_type; }
+    constexpr bool IsNull() const { return m_isNull; }
+    constexpr bool IsInvalid() const { return m_isInvalid; }
     constexpr bool Equals(UnderlyingType value) const { return (m_type == value) && !m_isNull && !m_isInvalid; }
     constexpr bool Equals(const TokenType& value) const { return (m_type == value.m_type) && (m_isNull == value.m_isNull) && (m_isInvalid == value.m_isInvalid); }
     constexpr bool operator <(const TokenType& rhs) const
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <initializer_list>
+#include <stdexcept>
+#include "parser/TokenType.h"
+
+namespace parser {
+
+// Set of token types, stored as a bitset indexed by the value of the underlying enumeration.
+// Sets can be constructed at compile time, and a lookup is a single bit test. The enumeration values must be less
+// than NumTypes.
+template<typename UnderlyingType, std::size_t NumTypes = 64>
+class TokenTypeSet
+{
+private:
+    static constexpr std::size_t BitsPerWord = 64;
+    static constexpr std::size_t NumWords = (NumTypes + BitsPerWord - 1) / BitsPerWord;
+    std::array<std::uint64_t, NumWords> m_bits;
+
+public:
+    constexpr TokenTypeSet()
+        : m_bits{}
+    {
+    }
+    constexpr TokenTypeSet(std::initializer_list<UnderlyingType> types)
+        : m_bits{}
+    {
+        for (auto type : types)
+        {
+            Insert(type);
+        }
+    }
+
+    constexpr void Insert(UnderlyingType type)
+    {
+        auto index = static_cast<std::size_t>(type);
+        if (index >= NumTypes)
+            throw std::out_of_range("Token type out of range for token type set");
+        m_bits[index / BitsPerWord] |= std::uint64_t{ 1 } << (index % BitsPerWord);
+    }
+    constexpr void Erase(UnderlyingType type)
+    {
+        auto index = static_cast<std::size_t>(type);
+        if (index < NumTypes)
+            m_bits[index / BitsPerWord] &= ~(std::uint64_t{ 1 } << (index % BitsPerWord));
+    }
+    constexpr bool Contains(UnderlyingType type) const
+    {
+        auto index = static_cast<std::size_t>(type);
+        return (index < NumTypes) && ((m_bits[index / BitsPerWord] >> (index % BitsPerWord)) & 1);
+    }
+    // Null and invalid token types are never contained in a set
+    constexpr bool Contains(const TokenType<UnderlyingType>& type) const
+    {
+        return !type.IsNull() && !type.IsInvalid() && Contains(type.TypeCode());
+    }
+    constexpr bool IsEmpty() const
+    {
+        for (auto word : m_bits)
+        {
+            if (word != 0)
+                return false;
+        }
+        return true;
+    }
+    constexpr bool operator ==(const TokenTypeSet& other) const
+    {
+        for (std::size_t index = 0; index < NumWords; ++index)
+        {
+            if (m_bits[index] != other.m_bits[index])
+                return false;
+        }
+        return true;
+    }
+    constexpr bool operator !=(const TokenTypeSet& other) const
+    {
+        return !(*this == other);
+    }
+};
+
+} // namespace parser
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <string_view>
+#include "TokenType.h"
+
+namespace parser
+{
+
+// Non-owning token, referring to the text of the token in the source buffer of the tokenizer.
+// A view stays valid as long as the tokenizer it was read from. Tokens that need to outlive the tokenizer
+// are converted to an owning Token through Tokenizer::MakeToken.
+template<typename UnderlyingType>
+class TokenView
+{
+public:
+    // Offset of a view referring to a token that was pushed back, rather than to the source buffer
+    static constexpr std::size_t RestoredOffset = static_cast<std::size_t>(-1);
+
+private:
+    TokenType<UnderlyingType> m_type;
+    std::string_view m_value;
+    std::size_t m_offset;
+
+public:
+    TokenView()
+        : m_type{}
+        , m_value{}
+        , m_offset{}
+    {
+    }
+    TokenView(const TokenType<UnderlyingType>& type, std::string_view value, std::size_t offset)
+        : m_type{ type }
+        , m_value{ value }
+        , m_offset{ offset }
+    {
+    }
+
+    bool IsNull() const { return m_type == TokenType<UnderlyingType>{}; }
+    bool IsInvalid() const { return m_type == TokenType<UnderlyingType>::InvalidToken; }
+    bool IsRestored() const { return m_offset == RestoredOffset; }
+    TokenType<UnderlyingType> Type() const { return m_type; }
+    std::string_view Value() const { return m_value; }
+    std::size_t Offset() const { return m_offset; }
+    std::size_t Length() const { return m_value.length(); }
+    bool Equals(const TokenType<UnderlyingType>& tokenType) const
+    {
+        return m_type == tokenType;
+    }
+};
+
+template<typename UnderlyingType>
+inline bool operator ==(const TokenView<UnderlyingType>& lhs, const TokenType<UnderlyingType>& rhs) { return lhs.Equals(rhs); }
+template<typename UnderlyingType>
+inline bool operator ==(const TokenType<UnderlyingType>& lhs, const TokenView<UnderlyingType>& rhs) { return rhs.Equals(lhs); }
+template<typename UnderlyingType>
+inline bool operator !=(const TokenView<UnderlyingType>& lhs, const TokenType<UnderlyingType>& rhs) { return !(lhs == rhs); }
+template<typename UnderlyingType>
+inline bool operator !=(const TokenType<UnderlyingType>& lhs, const TokenView<UnderlyingType>& rhs) { return !(lhs == rhs); }
+
+} // namespace parser
@@ -1,26 +1,68 @@
 #pragma once
 
+#include <deque>
 #include <filesystem>
 #include <memory>
-#include <stack>
+#include <memory_resource>
+#include <stdexcept>
 #include "parser/ITokenizer.h"
 #include "parser/Reader.h"
 #include "parser/Token.h"
-#include "parser/TokenizerRule.h"
+#include "parser/TokenizerRuleSet.h"
+#include "parser/TokenRing.h"
+#include "parser/TokenStream.h"
+#include "parser/TokenView.h"
 
 namespace parser {
 
+// Tokenizer for a compilation unit, using a shared rule set.
+// Tokens read ahead with PeekTokenView and tokens pushed back with UngetToken are kept in a fixed capacity ring buffer
+// of views on the source text. Pushing back a token read from this tokenizer does not copy it; only tokens from
+// elsewhere are stored by the tokenizer until they are read again.
 template<typename UnderlyingType>
 class Tokenizer
     : public ITokenizer<UnderlyingType>
 {
 private:
+    const TokenizerRuleSet<UnderlyingType>& m_ruleSet;
     Reader m_reader;
-    std::stack<Token<UnderlyingType>> m_tokenBuffer;
+    TokenRing<UnderlyingType> m_lookAhead;
+    std::deque<Token<UnderlyingType>> m_restoredTokens;
+    Token<UnderlyingType> m_restoredToken;
+    std::size_t m_scanEnd;
 
 public:
-    Tokenizer(const std::filesystem::path& compilationUnit, std::istream& stream)
-        : m_reader(compilationUnit, stream)
+    // The text of the stream is read into a buffer allocated from resource
+    Tokenizer(const TokenizerRuleSet<UnderlyingType>& ruleSet, const std::filesystem::path& compilationUnit, std::istream& stream,
+              std::size_t lookAheadTokens = TokenRing<UnderlyingType>::DefaultCapacity, std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+        : m_ruleSet(ruleSet)
+        , m_reader(compilationUnit, stream, resource)
+        , m_lookAhead(lookAheadTokens)
+        , m_restoredTokens{}
+        , m_restoredToken{}
+        , m_scanEnd{}
+    {
+    }
+    Tokenizer(const TokenizerRuleSet<UnderlyingType>& ruleSet, const std::filesystem::path& compilationUnit, std::string_view source,
+              std::size_t lookAheadTokens = TokenRing<UnderlyingType>::DefaultCapacity)
+        : m_ruleSet(ruleSet)
+        , m_reader(compilationUnit, source)
+        , m_lookAhead(lookAheadTokens)
+        , m_restoredTokens{}
+        , m_restoredToken{}
+        , m_scanEnd{}
+    {
+    }
+
+    // Tokenizer on a caller owned source buffer that is already registered with the FileTable
+    Tokenizer(const TokenizerRuleSet<UnderlyingType>& ruleSet, FileId fileId, std::string_view source,
+              std::size_t lookAheadTokens = TokenRing<UnderlyingType>::DefaultCapacity)
+        : m_ruleSet(ruleSet)
+        , m_reader(fileId, source)
+        , m_lookAhead(lookAheadTokens)
+        , m_restoredTokens{}
+        , m_restoredToken{}
+        , m_scanEnd{}
     {
     }
 
@@ -28,139 +70,311 @@ public:
     {
     }
 
-    Token<UnderlyingType> GetToken();
-    void UngetToken(const Token<UnderlyingType>& token)
+    Token<UnderlyingType> GetToken()
+    {
+        return MakeToken(GetTokenView());
+    }
+    TokenView<UnderlyingType> GetTokenView();
+    // Returns the token index positions ahead without consuming it. The view stays valid until it is read.
+    const TokenView<UnderlyingType>& PeekTokenView(std::size_t index = 0);
+    Token<UnderlyingType> PeekToken(std::size_t index = 0);
+    Token<UnderlyingType> MakeToken(const TokenView<UnderlyingType>& view) const;
+    void UngetToken(const Token<UnderlyingType>& token);
+    void UngetTokenView(const TokenView<UnderlyingType>& view);
+    // Reads all remaining tokens at once. The token stream refers to the source text of the tokenizer.
+    TokenStream<UnderlyingType> Tokenize(std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+    // Continues reading at an offset in the source text, discarding tokens read ahead or pushed back
+    void Seek(std::size_t offset)
     {
-        m_tokenBuffer.push(token);
+        m_lookAhead.Clear();
+        m_restoredTokens.clear();
+        m_reader.Seek(offset);
+    }
+    // Offset after the last character examined to read the most recent token from the source text. Changing the text
+    // before this offset can change that token.
+    std::size_t ScanEnd() const
+    {
+        return m_scanEnd;
     }
     SourceLocation GetCurrentLocation() const
     {
         return m_reader.GetLocation();
     }
-    bool IsAtEnd() const
+    // Complete source text of the compilation unit
+    std::string_view Source() const
     {
-        return m_reader.EndOfStream() && m_tokenBuffer.empty();
+        return m_reader.GetText(0, m_reader.GetSize());
     }
-    typename TokenizerRules<UnderlyingType>::const_iterator FirstMatch(const std::string& text)
+    bool IsAtEnd() const
     {
-        auto it = GetTokenizerRules<UnderlyingType>().begin();
-        while (it != GetTokenizerRules<UnderlyingType>().end())
+        if (!m_reader.EndOfStream())
+            return false;
+        // Peeking beyond the end of the stream leaves null tokens, which do not count as pending tokens
+        for (std::size_t index = 0; index < m_lookAhead.Size(); ++index)
         {
-            if (it->Matches(text))
-                return it;
-            ++it;
+            if (!m_lookAhead[index].IsNull() || m_lookAhead[index].IsRestored())
+                return false;
         }
-        return it;
+        return true;
     }
-    bool HaveMultipleMatches(const std::string& text)
+    typename TokenizerRules<UnderlyingType>::const_iterator FirstMatch(std::string_view text) const
     {
-        size_t numMatches{};
-        auto it = GetTokenizerRules<UnderlyingType>().begin();
-        while (it != GetTokenizerRules<UnderlyingType>().end())
+        auto it = m_ruleSet.Rules().begin();
+        while (it != m_ruleSet.Rules().end())
         {
             if (it->Matches(text))
-                numMatches++;
+                return it;
             ++it;
         }
-        return numMatches > 1;
+        return it;
     }
+
+private:
+    TokenView<UnderlyingType> ReadTokenView();
+    TokenView<UnderlyingType> SourceView(const Token<UnderlyingType>& token) const;
+    TokenType<UnderlyingType> ReadTokenAutomaton();
+    TokenType<UnderlyingType> ReadTokenRegex();
 };
 
 template<typename UnderlyingType>
 using TokenizerPtr = std::unique_ptr<Tokenizer<UnderlyingType>>;
 
 template<typename UnderlyingType>
-Token<UnderlyingType> Tokenizer<UnderlyingType>::GetToken()
+TokenView<UnderlyingType> Tokenizer<UnderlyingType>::GetTokenView()
 {
-    char ch;
-    Token<UnderlyingType> token;
+    if (m_lookAhead.IsEmpty())
+        return ReadTokenView();
+
+    auto view = m_lookAhead.PopFront();
+    if (view.IsRestored())
+    {
+        // Restored tokens enter and leave the ring at the front, so the last one stored is the first one read
+        m_restoredToken = std::move(m_restoredTokens.back());
+        m_restoredTokens.pop_back();
+        return TokenView<UnderlyingType>(m_restoredToken.Type(), m_restoredToken.Value(), TokenView<UnderlyingType>::RestoredOffset);
+    }
+    return view;
+}
+
+template<typename UnderlyingType>
+const TokenView<UnderlyingType>& Tokenizer<UnderlyingType>::PeekTokenView(std::size_t index)
+{
+    if (index >= m_lookAhead.Capacity())
+        throw std::length_error("Token lookahead exceeds ring buffer capacity");
+    while (m_lookAhead.Size() <= index)
+    {
+        m_lookAhead.PushBack(ReadTokenView());
+    }
+    return m_lookAhead[index];
+}
 
-    if (!m_tokenBuffer.empty())
+template<typename UnderlyingType>
+Token<UnderlyingType> Tokenizer<UnderlyingType>::PeekToken(std::size_t index)
+{
+    auto const& view = PeekTokenView(index);
+    if (!view.IsRestored())
+        return MakeToken(view);
+    std::size_t restoredBefore{};
+    for (std::size_t i = 0; i < index; ++i)
     {
-        token = m_tokenBuffer.top();
-        m_tokenBuffer.pop();
-        return token;
+        if (m_lookAhead[i].IsRestored())
+            ++restoredBefore;
     }
+    return m_restoredTokens[m_restoredTokens.size() - 1 - restoredBefore];
+}
 
-    std::string currentTerm;
-    std::string extendedTerm;
-    SourceLocation startLocation = m_reader.GetLocation();
-    TokenizerRules<UnderlyingType>::const_iterator firstMatch = GetTokenizerRules<UnderlyingType>().end();
-    TokenizerRules<UnderlyingType>::const_iterator lastMatch = GetTokenizerRules<UnderlyingType>().end();
-    TokenizerRules<UnderlyingType>::const_iterator match = GetTokenizerRules<UnderlyingType>().end();
-    SourceLocation lastLocation{};
-    const size_t MaxLookAheadCharacters = 10;
-    size_t lookAheadCharacters{};
+template<typename UnderlyingType>
+void Tokenizer<UnderlyingType>::UngetToken(const Token<UnderlyingType>& token)
+{
+    auto view = SourceView(token);
+    if (!view.IsNull())
+    {
+        m_lookAhead.PushFront(view);
+        return;
+    }
+    m_restoredTokens.push_back(token);
+    try
+    {
+        m_lookAhead.PushFront(TokenView<UnderlyingType>(token.Type(), m_restoredTokens.back().Value(), TokenView<UnderlyingType>::RestoredOffset));
+    }
+    catch (...)
+    {
+        m_restoredTokens.pop_back();
+        throw;
+    }
+}
+
+template<typename UnderlyingType>
+void Tokenizer<UnderlyingType>::UngetTokenView(const TokenView<UnderlyingType>& view)
+{
+    if (view.IsRestored())
+    {
+        UngetToken(m_restoredToken);
+        return;
+    }
+    m_lookAhead.PushFront(view);
+}
+
+template<typename UnderlyingType>
+TokenStream<UnderlyingType> Tokenizer<UnderlyingType>::Tokenize(std::pmr::memory_resource* resource)
+{
+    TokenStream<UnderlyingType> result(m_reader.GetText(0, m_reader.GetSize()), m_reader.GetFileId(), resource);
+    for (auto view = GetTokenView(); !view.IsNull(); view = GetTokenView())
+    {
+        // Tokens pushed back from elsewhere are not part of the source text
+        if (!view.IsRestored())
+            result.Add(view);
+    }
+    return result;
+}
+
+template<typename UnderlyingType>
+TokenView<UnderlyingType> Tokenizer<UnderlyingType>::ReadTokenView()
+{
+    auto startOffset = m_reader.GetOffset();
+    auto type = m_ruleSet.Automaton().IsValid() ? ReadTokenAutomaton() : ReadTokenRegex();
+    return TokenView<UnderlyingType>(type, m_reader.GetText(startOffset, m_reader.GetOffset() - startOffset), startOffset);
+}
+
+// Returns a view on the source text for a token read from this tokenizer, or a null view for any other token
+template<typename UnderlyingType>
+TokenView<UnderlyingType> Tokenizer<UnderlyingType>::SourceView(const Token<UnderlyingType>& token) const
+{
+    auto const& begin = token.BeginLocation();
+    auto const& end = token.EndLocation();
+    if (!begin.HasOffset() || !end.HasOffset() || (begin.GetFileId() != m_reader.GetFileId()))
+        return {};
+    if ((end.Offset() < begin.Offset()) || (end.Offset() > m_reader.GetSize()))
+        return {};
+    auto text = m_reader.GetText(begin.Offset(), end.Offset() - begin.Offset());
+    if (text != token.Value())
+        return {};
+    return TokenView<UnderlyingType>(token.Type(), text, begin.Offset());
+}
+
+template<typename UnderlyingType>
+Token<UnderlyingType> Tokenizer<UnderlyingType>::MakeToken(const TokenView<UnderlyingType>& view) const
+{
+    if (view.IsRestored())
+        return m_restoredToken;
+    if (view.IsNull())
+        return {};
+    return Token(view.Type(), std::string(view.Value()), m_reader.GetLocation(view.Offset()), m_reader.GetLocation(view.Offset() + view.Length()));
+}
+
+template<typename UnderlyingType>
+TokenType<UnderlyingType> Tokenizer<UnderlyingType>::ReadTokenAutomaton()
+{
+    auto const& automaton = m_ruleSet.Automaton();
+    char ch;
+    size_t length{};
+    auto state = automaton.StartState();
+    int acceptRule = TokenizerAutomaton::NoRule;
+    size_t acceptLength{};
+    auto maxLookAheadCharacters = m_ruleSet.MaxLookAheadCharacters();
 
     while (m_reader.GetChar(ch))
     {
-        firstMatch = FirstMatch(currentTerm + extendedTerm + ch);
-        if (firstMatch == GetTokenizerRules<UnderlyingType>().end())
+        ++length;
+        if (!automaton.IsDead(state))
+            state = automaton.Next(state, ch);
+        if (automaton.IsDead(state))
         {
-            if (match != GetTokenizerRules<UnderlyingType>().end())
-            {
-                if (lookAheadCharacters < MaxLookAheadCharacters)
-                {
-                    lookAheadCharacters++;
-                    extendedTerm += ch;
-                    continue;
-                }
-                else
-                {
-                    m_reader.RestoreChars(extendedTerm + ch, lastLocation);
-                    extendedTerm = {};
-                    break;
-                }
-            }
-            else
-            {
-                currentTerm += ch;
-                continue;
-            }
+            // Without any match so far, everything up to the end of the stream becomes an invalid token
+            if (acceptRule != TokenizerAutomaton::NoRule)
+                break;
+            continue;
         }
-        lookAheadCharacters = 0;
-        currentTerm += extendedTerm;
-        currentTerm += ch;
-        extendedTerm = {};
-        lastMatch = firstMatch;
-        lastLocation = m_reader.GetLocation();
-        while (HaveMultipleMatches(currentTerm + extendedTerm))
+        auto rule = automaton.AcceptRule(state);
+        // Skip characters that keep the automaton in the same state at once, unless that could exceed the lookahead window
+        auto const& run = automaton.Run(state);
+        if (!run.IsEmpty() &&
+            ((rule != TokenizerAutomaton::NoRule) || (acceptRule == TokenizerAutomaton::NoRule) || (maxLookAheadCharacters == TokenizerRuleSet<UnderlyingType>::UnlimitedLookAhead)))
         {
-            if (m_reader.GetChar(ch))
-            {
-                extendedTerm += ch;
-                firstMatch = FirstMatch(currentTerm + extendedTerm);
-                if (firstMatch == GetTokenizerRules<UnderlyingType>().end())
-                {
-                    m_reader.RestoreChars(extendedTerm, lastLocation);
-                    extendedTerm = {};
-                    firstMatch = lastMatch;
-                    break;
-                }
-            }
-            else if (firstMatch != GetTokenizerRules<UnderlyingType>().end())
-            {
-                currentTerm += extendedTerm;
-                extendedTerm = {};
-                lastLocation = m_reader.GetLocation();
-                break;
-            }
+            auto offset = m_reader.GetOffset();
+            auto runLength = CharacterScanner::Skip(m_reader.GetText(offset, m_reader.GetSize() - offset), run);
+            m_reader.Seek(offset + runLength);
+            length += runLength;
         }
-        match = firstMatch;
+        if (rule != TokenizerAutomaton::NoRule)
+        {
+            acceptRule = rule;
+            acceptLength = length;
+        }
+        else if ((acceptRule != TokenizerAutomaton::NoRule) && (length - acceptLength > maxLookAheadCharacters))
+        {
+            break;
+        }
+    }
+    m_scanEnd = m_reader.GetOffset();
+    if (acceptRule != TokenizerAutomaton::NoRule)
+    {
+        if (length > acceptLength)
+        {
+            m_reader.Rewind(length - acceptLength);
+        }
+        return m_ruleSet.Rules()[static_cast<size_t>(acceptRule)].Type();
+    }
+    if (length > 0)
+    {
+        return TokenType<UnderlyingType>::InvalidToken;
     }
-    if (!extendedTerm.empty())
+    return {};
+}
+
+// Fallback for rule sets that could not be compiled into an automaton.
+// Regular expressions cannot tell that no longer match is possible, so an unlimited lookahead window is bounded
+// to RegexLookAheadCharacters here.
+template<typename UnderlyingType>
+TokenType<UnderlyingType> Tokenizer<UnderlyingType>::ReadTokenRegex()
+{
+    const size_t RegexLookAheadCharacters = 10;
+    auto maxLookAheadCharacters = m_ruleSet.MaxLookAheadCharacters();
+    if (maxLookAheadCharacters == TokenizerRuleSet<UnderlyingType>::UnlimitedLookAhead)
+        maxLookAheadCharacters = RegexLookAheadCharacters;
+    auto startOffset = m_reader.GetOffset();
+    char ch;
+    size_t length{};
+    auto match = m_ruleSet.Rules().end();
+    size_t matchLength{};
+
+    while (m_reader.GetChar(ch))
     {
-        m_reader.RestoreChars(extendedTerm, lastLocation);
+        ++length;
+        auto firstMatch = FirstMatch(m_reader.GetText(startOffset, length));
+        if (firstMatch != m_ruleSet.Rules().end())
+        {
+            match = firstMatch;
+            matchLength = length;
+        }
+        else if ((match != m_ruleSet.Rules().end()) && (length - matchLength > maxLookAheadCharacters))
+        {
+            break;
+        }
     }
-    if (match != GetTokenizerRules<UnderlyingType>().end())
+    m_scanEnd = m_reader.GetOffset();
+    if (match != m_ruleSet.Rules().end())
     {
-        token = Token(match->Type(), currentTerm, startLocation, lastLocation);
+        if (length > matchLength)
+        {
+            m_reader.Rewind(length - matchLength);
+        }
+        return match->Type();
     }
-    if (token.IsNull() && !currentTerm.empty())
+    if (length > 0)
     {
-        token = Token(TokenType<UnderlyingType>::InvalidToken, currentTerm, startLocation, m_reader.GetLocation());
+        return TokenType<UnderlyingType>::InvalidToken;
     }
-    return token;
+    return {};
+}
+
+// Lexes a caller owned source buffer at once. The token stream refers to the buffer, which must outlive it.
+template<typename UnderlyingType>
+TokenStream<UnderlyingType> Tokenize(const TokenizerRuleSet<UnderlyingType>& ruleSet, const std::filesystem::path& compilationUnit, std::string_view source,
+                                     std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+{
+    Tokenizer<UnderlyingType> tokenizer(ruleSet, compilationUnit, source);
+    return tokenizer.Tokenize(resource);
 }
 
 } // namespace parser
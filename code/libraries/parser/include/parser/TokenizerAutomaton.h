@@ -0,0 +1,56 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "parser/CharacterScanner.h"
+
+namespace parser {
+
+// Deterministic finite automaton compiled from the regular expressions of a set of tokenizer rules.
+// Every accepting state records the index of the first rule (in rule order) that matches the text read so far,
+// so the longest match, with rule order as priority, can be found in a single pass over the input.
+// Supported is the subset of ECMAScript syntax used by tokenizer rules: literals and escapes, character classes
+// (including [[:name:]] classes and \d \s \w), '.', grouping, alternation, greedy and lazy quantifiers, and the
+// anchors ^ and $ (which assert the start and end of the token). Anything else (backreferences, lookahead, word
+// boundaries) makes compilation fail, in which case the tokenizer falls back to matching the regular expressions.
+// States that loop back to themselves on a set of characters, such as inside whitespace, identifiers, comments and
+// strings, have a run of those characters, which the tokenizer can skip at once using the CharacterScanner.
+class TokenizerAutomaton
+{
+public:
+    using State = std::uint32_t;
+    static constexpr State DeadState = 0;
+    static constexpr int NoRule = -1;
+
+private:
+    bool m_isValid;
+    std::array<std::uint8_t, 256> m_characterClasses;
+    std::size_t m_numCharacterClasses;
+    std::vector<State> m_transitions;
+    std::vector<int> m_acceptRules;
+    std::vector<CharacterRun> m_runs;
+    State m_startState;
+
+public:
+    TokenizerAutomaton();
+
+    bool Compile(const std::vector<std::string>& patterns);
+    void Clear();
+
+    bool IsValid() const { return m_isValid; }
+    State StartState() const { return m_startState; }
+    State Next(State state, char ch) const
+    {
+        return m_transitions[state * m_numCharacterClasses + m_characterClasses[static_cast<unsigned char>(ch)]];
+    }
+    bool IsDead(State state) const { return state == DeadState; }
+    int AcceptRule(State state) const { return m_acceptRules[state]; }
+    const CharacterRun& Run(State state) const { return m_runs[state]; }
+    std::size_t NumStates() const { return m_acceptRules.size(); }
+    std::size_t NumCharacterClasses() const { return m_numCharacterClasses; }
+    int Match(const std::string& text) const;
+};
+
+} // namespace parser
@@ -3,6 +3,7 @@
 #include "parser/Token.h"
 
 #include <regex>
+#include <string_view>
 
 namespace parser {
 
@@ -10,8 +11,6 @@ template<typename UnderlyingType>
 class TokenizerRule
 {
 public:
-    static std::vector<TokenizerRule<UnderlyingType>> tokenizerRules;
-
     std::string ConvertRegexCaseInsensitive(const std::string& regex)
     {
         std::string result;
@@ -33,18 +32,21 @@ public:
     }
 
     TokenizerRule(const std::string& regex, const TokenType<UnderlyingType>& type, bool caseInsensitive = false)
-        : m_regex(caseInsensitive ? ConvertRegexCaseInsensitive(regex) : regex)
+        : m_pattern(caseInsensitive ? ConvertRegexCaseInsensitive(regex) : regex)
+        , m_regex(m_pattern)
         , m_type(type)
     {
     }
 
-    bool Matches(const std::string& text) const
+    bool Matches(std::string_view text) const
     {
-        return std::regex_match(text, m_regex);
+        return std::regex_match(text.begin(), text.end(), m_regex);
     }
+    const std::string& Pattern() const { return m_pattern; }
     TokenType<UnderlyingType> Type() const { return m_type; }
 
 private:
+    std::string m_pattern;
     std::regex m_regex;
     TokenType<UnderlyingType> m_type;
 };
@@ -52,19 +54,4 @@ private:
 template<typename UnderlyingType>
 using TokenizerRules = std::vector<TokenizerRule<UnderlyingType>>;
 
-template<typename UnderlyingType>
-std::vector<TokenizerRule<UnderlyingType>> TokenizerRule<UnderlyingType>::tokenizerRules{};
-
-template<typename UnderlyingType>
-void SetTokenizerRules(const TokenizerRules<UnderlyingType>& rules)
-{
-    TokenizerRule<UnderlyingType>::tokenizerRules = rules;
-}
-
-template<typename UnderlyingType>
-const TokenizerRules<UnderlyingType>& GetTokenizerRules()
-{
-    return TokenizerRule<UnderlyingType>::tokenizerRules;
-}
-
 } // namespace parser
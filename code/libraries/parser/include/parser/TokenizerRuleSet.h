@@ -0,0 +1,53 @@
+#pragma once
+
+#include <limits>
+#include "parser/TokenizerAutomaton.h"
+#include "parser/TokenizerRule.h"
+#include "parser/TokenType.h"
+
+namespace parser {
+
+// Immutable set of tokenizer rules for a grammar, with the automaton compiled from it.
+// A rule set is built once per grammar and shared by reference between all tokenizers for that grammar,
+// which can then run concurrently.
+// The lookahead window is the number of characters a tokenizer reads beyond the longest match found so far,
+// looking for a longer match. By default it is unlimited, so the longest match is always found.
+template<typename UnderlyingType>
+class TokenizerRuleSet
+{
+public:
+    static constexpr std::size_t UnlimitedLookAhead = std::numeric_limits<std::size_t>::max();
+
+private:
+    TokenizerRules<UnderlyingType> m_rules;
+    TokenizerAutomaton m_automaton;
+    std::size_t m_maxLookAheadCharacters;
+
+public:
+    explicit TokenizerRuleSet(const TokenizerRules<UnderlyingType>& rules, std::size_t maxLookAheadCharacters = UnlimitedLookAhead)
+        : m_rules{ rules }
+        , m_automaton{}
+        , m_maxLookAheadCharacters{ maxLookAheadCharacters }
+    {
+        std::vector<std::string> patterns;
+        for (auto const& rule : m_rules)
+        {
+            patterns.push_back(rule.Pattern());
+        }
+        m_automaton.Compile(patterns);
+    }
+    // Also registers the names of the token types, used when serializing tokens
+    TokenizerRuleSet(const TokenDefinitions<UnderlyingType>& definitions, const TokenizerRules<UnderlyingType>& rules, std::size_t maxLookAheadCharacters = UnlimitedLookAhead)
+        : TokenizerRuleSet(rules, maxLookAheadCharacters)
+    {
+        SetupTokenDefinitions(definitions);
+    }
+    TokenizerRuleSet(const TokenizerRuleSet&) = delete;
+    TokenizerRuleSet& operator = (const TokenizerRuleSet&) = delete;
+
+    const TokenizerRules<UnderlyingType>& Rules() const { return m_rules; }
+    const TokenizerAutomaton& Automaton() const { return m_automaton; }
+    std::size_t MaxLookAheadCharacters() const { return m_maxLookAheadCharacters; }
+};
+
+} // namespace parser
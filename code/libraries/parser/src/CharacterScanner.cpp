@@ -0,0 +1,221 @@
+#include "parser/CharacterScanner.h"
+
+#include <atomic>
+
+#if defined(_M_X64) || defined(__x86_64__)
+#define PARSER_SCANNER_X64
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#define PARSER_TARGET_AVX2
+#else
+#define PARSER_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+#endif
+
+namespace parser {
+
+namespace {
+
+std::size_t SkipScalar(const char* data, std::size_t size, const CharacterRun& run)
+{
+    std::size_t index{};
+    while ((index < size) && run.Contains(data[index]))
+        ++index;
+    return index;
+}
+
+#if defined(PARSER_SCANNER_X64)
+
+unsigned CountTrailingZeros(std::uint32_t value)
+{
+#if defined(_MSC_VER)
+    unsigned long index;
+    _BitScanForward(&index, value);
+    return static_cast<unsigned>(index);
+#else
+    return static_cast<unsigned>(__builtin_ctz(value));
+#endif
+}
+
+bool IsAVX2Supported()
+{
+#if defined(_MSC_VER)
+    int registers[4];
+    __cpuid(registers, 0);
+    if (registers[0] < 7)
+        return false;
+    __cpuid(registers, 1);
+    const int OSXSaveBit = 1 << 27;
+    const int AVXBit = 1 << 28;
+    if (((registers[2] & OSXSaveBit) == 0) || ((registers[2] & AVXBit) == 0))
+        return false;
+    // The operating system must save the AVX registers
+    if ((_xgetbv(0) & 0x6) != 0x6)
+        return false;
+    __cpuidex(registers, 7, 0);
+    const int AVX2Bit = 1 << 5;
+    return (registers[1] & AVX2Bit) != 0;
+#else
+    return __builtin_cpu_supports("avx2");
+#endif
+}
+
+// A byte is in the range [first, last] if byte - first <= last - first as unsigned values.
+// SSE2 has no unsigned compare, but a <= b is the same as max(a, b) == b.
+std::size_t SkipSSE2(const char* data, std::size_t size, const CharacterRun& run)
+{
+    __m128i first[CharacterRun::MaxRanges];
+    __m128i width[CharacterRun::MaxRanges];
+    auto numRanges = run.NumRanges();
+    for (std::size_t range = 0; range < numRanges; ++range)
+    {
+        first[range] = _mm_set1_epi8(static_cast<char>(run.First(range)));
+        width[range] = _mm_set1_epi8(static_cast<char>(run.Last(range) - run.First(range)));
+    }
+    std::uint32_t stopInvert = run.ContinueInRanges() ? 0xFFFFu : 0u;
+    std::size_t index{};
+    for (; index + 16 <= size; index += 16)
+    {
+        auto characters = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + index));
+        auto inRanges = _mm_setzero_si128();
+        for (std::size_t range = 0; range < numRanges; ++range)
+        {
+            auto offset = _mm_sub_epi8(characters, first[range]);
+            inRanges = _mm_or_si128(inRanges, _mm_cmpeq_epi8(_mm_max_epu8(offset, width[range]), width[range]));
+        }
+        auto stop = static_cast<std::uint32_t>(_mm_movemask_epi8(inRanges)) ^ stopInvert;
+        if (stop != 0)
+            return index + CountTrailingZeros(stop);
+    }
+    return index + SkipScalar(data + index, size - index, run);
+}
+
+PARSER_TARGET_AVX2
+std::size_t SkipAVX2(const char* data, std::size_t size, const CharacterRun& run)
+{
+    __m256i first[CharacterRun::MaxRanges];
+    __m256i width[CharacterRun::MaxRanges];
+    auto numRanges = run.NumRanges();
+    for (std::size_t range = 0; range < numRanges; ++range)
+    {
+        first[range] = _mm256_set1_epi8(static_cast<char>(run.First(range)));
+        width[range] = _mm256_set1_epi8(static_cast<char>(run.Last(range) - run.First(range)));
+    }
+    std::uint32_t stopInvert = run.ContinueInRanges() ? 0xFFFFFFFFu : 0u;
+    std::size_t index{};
+    for (; index + 32 <= size; index += 32)
+    {
+        auto characters = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + index));
+        auto inRanges = _mm256_setzero_si256();
+        for (std::size_t range = 0; range < numRanges; ++range)
+        {
+            auto offset = _mm256_sub_epi8(characters, first[range]);
+            inRanges = _mm256_or_si256(inRanges, _mm256_cmpeq_epi8(_mm256_max_epu8(offset, width[range]), width[range]));
+        }
+        auto stop = static_cast<std::uint32_t>(_mm256_movemask_epi8(inRanges)) ^ stopInvert;
+        if (stop != 0)
+            return index + CountTrailingZeros(stop);
+    }
+    return index + SkipSSE2(data + index, size - index, run);
+}
+
+ScanLevel DetectLevel()
+{
+    return IsAVX2Supported() ? ScanLevel::AVX2 : ScanLevel::SSE2;
+}
+
+#else
+
+ScanLevel DetectLevel()
+{
+    return ScanLevel::Scalar;
+}
+
+#endif
+
+std::atomic<ScanLevel>& CurrentLevel()
+{
+    static std::atomic<ScanLevel> level{ CharacterScanner::SupportedLevel() };
+    return level;
+}
+
+} // namespace
+
+CharacterRun::CharacterRun()
+    : m_first{}
+    , m_last{}
+    , m_numRanges{}
+    , m_continueInRanges{ true }
+{
+}
+
+CharacterRun CharacterRun::FromSet(const std::bitset<256>& characters)
+{
+    if (characters.none())
+        return {};
+    for (auto continueInRanges : { true, false })
+    {
+        CharacterRun result;
+        result.m_continueInRanges = continueInRanges;
+        std::size_t ch{};
+        while (ch < characters.size())
+        {
+            if (characters.test(ch) != continueInRanges)
+            {
+                ++ch;
+                continue;
+            }
+            if (result.m_numRanges == MaxRanges)
+            {
+                result.m_numRanges = MaxRanges + 1;
+                break;
+            }
+            auto first = ch;
+            while ((ch < characters.size()) && (characters.test(ch) == continueInRanges))
+                ++ch;
+            result.m_first[result.m_numRanges] = static_cast<std::uint8_t>(first);
+            result.m_last[result.m_numRanges] = static_cast<std::uint8_t>(ch - 1);
+            ++result.m_numRanges;
+        }
+        if (result.m_numRanges <= MaxRanges)
+            return result;
+    }
+    return {};
+}
+
+ScanLevel CharacterScanner::SupportedLevel()
+{
+    static const ScanLevel supportedLevel = DetectLevel();
+    return supportedLevel;
+}
+
+ScanLevel CharacterScanner::Level()
+{
+    return CurrentLevel();
+}
+
+void CharacterScanner::SetLevel(ScanLevel level)
+{
+    CurrentLevel() = (level < SupportedLevel()) ? level : SupportedLevel();
+}
+
+std::size_t CharacterScanner::Skip(std::string_view text, const CharacterRun& run)
+{
+    if (run.IsEmpty())
+        return 0;
+#if defined(PARSER_SCANNER_X64)
+    switch (CurrentLevel().load(std::memory_order_relaxed))
+    {
+    case ScanLevel::AVX2:
+        return SkipAVX2(text.data(), text.size(), run);
+    case ScanLevel::SSE2:
+        return SkipSSE2(text.data(), text.size(), run);
+    default:
+        break;
+    }
+#endif
+    return SkipScalar(text.data(), text.size(), run);
+}
+
+} // namespace parser
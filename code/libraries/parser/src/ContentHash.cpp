@@ -0,0 +1,111 @@
+#include "parser/ContentHash.h"
+
+#include <cstring>
+
+namespace parser {
+
+namespace {
+
+constexpr std::uint64_t Prime1 = 0x9E3779B185EBCA87ull;
+constexpr std::uint64_t Prime2 = 0xC2B2AE3D27D4EB4Full;
+constexpr std::uint64_t Prime3 = 0x165667B19E3779F9ull;
+constexpr std::uint64_t Prime4 = 0x85EBCA77C2B2AE63ull;
+constexpr std::uint64_t Prime5 = 0x27D4EB2F165667C5ull;
+
+std::uint64_t RotateLeft(std::uint64_t value, int bits)
+{
+    return (value << bits) | (value >> (64 - bits));
+}
+
+// The hash is defined on little endian values
+std::uint64_t Read64(const char* data)
+{
+    unsigned char bytes[8];
+    std::memcpy(bytes, data, sizeof(bytes));
+    std::uint64_t result{};
+    for (int index = 7; index >= 0; --index)
+    {
+        result = (result << 8) | bytes[index];
+    }
+    return result;
+}
+
+std::uint64_t Read32(const char* data)
+{
+    unsigned char bytes[4];
+    std::memcpy(bytes, data, sizeof(bytes));
+    return std::uint64_t{ bytes[0] } | (std::uint64_t{ bytes[1] } << 8) | (std::uint64_t{ bytes[2] } << 16) | (std::uint64_t{ bytes[3] } << 24);
+}
+
+std::uint64_t Round(std::uint64_t accumulator, std::uint64_t input)
+{
+    accumulator += input * Prime2;
+    accumulator = RotateLeft(accumulator, 31);
+    return accumulator * Prime1;
+}
+
+std::uint64_t MergeRound(std::uint64_t accumulator, std::uint64_t value)
+{
+    accumulator ^= Round(0, value);
+    return accumulator * Prime1 + Prime4;
+}
+
+} // namespace
+
+std::uint64_t ContentHash(std::string_view text, std::uint64_t seed)
+{
+    auto data = text.data();
+    auto end = data + text.size();
+    std::uint64_t hash{};
+
+    if (text.size() >= 32)
+    {
+        std::uint64_t v1 = seed + Prime1 + Prime2;
+        std::uint64_t v2 = seed + Prime2;
+        std::uint64_t v3 = seed;
+        std::uint64_t v4 = seed - Prime1;
+        for (; data + 32 <= end; data += 32)
+        {
+            v1 = Round(v1, Read64(data));
+            v2 = Round(v2, Read64(data + 8));
+            v3 = Round(v3, Read64(data + 16));
+            v4 = Round(v4, Read64(data + 24));
+        }
+        hash = RotateLeft(v1, 1) + RotateLeft(v2, 7) + RotateLeft(v3, 12) + RotateLeft(v4, 18);
+        hash = MergeRound(hash, v1);
+        hash = MergeRound(hash, v2);
+        hash = MergeRound(hash, v3);
+        hash = MergeRound(hash, v4);
+    }
+    else
+    {
+        hash = seed + Prime5;
+    }
+    hash += text.size();
+
+    for (; data + 8 <= end; data += 8)
+    {
+        hash ^= Round(0, Read64(data));
+        hash = RotateLeft(hash, 27) * Prime1 + Prime4;
+    }
+    if (data + 4 <= end)
+    {
+        hash ^= Read32(data) * Prime1;
+        hash = RotateLeft(hash, 23) * Prime2 + Prime3;
+        data += 4;
+    }
+    for (; data < end; ++data)
+    {
+        hash ^= static_cast<unsigned char>(*data) * Prime5;
+        hash = RotateLeft(hash, 11) * Prime1;
+    }
+
+    hash ^= hash >> 33;
+    hash *= Prime2;
+    hash ^= hash >> 29;
+    hash *= Prime3;
+    hash ^= hash >> 32;
+    return hash;
+}
+
+} // namespace parser
@@ -0,0 +1,116 @@
+#include "parser/FileTable.h"
+
+#include <algorithm>
+#include "parser/ContentHash.h"
+
+namespace parser {
+
+FileTable::Mutex FileTable::m_mutex{};
+std::vector<std::unique_ptr<FileTable::Entry>> FileTable::m_entries{};
+std::map<std::filesystem::path, FileTable::Unit> FileTable::m_units{};
+
+static std::uint64_t LineIndexHash(const std::vector<std::uint32_t>& lineStarts, const std::vector<std::uint32_t>& carriageReturns)
+{
+    auto hash = ContentHash(std::string_view(reinterpret_cast<const char*>(lineStarts.data()), lineStarts.size() * sizeof(std::uint32_t)));
+    return ContentHash(std::string_view(reinterpret_cast<const char*>(carriageReturns.data()), carriageReturns.size() * sizeof(std::uint32_t)), hash);
+}
+
+const FileTable::Entry& FileTable::GetEntry(FileId fileId)
+{
+    static const std::filesystem::path noPath{};
+    static const Entry noFile{ &noPath, false, {}, {} };
+    if ((fileId == NoFile) || (fileId > m_entries.size()))
+        return noFile;
+    return *m_entries[fileId - 1];
+}
+
+// Returns the unit with the path, adding it with a file id without text if it is not known yet
+FileTable::Unit& FileTable::GetUnit(const std::filesystem::path& unitPath)
+{
+    auto it = m_units.find(unitPath);
+    if (it != m_units.end())
+        return it->second;
+    it = m_units.emplace(unitPath, Unit{ NoFile, {} }).first;
+    m_entries.push_back(std::make_unique<Entry>(Entry{ &it->first, false, {}, {} }));
+    it->second.fileId = static_cast<FileId>(m_entries.size());
+    return it->second;
+}
+
+FileId FileTable::Intern(const std::filesystem::path& unitPath)
+{
+    if (unitPath.empty())
+        return NoFile;
+    WriteLock lock(m_mutex);
+    return GetUnit(unitPath).fileId;
+}
+
+FileId FileTable::Register(const std::filesystem::path& unitPath, std::string_view text)
+{
+    std::vector<std::uint32_t> lineStarts{ 0 };
+    std::vector<std::uint32_t> carriageReturns;
+    for (std::size_t offset = 0; offset < text.size(); ++offset)
+    {
+        if (text[offset] == '\n')
+            lineStarts.push_back(static_cast<std::uint32_t>(offset + 1));
+        else if (text[offset] == '\r')
+            carriageReturns.push_back(static_cast<std::uint32_t>(offset + 1));
+    }
+    auto hash = LineIndexHash(lineStarts, carriageReturns);
+
+    WriteLock lock(m_mutex);
+    auto& unit = GetUnit(unitPath);
+    auto range = unit.textFileIds.equal_range(hash);
+    for (auto it = range.first; it != range.second; ++it)
+    {
+        auto const& existing = *m_entries[it->second - 1];
+        if ((existing.lineStarts == lineStarts) && (existing.carriageReturns == carriageReturns))
+            return it->second;
+    }
+    auto& interned = *m_entries[unit.fileId - 1];
+    FileId fileId{};
+    if (!interned.hasText)
+    {
+        // The first text of the unit uses the file id of the interned path
+        interned.hasText = true;
+        interned.lineStarts = std::move(lineStarts);
+        interned.carriageReturns = std::move(carriageReturns);
+        fileId = unit.fileId;
+    }
+    else
+    {
+        m_entries.push_back(std::make_unique<Entry>(Entry{ interned.path, true, std::move(lineStarts), std::move(carriageReturns) }));
+        fileId = static_cast<FileId>(m_entries.size());
+    }
+    unit.textFileIds.emplace(hash, fileId);
+    return fileId;
+}
+
+const std::filesystem::path& FileTable::UnitPath(FileId fileId)
+{
+    ReadLock lock(m_mutex);
+    return *GetEntry(fileId).path;
+}
+
+std::pair<int, int> FileTable::LineAndColumn(FileId fileId, std::uint32_t offset)
+{
+    ReadLock lock(m_mutex);
+    auto const& entry = GetEntry(fileId);
+    if (!entry.hasText)
+        return {};
+    auto lineStart = std::upper_bound(entry.lineStarts.begin(), entry.lineStarts.end(), offset);
+    auto line = lineStart - entry.lineStarts.begin();
+    auto columnStart = *(lineStart - 1);
+    // A carriage return resets the column without starting a new line
+    auto carriageReturn = std::upper_bound(entry.carriageReturns.begin(), entry.carriageReturns.end(), offset);
+    if ((carriageReturn != entry.carriageReturns.begin()) && (*(carriageReturn - 1) > columnStart))
+        columnStart = *(carriageReturn - 1);
+    return { static_cast<int>(line), static_cast<int>(offset - columnStart + 1) };
+}
+
+std::size_t FileTable::Size()
+{
+    ReadLock lock(m_mutex);
+    return m_entries.size();
+}
+
+} // namespace parser
@@ -0,0 +1,69 @@
+#include "parser/ParseArena.h"
+
+#include <cstring>
+#include <new>
+
+namespace parser {
+
+ParseArena::HeapResource::HeapResource()
+    : m_bytesReserved{}
+{
+}
+
+void* ParseArena::HeapResource::do_allocate(std::size_t bytes, std::size_t alignment)
+{
+    auto pointer = ::operator new(bytes, std::align_val_t{ alignment });
+    m_bytesReserved += bytes;
+    return pointer;
+}
+
+void ParseArena::HeapResource::do_deallocate(void* pointer, std::size_t bytes, std::size_t alignment)
+{
+    ::operator delete(pointer, bytes, std::align_val_t{ alignment });
+    m_bytesReserved -= bytes;
+}
+
+bool ParseArena::HeapResource::do_is_equal(const std::pmr::memory_resource& other) const noexcept
+{
+    return this == &other;
+}
+
+ParseArena::ParseArena(std::size_t blockSize)
+    : m_heap{}
+    , m_resource{ blockSize, &m_heap }
+    , m_destructors{}
+{
+}
+
+ParseArena::~ParseArena()
+{
+    Release();
+}
+
+void* ParseArena::Allocate(std::size_t bytes, std::size_t alignment)
+{
+    return m_resource.allocate(bytes, alignment);
+}
+
+std::string_view ParseArena::CopyString(std::string_view text)
+{
+    if (text.empty())
+        return {};
+    auto data = static_cast<char*>(Allocate(text.size(), alignof(char)));
+    std::memcpy(data, text.data(), text.size());
+    return std::string_view(data, text.size());
+}
+
+void ParseArena::Release()
+{
+    // Objects are destroyed in reverse order of creation, as later objects may refer to earlier ones
+    while (m_destructors != nullptr)
+    {
+        auto destructor = m_destructors;
+        m_destructors = destructor->next;
+        destructor->destroy(destructor->object);
+    }
+    m_resource.release();
+}
+
+} // namespace parser
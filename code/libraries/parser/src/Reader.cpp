@@ -1,68 +1,86 @@
 #include "parser/Reader.h"
 
+#include <algorithm>
+#include <iterator>
+
 namespace parser {
 
-Reader::Reader(const std::filesystem::path& unitPath, std::istream& stream)
-    : m_unitPath{ unitPath }
-    , m_stream(stream)
-    , m_buffer{}
+Reader::Reader(const std::filesystem::path& unitPath, std::istream& stream, std::pmr::memory_resource* resource)
+    : m_streamData{ resource }
+    , m_source{}
+    , m_offset{}
     , m_endOfBuffer{}
-    , m_currentLocation{}
+    , m_fileId{}
+    , m_haveLocation{ stream.good() }
 {
-    if (m_stream.good())
+    if (stream.good())
     {
-        m_currentLocation = SourceLocation(m_unitPath, 1, 1);
+        m_streamData.assign(std::istreambuf_iterator<char>(stream), std::istreambuf_iterator<char>());
     }
+    m_source = m_streamData;
+    m_fileId = FileTable::Register(unitPath, m_source);
 }
 
-void Reader::Advance(char ch)
+Reader::Reader(const std::filesystem::path& unitPath, std::string_view source)
+    : m_streamData{}
+    , m_source{ source }
+    , m_offset{}
+    , m_endOfBuffer{}
+    , m_fileId{ FileTable::Register(unitPath, source) }
+    , m_haveLocation{ true }
+{
+}
+
+Reader::Reader(FileId fileId, std::string_view source)
+    : m_streamData{}
+    , m_source{ source }
+    , m_offset{}
+    , m_endOfBuffer{}
+    , m_fileId{ fileId }
+    , m_haveLocation{ true }
 {
-    switch (ch)
-    {
-        case '\n':
-            m_currentLocation.NextLine();
-            break;
-        case '\r':
-            m_currentLocation.ResetLine();
-            break;
-        default:
-            m_currentLocation.NextCol();
-            break;
-    }
 }
 
 bool Reader::GetChar(char & ch)
 {
     ch = {};
-    if (!m_buffer.empty())
+    if (m_offset < m_source.size())
     {
-        ch = m_buffer[0];
-        m_buffer = m_buffer.substr(1);
-        Advance(ch);
+        ch = m_source[m_offset++];
         return true;
     }
     m_endOfBuffer = true;
-    if (m_stream.good())
-    {
-        if (m_stream.get(ch))
-        {
-            Advance(ch);
-            return true;
-        }
-    }
     return false;
 }
 
-void Reader::RestoreChars(const std::string& restoreBuffer, const SourceLocation& restoreLocation)
+void Reader::RestoreChars(const std::string& restoreBuffer, const SourceLocation& /*restoreLocation*/)
 {
-    m_currentLocation = restoreLocation;
-    m_buffer = restoreBuffer + m_buffer;
+    // The restored characters are always the last ones read, so the location follows from the offset
+    Rewind(restoreBuffer.length());
+}
+
+void Reader::Rewind(std::size_t numChars)
+{
+    m_offset -= std::min(numChars, m_offset);
+    m_endOfBuffer = false;
+}
+
+void Reader::Seek(std::size_t offset)
+{
+    m_offset = std::min(offset, m_source.size());
     m_endOfBuffer = false;
 }
 
+const SourceLocation Reader::GetLocation(std::size_t offset) const
+{
+    if (!m_haveLocation)
+        return {};
+    return SourceLocation(m_fileId, static_cast<std::uint32_t>(std::min(offset, m_source.size())));
+}
+
 bool Reader::EndOfStream() const
 {
-    return m_endOfBuffer && m_stream.eof();
+    return m_endOfBuffer;
 }
 
-} // namespace parser
\ No newline at end of file
+} // namespace parser
@@ -1,59 +1,172 @@
 #include "parser/SourceLocation.h"
 
+#include <algorithm>
+#include <cassert>
+#include <map>
+#include <mutex>
+#include <stdexcept>
 #include <string>
+#include <utility>
+#include <vector>
 
 namespace parser {
 
+static const std::uint32_t LineColumnFlag = 0x80000000u;
+static const int ColumnBits = 11;
+// Column value marking a line and column that do not fit, the line bits then hold an index in the overflow table
+static const std::uint32_t OverflowColumn = (1u << ColumnBits) - 1;
+static const std::uint32_t MaxOverflowIndex = (1u << 20) - 1;
+
+namespace {
+
+// Lines and columns too large to pack, each distinct pair is stored once
+class OverflowTable
+{
+private:
+    std::mutex m_mutex;
+    std::vector<std::pair<int, int>> m_entries;
+    std::map<std::pair<int, int>, std::uint32_t> m_indices;
+
+public:
+    std::uint32_t Add(int line, int column)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto it = m_indices.find({ line, column });
+        if (it != m_indices.end())
+            return it->second;
+        auto index = static_cast<std::uint32_t>(m_entries.size());
+        if (index > MaxOverflowIndex)
+            throw std::length_error("Too many source locations with a line or column out of range");
+        m_entries.emplace_back(line, column);
+        m_indices.emplace(std::make_pair(line, column), index);
+        return index;
+    }
+    std::pair<int, int> Get(std::uint32_t index)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        assert(index < m_entries.size());
+        return m_entries[index];
+    }
+};
+
+OverflowTable& Overflow()
+{
+    static OverflowTable table;
+    return table;
+}
+
+} // namespace
+
 SourceLocation::SourceLocation()
-    : m_line{}
-    , m_col{}
+    : m_fileId{ FileTable::NoFile }
+    , m_position{ LineColumnFlag }
 {
 }
 
 SourceLocation::SourceLocation(const std::filesystem::path& unitPath)
-    : m_unitPath{ unitPath }
-    , m_line{}
-    , m_col{}
+    : m_fileId{ FileTable::Intern(unitPath) }
+    , m_position{ LineColumnFlag }
 {
 }
 
 SourceLocation::SourceLocation(const std::filesystem::path& unitPath, int line, int column)
-    : m_unitPath{ unitPath }
-    , m_line{ line }
-    , m_col{ column }
+    : m_fileId{ FileTable::Intern(unitPath) }
+    , m_position{}
+{
+    SetLineAndColumn(line, column);
+}
+
+SourceLocation::SourceLocation(FileId fileId, std::uint32_t offset)
+    : m_fileId{ fileId }
+    , m_position{ offset }
+{
+    // An offset with the top bit set cannot be told apart from a line and column, so it is resolved now
+    if (offset > MaxOffset)
+    {
+        auto lineAndColumn = FileTable::LineAndColumn(fileId, offset);
+        SetLineAndColumn(lineAndColumn.first, lineAndColumn.second);
+    }
+}
+
+void SourceLocation::SetLineAndColumn(int line, int column)
 {
+    // Negative values are not meaningful, they are taken as unknown, like 0
+    auto packedLine = static_cast<std::uint32_t>(std::max(line, 0));
+    auto packedColumn = static_cast<std::uint32_t>(std::max(column, 0));
+    if ((packedLine > MaxLine) || (packedColumn > MaxColumn))
+    {
+        packedLine = Overflow().Add(static_cast<int>(packedLine), static_cast<int>(packedColumn));
+        packedColumn = OverflowColumn;
+    }
+    m_position = LineColumnFlag | (packedLine << ColumnBits) | packedColumn;
 }
 
 void SourceLocation::NextCol()
 {
-    ++m_col;
+    SetLineAndColumn(Line(), Column() + 1);
 }
 
 void SourceLocation::ResetLine()
 {
-    m_col = 1;
+    SetLineAndColumn(Line(), 1);
 }
 
 void SourceLocation::NextLine()
 {
-    ++m_line;
-    ResetLine();
+    SetLineAndColumn(Line() + 1, 1);
+}
+
+const std::filesystem::path& SourceLocation::UnitPath() const
+{
+    return FileTable::UnitPath(m_fileId);
+}
+
+bool SourceLocation::HasOffset() const
+{
+    return (m_position & LineColumnFlag) == 0;
+}
+
+std::uint32_t SourceLocation::Offset() const
+{
+    return HasOffset() ? m_position : 0;
+}
+
+int SourceLocation::Line() const
+{
+    if (HasOffset())
+        return FileTable::LineAndColumn(m_fileId, m_position).first;
+    auto packedLine = (m_position & ~LineColumnFlag) >> ColumnBits;
+    if ((m_position & OverflowColumn) == OverflowColumn)
+        return Overflow().Get(packedLine).first;
+    return static_cast<int>(packedLine);
+}
+
+int SourceLocation::Column() const
+{
+    if (HasOffset())
+        return FileTable::LineAndColumn(m_fileId, m_position).second;
+    auto packedColumn = m_position & OverflowColumn;
+    if (packedColumn == OverflowColumn)
+        return Overflow().Get((m_position & ~LineColumnFlag) >> ColumnBits).second;
+    return static_cast<int>(packedColumn);
 }
 
 bool SourceLocation::IsValid() const
 {
-    return (m_line != 0) && (m_col != 0);
+    return (Line() != 0) && (Column() != 0);
 }
 
 std::string SourceLocation::Serialize() const
 {
     if (!IsValid())
         return "??";
-    return m_unitPath.generic_string() + "(" + std::to_string(m_line) + ":" + std::to_string(m_col) + ")";
+    return UnitPath().generic_string() + "(" + std::to_string(Line()) + ":" + std::to_string(Column()) + ")";
 }
 
 bool operator ==(const SourceLocation& lhs, const SourceLocation& rhs)
 {
+    if (lhs.HasOffset() && rhs.HasOffset() && (lhs.GetFileId() == rhs.GetFileId()) && (lhs.Offset() == rhs.Offset()))
+        return true;
     return (lhs.Line() == rhs.Line()) && (lhs.Column() == rhs.Column());
 }
 
@@ -67,4 +180,4 @@ std::ostream& operator << (std::ostream& stream, const SourceLocation& value)
     return stream << value.Serialize();
 }
 
-} // namespace parser
\ No newline at end of file
+} // namespace parser
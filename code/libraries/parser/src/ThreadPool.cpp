@@ -0,0 +1,120 @@
+#include "parser/ThreadPool.h"
+
+#include <algorithm>
+
+namespace parser {
+
+namespace {
+
+// Pool and index of the worker running on the current thread
+thread_local const ThreadPool* CurrentPool{};
+thread_local std::size_t CurrentWorker{};
+
+} // namespace
+
+ThreadPool::ThreadPool(std::size_t numThreads)
+    : m_workers{}
+    , m_threads{}
+    , m_mutex{}
+    , m_wakeUp{}
+    , m_queuedTasks{}
+    , m_stop{}
+    , m_nextWorker{}
+{
+    if (numThreads == 0)
+        numThreads = std::max(std::thread::hardware_concurrency(), 1u);
+    for (std::size_t index = 0; index < numThreads; ++index)
+    {
+        m_workers.push_back(std::make_unique<Worker>());
+    }
+    for (std::size_t index = 0; index < numThreads; ++index)
+    {
+        m_threads.emplace_back([this, index]() { Run(index); });
+    }
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stop = true;
+    }
+    m_wakeUp.notify_all();
+    for (auto& thread : m_threads)
+    {
+        thread.join();
+    }
+}
+
+ThreadPool& ThreadPool::Default()
+{
+    static ThreadPool pool;
+    return pool;
+}
+
+void ThreadPool::Submit(Task task)
+{
+    auto index = (CurrentPool == this) ? CurrentWorker : (m_nextWorker++ % m_workers.size());
+    // Count the task before it can be taken, so a worker never decrements the count below zero
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        ++m_queuedTasks;
+    }
+    {
+        std::lock_guard<std::mutex> lock(m_workers[index]->mutex);
+        m_workers[index]->tasks.push_back(std::move(task));
+    }
+    m_wakeUp.notify_one();
+}
+
+void ThreadPool::Run(std::size_t index)
+{
+    CurrentPool = this;
+    CurrentWorker = index;
+    for (;;)
+    {
+        Task task;
+        if (TryPop(index, task) || TrySteal(index, task))
+        {
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                --m_queuedTasks;
+            }
+            task();
+            continue;
+        }
+        std::unique_lock<std::mutex> lock(m_mutex);
+        if (m_stop && (m_queuedTasks == 0))
+            return;
+        m_wakeUp.wait(lock, [this]() { return m_stop || (m_queuedTasks != 0); });
+    }
+}
+
+bool ThreadPool::TryPop(std::size_t index, Task& task)
+{
+    auto& worker = *m_workers[index];
+    std::lock_guard<std::mutex> lock(worker.mutex);
+    if (worker.tasks.empty())
+        return false;
+    task = std::move(worker.tasks.back());
+    worker.tasks.pop_back();
+    return true;
+}
+
+bool ThreadPool::TrySteal(std::size_t index, Task& task)
+{
+    for (std::size_t offset = 1; offset < m_workers.size(); ++offset)
+    {
+        auto& worker = *m_workers[(index + offset) % m_workers.size()];
+        std::lock_guard<std::mutex> lock(worker.mutex);
+        if (!worker.tasks.empty())
+        {
+            task = std::move(worker.tasks.front());
+            worker.tasks.pop_front();
+            return true;
+        }
+    }
+    return false;
+}
+
+} // namespace parser
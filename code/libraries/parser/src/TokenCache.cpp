@@ -0,0 +1,132 @@
+#include "parser/TokenCache.h"
+
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <thread>
+
+namespace parser {
+
+namespace {
+
+const char Magic[4] = { 'P', 'T', 'O', 'K' };
+
+// Start of an entry, followed by the types, offsets and lengths of the tokens. The values are in the byte order of
+// the machine that wrote them, an entry written with another byte order does not match the format version.
+struct Header
+{
+    char magic[4];
+    std::uint32_t formatVersion;
+    std::uint64_t contentHash;
+    std::uint64_t sourceSize;
+    std::uint64_t grammarId;
+    std::uint64_t numTokens;
+};
+
+std::string Hex(std::uint64_t value)
+{
+    std::ostringstream stream;
+    stream << std::hex << std::setw(16) << std::setfill('0') << value;
+    return stream.str();
+}
+
+bool ReadArray(std::istream& stream, std::vector<std::uint32_t>& values, std::size_t size)
+{
+    values.resize(size);
+    return static_cast<bool>(stream.read(reinterpret_cast<char*>(values.data()), static_cast<std::streamsize>(size * sizeof(std::uint32_t))));
+}
+
+void WriteArray(std::ostream& stream, const std::vector<std::uint32_t>& values)
+{
+    stream.write(reinterpret_cast<const char*>(values.data()), static_cast<std::streamsize>(values.size() * sizeof(std::uint32_t)));
+}
+
+} // namespace
+
+TokenCache::TokenCache(const std::filesystem::path& directory)
+    : m_directory{ directory }
+{
+}
+
+std::filesystem::path TokenCache::EntryPath(const TokenCacheKey& key) const
+{
+    return m_directory / (Hex(key.contentHash) + "-" + Hex(key.grammarId) + ".tokens");
+}
+
+bool TokenCache::ReadEntry(const TokenCacheKey& key, Entry& entry) const
+{
+    auto path = EntryPath(key);
+    std::error_code error;
+    auto fileSize = std::filesystem::file_size(path, error);
+    if (error)
+        return false;
+    std::ifstream stream(path, std::ios::binary);
+    Header header{};
+    if (!stream.read(reinterpret_cast<char*>(&header), sizeof(header)))
+        return false;
+    if ((std::memcmp(header.magic, Magic, sizeof(Magic)) != 0) ||
+        (header.formatVersion != FormatVersion) ||
+        (header.contentHash != key.contentHash) ||
+        (header.sourceSize != key.sourceSize) ||
+        (header.grammarId != key.grammarId) ||
+        (fileSize < sizeof(header)))
+        return false;
+    // Check the number of tokens before computing the size of the arrays, which could overflow for a corrupt header
+    auto tokenSize = 3 * sizeof(std::uint32_t);
+    if ((header.numTokens > (fileSize - sizeof(header)) / tokenSize) ||
+        (fileSize != sizeof(header) + header.numTokens * tokenSize))
+        return false;
+    auto numTokens = static_cast<std::size_t>(header.numTokens);
+    if (!ReadArray(stream, entry.types, numTokens) ||
+        !ReadArray(stream, entry.offsets, numTokens) ||
+        !ReadArray(stream, entry.lengths, numTokens))
+        return false;
+    for (std::size_t index = 0; index < numTokens; ++index)
+    {
+        if (std::uint64_t{ entry.offsets[index] } + entry.lengths[index] > key.sourceSize)
+            return false;
+    }
+    return true;
+}
+
+bool TokenCache::WriteEntry(const TokenCacheKey& key, const Entry& entry) const
+{
+    std::error_code error;
+    std::filesystem::create_directories(m_directory, error);
+    auto path = EntryPath(key);
+    auto uniqueSuffix = std::hash<std::thread::id>{}(std::this_thread::get_id()) ^
+        static_cast<std::size_t>(std::chrono::steady_clock::now().time_since_epoch().count());
+    auto temporaryPath = path;
+    temporaryPath += ".tmp" + std::to_string(uniqueSuffix);
+    {
+        std::ofstream stream(temporaryPath, std::ios::binary | std::ios::trunc);
+        Header header{};
+        std::memcpy(header.magic, Magic, sizeof(Magic));
+        header.formatVersion = FormatVersion;
+        header.contentHash = key.contentHash;
+        header.sourceSize = key.sourceSize;
+        header.grammarId = key.grammarId;
+        header.numTokens = entry.types.size();
+        stream.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        WriteArray(stream, entry.types);
+        WriteArray(stream, entry.offsets);
+        WriteArray(stream, entry.lengths);
+        if (!stream.flush())
+        {
+            stream.close();
+            std::filesystem::remove(temporaryPath, error);
+            return false;
+        }
+    }
+    std::filesystem::rename(temporaryPath, path, error);
+    if (error)
+    {
+        std::filesystem::remove(temporaryPath, error);
+        return false;
+    }
+    return true;
+}
+
+} // namespace parser
@@ -0,0 +1,808 @@
+#include "parser/TokenizerAutomaton.h"
+
+#include <algorithm>
+#include <bitset>
+#include <cctype>
+#include <map>
+#include <memory>
+
+namespace parser {
+
+namespace {
+
+using CharacterSet = std::bitset<256>;
+
+const std::size_t MaxRepeatCount = 256;
+const std::size_t MaxDFAStates = 65536;
+
+class SyntaxError
+{
+};
+
+enum class NodeType
+{
+    Empty,
+    Characters,
+    Sequence,
+    Alternation,
+    Repeat,
+    TokenStart,
+    TokenEnd,
+};
+
+struct Node
+{
+    NodeType type;
+    CharacterSet characters;
+    std::vector<std::unique_ptr<Node>> children;
+    std::size_t minCount;
+    std::size_t maxCount;
+    bool unbounded;
+
+    explicit Node(NodeType nodeType)
+        : type{ nodeType }
+        , characters{}
+        , children{}
+        , minCount{}
+        , maxCount{}
+        , unbounded{}
+    {
+    }
+};
+using NodePtr = std::unique_ptr<Node>;
+
+CharacterSet MakeSet(int (*predicate)(int))
+{
+    CharacterSet result;
+    for (int ch = 0; ch < 128; ++ch)
+    {
+        if (predicate(ch))
+            result.set(static_cast<std::size_t>(ch));
+    }
+    return result;
+}
+
+CharacterSet MakeSet(const std::string& characters)
+{
+    CharacterSet result;
+    for (auto ch : characters)
+        result.set(static_cast<unsigned char>(ch));
+    return result;
+}
+
+int IsWordCharacter(int ch)
+{
+    return std::isalnum(ch) || (ch == '_');
+}
+
+// Parser for the regular expression subset documented in TokenizerAutomaton.h
+class RegexParser
+{
+private:
+    const std::string& m_pattern;
+    std::size_t m_index;
+
+public:
+    explicit RegexParser(const std::string& pattern)
+        : m_pattern{ pattern }
+        , m_index{}
+    {
+    }
+
+    NodePtr Parse()
+    {
+        auto result = ParseAlternation();
+        if (!AtEnd())
+            throw SyntaxError();
+        return result;
+    }
+
+private:
+    bool AtEnd() const { return m_index >= m_pattern.length(); }
+    char Peek(std::size_t offset = 0) const
+    {
+        return (m_index + offset < m_pattern.length()) ? m_pattern[m_index + offset] : '\0';
+    }
+    char Get()
+    {
+        if (AtEnd())
+            throw SyntaxError();
+        return m_pattern[m_index++];
+    }
+
+    NodePtr ParseAlternation()
+    {
+        auto first = ParseSequence();
+        if (Peek() != '|')
+            return first;
+        auto result = std::make_unique<Node>(NodeType::Alternation);
+        result->children.push_back(std::move(first));
+        while (!AtEnd() && (Peek() == '|'))
+        {
+            Get();
+            result->children.push_back(ParseSequence());
+        }
+        return result;
+    }
+
+    NodePtr ParseSequence()
+    {
+        auto result = std::make_unique<Node>(NodeType::Sequence);
+        while (!AtEnd() && (Peek() != '|') && (Peek() != ')'))
+        {
+            result->children.push_back(ParseRepeat());
+        }
+        return result;
+    }
+
+    NodePtr ParseRepeat()
+    {
+        auto atom = ParseAtom();
+        std::size_t minCount{};
+        std::size_t maxCount{};
+        bool unbounded{};
+        switch (Peek())
+        {
+        case '*':
+            Get();
+            unbounded = true;
+            break;
+        case '+':
+            Get();
+            minCount = 1;
+            unbounded = true;
+            break;
+        case '?':
+            Get();
+            maxCount = 1;
+            break;
+        case '{':
+            Get();
+            ParseRepeatCount(minCount, maxCount, unbounded);
+            break;
+        default:
+            return atom;
+        }
+        if ((atom->type == NodeType::TokenStart) || (atom->type == NodeType::TokenEnd))
+            throw SyntaxError();
+        // Lazy and greedy quantifiers accept the same set of complete matches
+        if (Peek() == '?')
+            Get();
+        auto result = std::make_unique<Node>(NodeType::Repeat);
+        result->minCount = minCount;
+        result->maxCount = maxCount;
+        result->unbounded = unbounded;
+        result->children.push_back(std::move(atom));
+        return result;
+    }
+
+    std::size_t ParseNumber()
+    {
+        if (!std::isdigit(static_cast<unsigned char>(Peek())))
+            throw SyntaxError();
+        std::size_t result{};
+        while (std::isdigit(static_cast<unsigned char>(Peek())))
+        {
+            result = result * 10 + static_cast<std::size_t>(Get() - '0');
+            if (result > MaxRepeatCount)
+                throw SyntaxError();
+        }
+        return result;
+    }
+
+    void ParseRepeatCount(std::size_t& minCount, std::size_t& maxCount, bool& unbounded)
+    {
+        minCount = ParseNumber();
+        maxCount = minCount;
+        if (Peek() == ',')
+        {
+            Get();
+            if (Peek() == '}')
+                unbounded = true;
+            else
+                maxCount = ParseNumber();
+        }
+        if ((Get() != '}') || (!unbounded && (maxCount < minCount)))
+            throw SyntaxError();
+    }
+
+    NodePtr ParseAtom()
+    {
+        char ch = Get();
+        switch (ch)
+        {
+        case '(':
+            {
+                if (Peek() == '?')
+                {
+                    // Only non-capturing groups, lookahead cannot be expressed in the automaton
+                    Get();
+                    if (Get() != ':')
+                        throw SyntaxError();
+                }
+                auto result = ParseAlternation();
+                if (Get() != ')')
+                    throw SyntaxError();
+                return result;
+            }
+        case '[':
+            return Characters(ParseBracket());
+        case '.':
+            return Characters(~MakeSet("\n\r"));
+        case '^':
+            return std::make_unique<Node>(NodeType::TokenStart);
+        case '$':
+            return std::make_unique<Node>(NodeType::TokenEnd);
+        case '\\':
+            {
+                CharacterSet characters;
+                ParseEscape(characters, false);
+                return Characters(characters);
+            }
+        case '*':
+        case '+':
+        case '?':
+        case '{':
+        case ')':
+        case '|':
+            throw SyntaxError();
+        default:
+            return Characters(MakeSet(std::string(1, ch)));
+        }
+    }
+
+    static NodePtr Characters(const CharacterSet& characters)
+    {
+        auto result = std::make_unique<Node>(NodeType::Characters);
+        result->characters = characters;
+        return result;
+    }
+
+    static int HexValue(char ch)
+    {
+        if (std::isdigit(static_cast<unsigned char>(ch)))
+            return ch - '0';
+        if ((ch >= 'a') && (ch <= 'f'))
+            return ch - 'a' + 10;
+        if ((ch >= 'A') && (ch <= 'F'))
+            return ch - 'A' + 10;
+        throw SyntaxError();
+    }
+
+    int ParseHex(std::size_t digits)
+    {
+        int result{};
+        for (std::size_t i = 0; i < digits; ++i)
+            result = result * 16 + HexValue(Get());
+        return result;
+    }
+
+    // Returns true if the escape denotes a single character
+    bool ParseEscape(CharacterSet& characters, bool inBracket)
+    {
+        char ch = Get();
+        int value{};
+        switch (ch)
+        {
+        case 'd': characters = MakeSet(std::isdigit); return false;
+        case 'D': characters = ~MakeSet(std::isdigit); return false;
+        case 's': characters = MakeSet(std::isspace); return false;
+        case 'S': characters = ~MakeSet(std::isspace); return false;
+        case 'w': characters = MakeSet(IsWordCharacter); return false;
+        case 'W': characters = ~MakeSet(IsWordCharacter); return false;
+        case 't': value = '\t'; break;
+        case 'n': value = '\n'; break;
+        case 'r': value = '\r'; break;
+        case 'f': value = '\f'; break;
+        case 'v': value = '\v'; break;
+        case '0': value = '\0'; break;
+        case 'x': value = ParseHex(2); break;
+        case 'u': value = ParseHex(4); break;
+        case 'c':
+            if (!std::isalpha(static_cast<unsigned char>(Peek())))
+                throw SyntaxError();
+            value = Get() % 32;
+            break;
+        case 'b':
+            // Word boundary outside brackets cannot be expressed, inside brackets it is a backspace
+            if (!inBracket)
+                throw SyntaxError();
+            value = '\b';
+            break;
+        default:
+            // Backreferences and word boundaries cannot be expressed, anything else is an identity escape
+            if (std::isdigit(static_cast<unsigned char>(ch)) || (ch == 'B'))
+                throw SyntaxError();
+            value = static_cast<unsigned char>(ch);
+            break;
+        }
+        if (value > 255)
+            throw SyntaxError();
+        characters.reset();
+        characters.set(static_cast<std::size_t>(value));
+        return true;
+    }
+
+    CharacterSet ParsePosixClass()
+    {
+        static const std::map<std::string, int (*)(int)> Classes{
+            { "alnum", std::isalnum },
+            { "alpha", std::isalpha },
+            { "blank", std::isblank },
+            { "cntrl", std::iscntrl },
+            { "digit", std::isdigit },
+            { "d", std::isdigit },
+            { "graph", std::isgraph },
+            { "lower", std::islower },
+            { "print", std::isprint },
+            { "punct", std::ispunct },
+            { "space", std::isspace },
+            { "s", std::isspace },
+            { "upper", std::isupper },
+            { "w", IsWordCharacter },
+            { "xdigit", std::isxdigit },
+        };
+        auto end = m_pattern.find(":]", m_index);
+        if (end == std::string::npos)
+            throw SyntaxError();
+        auto it = Classes.find(m_pattern.substr(m_index, end - m_index));
+        if (it == Classes.end())
+            throw SyntaxError();
+        m_index = end + 2;
+        return MakeSet(it->second);
+    }
+
+    // Parses a single bracket element, returns true if it is a single character
+    bool ParseBracketElement(CharacterSet& characters)
+    {
+        char ch = Get();
+        if ((ch == '[') && (Peek() == ':'))
+        {
+            Get();
+            characters = ParsePosixClass();
+            return false;
+        }
+        if ((ch == '[') && ((Peek() == '=') || (Peek() == '.')))
+            throw SyntaxError();
+        if (ch == '\\')
+            return ParseEscape(characters, true);
+        characters.reset();
+        characters.set(static_cast<unsigned char>(ch));
+        return true;
+    }
+
+    static std::size_t SingleCharacter(const CharacterSet& characters)
+    {
+        for (std::size_t ch = 0; ch < characters.size(); ++ch)
+        {
+            if (characters.test(ch))
+                return ch;
+        }
+        return 0;
+    }
+
+    CharacterSet ParseBracket()
+    {
+        CharacterSet result;
+        bool negate{};
+        if (Peek() == '^')
+        {
+            Get();
+            negate = true;
+        }
+        while (Peek() != ']')
+        {
+            CharacterSet first;
+            bool isSingle = ParseBracketElement(first);
+            if ((Peek() == '-') && (Peek(1) != ']') && !AtEnd())
+            {
+                Get();
+                CharacterSet last;
+                if (!isSingle || !ParseBracketElement(last))
+                    throw SyntaxError();
+                auto from = SingleCharacter(first);
+                auto to = SingleCharacter(last);
+                if (from > to)
+                    throw SyntaxError();
+                for (auto ch = from; ch <= to; ++ch)
+                    result.set(ch);
+            }
+            else
+            {
+                result |= first;
+            }
+        }
+        Get();
+        return negate ? ~result : result;
+    }
+};
+
+// Thompson construction of a nondeterministic automaton from the parsed rules
+class NFA
+{
+public:
+    struct State
+    {
+        int characterSet;
+        int next;
+        std::vector<int> epsilon;
+        std::vector<int> tokenStart;
+        std::vector<int> tokenEnd;
+        int acceptRule;
+    };
+    struct Fragment
+    {
+        int start;
+        int end;
+    };
+
+    std::vector<State> states;
+    std::vector<CharacterSet> characterSets;
+    int start;
+
+    NFA()
+        : states{}
+        , characterSets{}
+        , start{ NewState() }
+    {
+    }
+
+    void AddRule(const Node& node, int rule)
+    {
+        auto fragment = Build(node);
+        states[static_cast<std::size_t>(start)].epsilon.push_back(fragment.start);
+        states[static_cast<std::size_t>(fragment.end)].acceptRule = rule;
+    }
+
+    // Set of states reachable through epsilon transitions. Transitions that assert the end of the token are
+    // only followed to determine acceptance, as nothing can be consumed after them
+    void Closure(std::vector<int>& stateSet, bool atTokenStart, bool atTokenEnd) const
+    {
+        std::vector<bool> visited(states.size());
+        std::vector<int> stack{ stateSet };
+        for (auto state : stateSet)
+            visited[static_cast<std::size_t>(state)] = true;
+        auto visit = [&](int target)
+        {
+            if (!visited[static_cast<std::size_t>(target)])
+            {
+                visited[static_cast<std::size_t>(target)] = true;
+                stateSet.push_back(target);
+                stack.push_back(target);
+            }
+        };
+        while (!stack.empty())
+        {
+            auto const& state = states[static_cast<std::size_t>(stack.back())];
+            stack.pop_back();
+            for (auto target : state.epsilon)
+                visit(target);
+            if (atTokenStart)
+            {
+                for (auto target : state.tokenStart)
+                    visit(target);
+            }
+            if (atTokenEnd)
+            {
+                for (auto target : state.tokenEnd)
+                    visit(target);
+            }
+        }
+        std::sort(stateSet.begin(), stateSet.end());
+    }
+
+    int AcceptRule(const std::vector<int>& stateSet) const
+    {
+        std::vector<int> endClosure{ stateSet };
+        Closure(endClosure, false, true);
+        int result = TokenizerAutomaton::NoRule;
+        for (auto state : endClosure)
+        {
+            auto rule = states[static_cast<std::size_t>(state)].acceptRule;
+            if ((rule != TokenizerAutomaton::NoRule) && ((result == TokenizerAutomaton::NoRule) || (rule < result)))
+                result = rule;
+        }
+        return result;
+    }
+
+private:
+    int NewState()
+    {
+        states.push_back(State{ -1, -1, {}, {}, {}, TokenizerAutomaton::NoRule });
+        return static_cast<int>(states.size() - 1);
+    }
+    void Connect(int from, int to)
+    {
+        states[static_cast<std::size_t>(from)].epsilon.push_back(to);
+    }
+
+    Fragment Build(const Node& node)
+    {
+        switch (node.type)
+        {
+        case NodeType::Characters:
+            {
+                Fragment result{ NewState(), NewState() };
+                characterSets.push_back(node.characters);
+                states[static_cast<std::size_t>(result.start)].characterSet = static_cast<int>(characterSets.size() - 1);
+                states[static_cast<std::size_t>(result.start)].next = result.end;
+                return result;
+            }
+        case NodeType::Sequence:
+            {
+                auto state = NewState();
+                Fragment result{ state, state };
+                for (auto const& child : node.children)
+                {
+                    auto fragment = Build(*child);
+                    Connect(result.end, fragment.start);
+                    result.end = fragment.end;
+                }
+                return result;
+            }
+        case NodeType::Alternation:
+            {
+                Fragment result{ NewState(), NewState() };
+                for (auto const& child : node.children)
+                {
+                    auto fragment = Build(*child);
+                    Connect(result.start, fragment.start);
+                    Connect(fragment.end, result.end);
+                }
+                return result;
+            }
+        case NodeType::Repeat:
+            return BuildRepeat(node);
+        case NodeType::TokenStart:
+            {
+                Fragment result{ NewState(), NewState() };
+                states[static_cast<std::size_t>(result.start)].tokenStart.push_back(result.end);
+                return result;
+            }
+        case NodeType::TokenEnd:
+            {
+                Fragment result{ NewState(), NewState() };
+                states[static_cast<std::size_t>(result.start)].tokenEnd.push_back(result.end);
+                return result;
+            }
+        case NodeType::Empty:
+        default:
+            {
+                auto state = NewState();
+                return Fragment{ state, state };
+            }
+        }
+    }
+
+    Fragment BuildRepeat(const Node& node)
+    {
+        auto const& child = *node.children.front();
+        auto state = NewState();
+        Fragment result{ state, state };
+        for (std::size_t i = 0; i < node.minCount; ++i)
+        {
+            auto fragment = Build(child);
+            Connect(result.end, fragment.start);
+            result.end = fragment.end;
+        }
+        if (node.unbounded)
+        {
+            auto loop = NewState();
+            auto end = NewState();
+            auto fragment = Build(child);
+            Connect(result.end, loop);
+            Connect(loop, fragment.start);
+            Connect(loop, end);
+            Connect(fragment.end, loop);
+            result.end = end;
+        }
+        else
+        {
+            auto end = NewState();
+            for (std::size_t i = node.minCount; i < node.maxCount; ++i)
+            {
+                auto fragment = Build(child);
+                Connect(result.end, fragment.start);
+                Connect(result.end, end);
+                result.end = fragment.end;
+            }
+            Connect(result.end, end);
+            result.end = end;
+        }
+        return result;
+    }
+};
+
+} // namespace
+
+TokenizerAutomaton::TokenizerAutomaton()
+    : m_isValid{}
+    , m_characterClasses{}
+    , m_numCharacterClasses{ 1 }
+    , m_transitions{ DeadState }
+    , m_acceptRules{ NoRule }
+    , m_runs(1)
+    , m_startState{ DeadState }
+{
+}
+
+void TokenizerAutomaton::Clear()
+{
+    m_isValid = false;
+    m_characterClasses.fill(0);
+    m_numCharacterClasses = 1;
+    m_transitions = { DeadState };
+    m_acceptRules = { NoRule };
+    m_runs.assign(1, CharacterRun{});
+    m_startState = DeadState;
+}
+
+bool TokenizerAutomaton::Compile(const std::vector<std::string>& patterns)
+{
+    Clear();
+
+    NFA nfa;
+    try
+    {
+        for (std::size_t rule = 0; rule < patterns.size(); ++rule)
+        {
+            RegexParser parser(patterns[rule]);
+            auto node = parser.Parse();
+            nfa.AddRule(*node, static_cast<int>(rule));
+        }
+    }
+    catch (const SyntaxError&)
+    {
+        return false;
+    }
+
+    // Split the byte values into classes that no character set distinguishes between
+    std::array<std::size_t, 256> classes{};
+    std::size_t numClasses = 1;
+    for (auto const& characterSet : nfa.characterSets)
+    {
+        std::map<std::pair<std::size_t, bool>, std::size_t> splitClasses;
+        for (std::size_t ch = 0; ch < classes.size(); ++ch)
+        {
+            auto key = std::make_pair(classes[ch], characterSet.test(ch));
+            auto it = splitClasses.find(key);
+            if (it == splitClasses.end())
+                it = splitClasses.emplace(key, splitClasses.size()).first;
+            classes[ch] = it->second;
+        }
+        numClasses = splitClasses.size();
+    }
+    std::vector<std::size_t> classRepresentative(numClasses);
+    for (std::size_t ch = classes.size(); ch-- > 0;)
+        classRepresentative[classes[ch]] = ch;
+
+    // Subset construction. State 0 is the dead state, from which no rule can match anymore
+    std::map<std::vector<int>, State> dfaStateLookup{ { {}, DeadState } };
+    std::vector<std::vector<int>> dfaStates{ {} };
+    std::vector<State> transitions(numClasses, DeadState);
+    std::vector<int> acceptRules{ NoRule };
+    auto addState = [&](std::vector<int>&& stateSet) -> State
+    {
+        auto it = dfaStateLookup.find(stateSet);
+        if (it != dfaStateLookup.end())
+            return it->second;
+        auto state = static_cast<State>(dfaStates.size());
+        acceptRules.push_back(nfa.AcceptRule(stateSet));
+        dfaStateLookup.emplace(stateSet, state);
+        dfaStates.push_back(std::move(stateSet));
+        transitions.resize(transitions.size() + numClasses, DeadState);
+        return state;
+    };
+
+    std::vector<int> startSet{ nfa.start };
+    nfa.Closure(startSet, true, false);
+    auto startState = addState(std::move(startSet));
+    for (std::size_t state = 1; state < dfaStates.size(); ++state)
+    {
+        if (dfaStates.size() > MaxDFAStates)
+            return false;
+        for (std::size_t characterClass = 0; characterClass < numClasses; ++characterClass)
+        {
+            auto ch = classRepresentative[characterClass];
+            std::vector<int> nextSet;
+            for (auto nfaState : dfaStates[state])
+            {
+                auto const& nfaStateInfo = nfa.states[static_cast<std::size_t>(nfaState)];
+                if ((nfaStateInfo.characterSet >= 0) && nfa.characterSets[static_cast<std::size_t>(nfaStateInfo.characterSet)].test(ch))
+                    nextSet.push_back(nfaStateInfo.next);
+            }
+            if (nextSet.empty())
+                continue;
+            nfa.Closure(nextSet, false, false);
+            auto next = addState(std::move(nextSet));
+            transitions[state * numClasses + characterClass] = next;
+        }
+    }
+
+    // Minimize by partition refinement, starting from a partition by accepted rule
+    auto numStates = dfaStates.size();
+    std::vector<std::size_t> blocks(numStates);
+    std::size_t numBlocks{};
+    {
+        std::map<int, std::size_t> initialBlocks;
+        for (std::size_t state = 0; state < numStates; ++state)
+        {
+            auto it = initialBlocks.emplace(acceptRules[state], initialBlocks.size()).first;
+            blocks[state] = it->second;
+        }
+        numBlocks = initialBlocks.size();
+    }
+    while (true)
+    {
+        std::map<std::vector<std::size_t>, std::size_t> signatures;
+        std::vector<std::size_t> newBlocks(numStates);
+        for (std::size_t state = 0; state < numStates; ++state)
+        {
+            std::vector<std::size_t> signature{ blocks[state] };
+            for (std::size_t characterClass = 0; characterClass < numClasses; ++characterClass)
+                signature.push_back(blocks[transitions[state * numClasses + characterClass]]);
+            auto it = signatures.emplace(std::move(signature), signatures.size()).first;
+            newBlocks[state] = it->second;
+        }
+        blocks.swap(newBlocks);
+        if (signatures.size() == numBlocks)
+            break;
+        numBlocks = signatures.size();
+    }
+
+    // Renumber blocks such that the block holding the dead state becomes state 0
+    std::vector<State> blockState(numBlocks, DeadState);
+    State nextState = 1;
+    for (std::size_t state = 0; state < numStates; ++state)
+    {
+        auto block = blocks[state];
+        if ((block != blocks[DeadState]) && (blockState[block] == DeadState))
+            blockState[block] = nextState++;
+    }
+    m_numCharacterClasses = numClasses;
+    m_transitions.assign(nextState * numClasses, DeadState);
+    m_acceptRules.assign(nextState, NoRule);
+    for (std::size_t state = 0; state < numStates; ++state)
+    {
+        auto minimizedState = blockState[blocks[state]];
+        m_acceptRules[minimizedState] = acceptRules[state];
+        for (std::size_t characterClass = 0; characterClass < numClasses; ++characterClass)
+        {
+            m_transitions[minimizedState * numClasses + characterClass] = blockState[blocks[transitions[state * numClasses + characterClass]]];
+        }
+    }
+    for (std::size_t ch = 0; ch < classes.size(); ++ch)
+        m_characterClasses[ch] = static_cast<std::uint8_t>(classes[ch]);
+
+    // The run of a state holds the characters for which the state transitions to itself
+    m_runs.assign(nextState, CharacterRun{});
+    for (State state = 1; state < nextState; ++state)
+    {
+        CharacterSet loop;
+        for (std::size_t ch = 0; ch < classes.size(); ++ch)
+        {
+            if (m_transitions[state * numClasses + classes[ch]] == state)
+                loop.set(ch);
+        }
+        m_runs[state] = CharacterRun::FromSet(loop);
+    }
+    m_startState = blockState[blocks[startState]];
+    m_isValid = true;
+    return true;
+}
+
+int TokenizerAutomaton::Match(const std::string& text) const
+{
+    if (!m_isValid)
+        return NoRule;
+    auto state = StartState();
+    for (auto ch : text)
+    {
+        state = Next(state, ch);
+        if (IsDead(state))
+            return NoRule;
+    }
+    return AcceptRule(state);
+}
+
+} // namespace parser
@@ -17,6 +17,7 @@ public:
     MOCK_METHOD(bool, OnNoMoreToken, (const SourceLocation& location), (override));
     MOCK_METHOD(void, OnSkipToken, (const Token<UnderlyingType>& token), (override));
     MOCK_METHOD(void, OnParseError, (const Token<UnderlyingType>& token), (override));
+    MOCK_METHOD(bool, OnRecover, (ITokenizer<UnderlyingType>& tokenizer), (override));
 };
 
 } // namespace parser
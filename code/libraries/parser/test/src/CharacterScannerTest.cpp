@@ -0,0 +1,145 @@
+#include "test-platform/GoogleTest.h"
+
+#include "parser/CharacterScanner.h"
+
+namespace parser {
+
+namespace {
+
+std::bitset<256> MakeSet(const std::string& characters)
+{
+    std::bitset<256> result;
+    for (auto ch : characters)
+    {
+        result.set(static_cast<unsigned char>(ch));
+    }
+    return result;
+}
+
+std::bitset<256> IdentifierCharacters()
+{
+    std::bitset<256> result;
+    for (int ch = 0; ch < 256; ++ch)
+    {
+        if (((ch >= '0') && (ch <= '9')) || ((ch >= 'A') && (ch <= 'Z')) || ((ch >= 'a') && (ch <= 'z')) || (ch == '_'))
+            result.set(static_cast<std::size_t>(ch));
+    }
+    return result;
+}
+
+// Restores the scan level used by other tests
+class CharacterScannerTest
+    : public ::testing::Test
+{
+public:
+    void TearDown() override
+    {
+        CharacterScanner::SetLevel(CharacterScanner::SupportedLevel());
+    }
+};
+
+} // namespace
+
+TEST(CharacterRunTest, Construct)
+{
+    CharacterRun run;
+
+    EXPECT_TRUE(run.IsEmpty());
+    EXPECT_EQ(size_t{ 0 }, run.NumRanges());
+    EXPECT_FALSE(run.Contains('a'));
+}
+
+TEST(CharacterRunTest, FromSet)
+{
+    auto run = CharacterRun::FromSet(IdentifierCharacters());
+
+    EXPECT_FALSE(run.IsEmpty());
+    EXPECT_TRUE(run.ContinueInRanges());
+    EXPECT_EQ(size_t{ 4 }, run.NumRanges());
+    EXPECT_EQ('0', run.First(0));
+    EXPECT_EQ('9', run.Last(0));
+    for (int ch = 0; ch < 256; ++ch)
+    {
+        EXPECT_EQ(IdentifierCharacters().test(static_cast<std::size_t>(ch)), run.Contains(static_cast<char>(ch))) << "Character " << ch;
+    }
+}
+
+TEST(CharacterRunTest, FromSetUsesComplement)
+{
+    auto run = CharacterRun::FromSet(~MakeSet("\"(\\_"));
+
+    EXPECT_FALSE(run.ContinueInRanges());
+    EXPECT_EQ(size_t{ 4 }, run.NumRanges());
+    EXPECT_TRUE(run.Contains('a'));
+    EXPECT_TRUE(run.Contains('\n'));
+    EXPECT_FALSE(run.Contains('"'));
+    EXPECT_FALSE(run.Contains('('));
+    EXPECT_FALSE(run.Contains('\\'));
+    EXPECT_FALSE(run.Contains('_'));
+}
+
+TEST(CharacterRunTest, FromSetTooManyRanges)
+{
+    EXPECT_TRUE(CharacterRun::FromSet(MakeSet("acegikmoq")).IsEmpty());
+    EXPECT_TRUE(CharacterRun::FromSet({}).IsEmpty());
+}
+
+TEST_F(CharacterScannerTest, SetLevel)
+{
+    CharacterScanner::SetLevel(ScanLevel::Scalar);
+    EXPECT_EQ(ScanLevel::Scalar, CharacterScanner::Level());
+    CharacterScanner::SetLevel(ScanLevel::AVX2);
+    EXPECT_EQ(CharacterScanner::SupportedLevel(), CharacterScanner::Level());
+}
+
+TEST_F(CharacterScannerTest, SkipEmptyRun)
+{
+    EXPECT_EQ(size_t{ 0 }, CharacterScanner::Skip("abc", CharacterRun{}));
+}
+
+TEST_F(CharacterScannerTest, SkipSameForAllLevels)
+{
+    std::vector<CharacterRun> runs{
+        CharacterRun::FromSet(MakeSet(" \t")),
+        CharacterRun::FromSet(IdentifierCharacters()),
+        CharacterRun::FromSet(~MakeSet("\n")),
+        CharacterRun::FromSet(~MakeSet("\"\\")),
+        CharacterRun::FromSet(~MakeSet("\"(\\_")),
+        CharacterRun::FromSet(~std::bitset<256>{}),
+    };
+    const std::string stopCharacters{ "\t\n \"#()\\a_\x80\xff" };
+    for (auto level : { ScanLevel::Scalar, ScanLevel::SSE2, ScanLevel::AVX2 })
+    {
+        CharacterScanner::SetLevel(level);
+        for (auto const& run : runs)
+        {
+            // Runs of every length around the vector widths, ending in every character of interest
+            for (std::size_t length = 0; length < 80; ++length)
+            {
+                for (auto stop : stopCharacters)
+                {
+                    std::string text;
+                    for (std::size_t index = 0; index < length; ++index)
+                    {
+                        for (int ch = static_cast<int>(index * 7) % 256;; ch = (ch + 1) % 256)
+                        {
+                            if (run.Contains(static_cast<char>(ch)))
+                            {
+                                text += static_cast<char>(ch);
+                                break;
+                            }
+                        }
+                    }
+                    text += stop;
+                    text += "  abc";
+                    auto expected = run.Contains(stop) ? length + 1 : length;
+                    while ((expected < text.length()) && run.Contains(text[expected]))
+                        ++expected;
+                    EXPECT_EQ(expected, CharacterScanner::Skip(text, run)) << "Length " << length << " stop " << static_cast<int>(stop);
+                }
+            }
+        }
+    }
+}
+
+} // namespace parser
@@ -0,0 +1,35 @@
+#include "parser/ContentHash.h"
+
+#include <string>
+#include "test-platform/GoogleTest.h"
+
+namespace parser {
+
+TEST(ContentHashTest, KnownValues)
+{
+    EXPECT_EQ(0xEF46DB3751D8E999ull, ContentHash(""));
+    EXPECT_EQ(0xD24EC4F1A98C6E5Bull, ContentHash("a"));
+    EXPECT_EQ(0x44BC2CF5AD770999ull, ContentHash("abc"));
+    EXPECT_EQ(0xFBCEA83C8A378BF1ull, ContentHash("Nobody inspects the spammish repetition"));
+}
+
+TEST(ContentHashTest, Seed)
+{
+    EXPECT_NE(ContentHash("abc"), ContentHash("abc", 1));
+}
+
+TEST(ContentHashTest, AllLengths)
+{
+    std::string text;
+    std::uint64_t previous = ContentHash(text);
+    for (int length = 1; length < 100; ++length)
+    {
+        text += static_cast<char>('a' + length % 26);
+        auto hash = ContentHash(text);
+        EXPECT_NE(previous, hash) << "Length " << length;
+        EXPECT_EQ(hash, ContentHash(std::string(text)));
+        previous = hash;
+    }
+}
+
+} // namespace parser
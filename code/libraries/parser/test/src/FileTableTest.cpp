@@ -0,0 +1,72 @@
+#include "parser/FileTable.h"
+
+#include "test-platform/GoogleTest.h"
+
+using namespace parser;
+
+TEST(FileTableTest, NoFile)
+{
+    EXPECT_EQ("", FileTable::UnitPath(FileTable::NoFile));
+    EXPECT_EQ(std::make_pair(0, 0), FileTable::LineAndColumn(FileTable::NoFile, 0));
+}
+
+TEST(FileTableTest, Intern)
+{
+    auto fileId = FileTable::Intern("FileTableTest/Intern");
+
+    EXPECT_NE(FileTable::NoFile, fileId);
+    EXPECT_EQ(fileId, FileTable::Intern("FileTableTest/Intern"));
+    EXPECT_NE(fileId, FileTable::Intern("FileTableTest/Other"));
+    EXPECT_EQ("FileTableTest/Intern", FileTable::UnitPath(fileId));
+    EXPECT_EQ(std::make_pair(0, 0), FileTable::LineAndColumn(fileId, 0));
+}
+
+TEST(FileTableTest, Register)
+{
+    auto fileId = FileTable::Register("FileTableTest/Register", "1\n2\r3\n\r");
+
+    EXPECT_EQ(fileId, FileTable::Intern("FileTableTest/Register"));
+    EXPECT_EQ(std::make_pair(1, 1), FileTable::LineAndColumn(fileId, 0));
+    EXPECT_EQ(std::make_pair(1, 2), FileTable::LineAndColumn(fileId, 1));
+    EXPECT_EQ(std::make_pair(2, 1), FileTable::LineAndColumn(fileId, 2));
+    EXPECT_EQ(std::make_pair(2, 2), FileTable::LineAndColumn(fileId, 3));
+    EXPECT_EQ(std::make_pair(2, 1), FileTable::LineAndColumn(fileId, 4));
+    EXPECT_EQ(std::make_pair(2, 2), FileTable::LineAndColumn(fileId, 5));
+    EXPECT_EQ(std::make_pair(3, 1), FileTable::LineAndColumn(fileId, 6));
+    EXPECT_EQ(std::make_pair(3, 1), FileTable::LineAndColumn(fileId, 7));
+}
+
+TEST(FileTableTest, RegisterSameTextTwice)
+{
+    auto fileId = FileTable::Register("FileTableTest/RegisterTwice", "a\nb");
+    auto size = FileTable::Size();
+
+    EXPECT_EQ(fileId, FileTable::Register("FileTableTest/RegisterTwice", "c\nd"));
+    EXPECT_EQ(size, FileTable::Size());
+}
+
+TEST(FileTableTest, RegisterDifferentText)
+{
+    auto fileId = FileTable::Register("FileTableTest/RegisterDifferent", "a\nb");
+    auto otherFileId = FileTable::Register("FileTableTest/RegisterDifferent", "a\n\nb");
+
+    EXPECT_NE(fileId, otherFileId);
+    EXPECT_EQ(FileTable::UnitPath(fileId), FileTable::UnitPath(otherFileId));
+    // The line index of the earlier text is kept
+    EXPECT_EQ(std::make_pair(2, 1), FileTable::LineAndColumn(fileId, 2));
+    EXPECT_EQ(std::make_pair(3, 1), FileTable::LineAndColumn(otherFileId, 3));
+    auto size = FileTable::Size();
+    EXPECT_EQ(fileId, FileTable::Register("FileTableTest/RegisterDifferent", "c\nd"));
+    EXPECT_EQ(otherFileId, FileTable::Register("FileTableTest/RegisterDifferent", "c\n\nd"));
+    EXPECT_EQ(size, FileTable::Size());
+}
+
+TEST(FileTableTest, RegisterWithoutPath)
+{
+    auto fileId = FileTable::Register("", "a\nb");
+    auto otherFileId = FileTable::Register("", "ab\n");
+
+    EXPECT_NE(fileId, otherFileId);
+    EXPECT_EQ(std::make_pair(2, 1), FileTable::LineAndColumn(fileId, 2));
+    EXPECT_EQ(std::make_pair(1, 3), FileTable::LineAndColumn(otherFileId, 2));
+}
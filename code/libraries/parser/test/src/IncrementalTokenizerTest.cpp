@@ -0,0 +1,155 @@
+#include "test-platform/GoogleTest.h"
+
+#include "parser/IncrementalTokenizer.h"
+
+namespace parser {
+
+namespace {
+
+const TokenizerRuleSet<int>& GetRuleSet()
+{
+    static const TokenizerRuleSet<int> ruleSet({
+        { "[ \t]+", TokenType{ 1 } },
+        { "\r?\n", TokenType{ 2 } },
+        { "[_a-zA-Z][_a-zA-Z0-9]*", TokenType{ 3 } },
+        { "\"[^\"]*\"", TokenType{ 4 } },
+        { "#[^\n]*", TokenType{ 5 } },
+        { "\\(", TokenType{ 6 } },
+        { "\\)", TokenType{ 7 } },
+        });
+    return ruleSet;
+}
+
+void ExpectSameTokens(const TokenStream<int>& expected, const TokenStream<int>& actual)
+{
+    ASSERT_EQ(expected.Size(), actual.Size());
+    EXPECT_EQ(expected.Types(), actual.Types());
+    EXPECT_EQ(expected.Offsets(), actual.Offsets());
+    EXPECT_EQ(expected.Lengths(), actual.Lengths());
+}
+
+} // namespace
+
+TEST(IncrementalTokenizerTest, Construct)
+{
+    std::string compilationUnit("ABC");
+    std::string text("abc(\"d e\")\n# f\n");
+    IncrementalTokenizer<int> tokenizer(GetRuleSet(), compilationUnit, text);
+
+    EXPECT_EQ(text, tokenizer.Source());
+    ExpectSameTokens(Tokenize(GetRuleSet(), compilationUnit, text), tokenizer.Tokens());
+    EXPECT_EQ(compilationUnit, FileTable::UnitPath(tokenizer.GetFileId()));
+}
+
+TEST(IncrementalTokenizerTest, ApplyWithinToken)
+{
+    std::string compilationUnit("ABC");
+    std::string text("abc(d)\nxyz(e)\nuvw(f)\n");
+    IncrementalTokenizer<int> tokenizer(GetRuleSet(), compilationUnit, text);
+
+    auto change = tokenizer.Apply(TextEdit{ 8, 1, "Y12" });
+    EXPECT_EQ("abc(d)\nxY12z(e)\nuvw(f)\n", tokenizer.Source());
+    EXPECT_EQ(size_t{ 5 }, change.first);
+    EXPECT_EQ(size_t{ 1 }, change.removed);
+    EXPECT_EQ(size_t{ 1 }, change.inserted);
+    ExpectSameTokens(Tokenize(GetRuleSet(), compilationUnit, tokenizer.Source()), tokenizer.Tokens());
+    EXPECT_EQ("xY12z", tokenizer.Tokens().Value(5));
+    EXPECT_EQ("uvw", tokenizer.Tokens().Value(10));
+}
+
+TEST(IncrementalTokenizerTest, ApplyExtendsPreviousToken)
+{
+    std::string compilationUnit("ABC");
+    std::string text("abc def");
+    IncrementalTokenizer<int> tokenizer(GetRuleSet(), compilationUnit, text);
+
+    auto change = tokenizer.Apply(TextEdit{ 3, 1, "" });
+    EXPECT_EQ(size_t{ 0 }, change.first);
+    EXPECT_EQ(size_t{ 3 }, change.removed);
+    EXPECT_EQ(size_t{ 1 }, change.inserted);
+    EXPECT_EQ("abcdef", tokenizer.Tokens().Value(0));
+}
+
+TEST(IncrementalTokenizerTest, ApplyChangesFollowingLines)
+{
+    std::string compilationUnit("ABC");
+    std::string text("a(b)\nc(d)\ne(f)\n");
+    IncrementalTokenizer<int> tokenizer(GetRuleSet(), compilationUnit, text);
+
+    // Opening a string turns the lines after it into a string, up to the next quote
+    tokenizer.Apply(TextEdit{ 2, 0, "\"" });
+    ExpectSameTokens(Tokenize(GetRuleSet(), compilationUnit, tokenizer.Source()), tokenizer.Tokens());
+    auto change = tokenizer.Apply(TextEdit{ 13, 0, "\"" });
+    EXPECT_EQ(size_t{ 2 }, change.first);
+    ExpectSameTokens(Tokenize(GetRuleSet(), compilationUnit, tokenizer.Source()), tokenizer.Tokens());
+    EXPECT_EQ("\"b)\nc(d)\ne(\"", tokenizer.Tokens().Value(2));
+}
+
+TEST(IncrementalTokenizerTest, ApplyAtEnd)
+{
+    std::string compilationUnit("ABC");
+    IncrementalTokenizer<int> tokenizer(GetRuleSet(), compilationUnit, "");
+
+    EXPECT_TRUE(tokenizer.Tokens().IsEmpty());
+    tokenizer.Apply(TextEdit{ 0, 0, "ab" });
+    tokenizer.Apply(TextEdit{ 2, 0, "c" });
+    ASSERT_EQ(size_t{ 1 }, tokenizer.Tokens().Size());
+    EXPECT_EQ("abc", tokenizer.Tokens().Value(0));
+    tokenizer.Apply(TextEdit{ 0, 3, "" });
+    EXPECT_TRUE(tokenizer.Tokens().IsEmpty());
+}
+
+TEST(IncrementalTokenizerTest, ApplyOutOfRange)
+{
+    std::string compilationUnit("ABC");
+    IncrementalTokenizer<int> tokenizer(GetRuleSet(), compilationUnit, "abc");
+
+    EXPECT_THROW(tokenizer.Apply(TextEdit{ 4, 0, "d" }), std::out_of_range);
+    EXPECT_THROW(tokenizer.Apply(TextEdit{ 2, 2, "" }), std::out_of_range);
+    EXPECT_EQ("abc", tokenizer.Source());
+}
+
+TEST(IncrementalTokenizerTest, ApplySameAsTokenize)
+{
+    std::string compilationUnit("ABC");
+    std::string text;
+    for (int index = 0; index < 50; ++index)
+    {
+        text += "name" + std::to_string(index) + "(\"arg\n\" x)\t# comment \"\n";
+    }
+    IncrementalTokenizer<int> tokenizer(GetRuleSet(), compilationUnit, text);
+
+    const std::string insertions[] = { "", "\"", "#", "\n", "(", "a", " ", "?", "\r\n", "x\"y" };
+    std::uint32_t random = 12345;
+    for (int edit = 0; edit < 500; ++edit)
+    {
+        random = random * 1103515245u + 12345u;
+        auto size = tokenizer.Source().size();
+        std::size_t offset = (random >> 8) % (size + 1);
+        std::size_t removed = std::min<std::size_t>((random >> 4) % 3, size - offset);
+        auto const& inserted = insertions[(random >> 16) % 10];
+        tokenizer.Apply(TextEdit{ offset, removed, inserted });
+        auto expected = Tokenize(GetRuleSet(), compilationUnit, tokenizer.Source());
+        ExpectSameTokens(expected, tokenizer.Tokens());
+        if (::testing::Test::HasFailure())
+        {
+            FAIL() << "Edit " << edit << " at " << offset << " removing " << removed << " inserting \"" << inserted << "\"";
+        }
+    }
+}
+
+TEST(IncrementalTokenizerTest, Register)
+{
+    std::string compilationUnit("ABC");
+    IncrementalTokenizer<int> tokenizer(GetRuleSet(), compilationUnit, "abc\ndef");
+
+    tokenizer.Apply(TextEdit{ 0, 0, "\n\n" });
+    auto fileId = tokenizer.Register();
+    EXPECT_EQ(fileId, tokenizer.GetFileId());
+    EXPECT_EQ(fileId, tokenizer.Tokens().GetFileId());
+    auto token = tokenizer.Tokens().MakeToken(tokenizer.Tokens().Size() - 1);
+    EXPECT_EQ("def", token.Value());
+    EXPECT_EQ(4, token.BeginLocation().Line());
+}
+
+} // namespace parser
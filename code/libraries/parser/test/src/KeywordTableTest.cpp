@@ -0,0 +1,79 @@
+#include "parser/KeywordTable.h"
+
+#include "test-platform/GoogleTest.h"
+
+namespace parser {
+
+namespace {
+
+enum class Keyword
+{
+    None,
+    If,
+    Else,
+    EndIf,
+    AddExecutable,
+};
+
+constexpr auto Keywords = MakeKeywordTable<Keyword>({
+    { "if", Keyword::If },
+    { "else", Keyword::Else },
+    { "endif", Keyword::EndIf },
+    { "add_executable", Keyword::AddExecutable },
+});
+
+constexpr auto CaseSensitiveKeywords = MakeKeywordTable<Keyword, KeywordCase::Sensitive>({
+    { "if", Keyword::If },
+    { "IF", Keyword::EndIf },
+});
+
+// The table is usable in constant expressions
+static_assert(Keywords.Find("ENDIF", Keyword::None) == Keyword::EndIf);
+static_assert(!Keywords.Contains("end"));
+
+} // namespace
+
+TEST(KeywordTableTest, Construct)
+{
+    EXPECT_EQ(size_t{ 4 }, Keywords.Size());
+    EXPECT_LE(size_t{ 8 * 4 }, Keywords.NumSlots);
+    EXPECT_EQ(4, std::distance(Keywords.begin(), Keywords.end()));
+    EXPECT_EQ("if", Keywords.begin()->text);
+}
+
+TEST(KeywordTableTest, Lookup)
+{
+    Keyword keyword{};
+    EXPECT_TRUE(Keywords.Lookup("if", keyword));
+    EXPECT_EQ(Keyword::If, keyword);
+    EXPECT_TRUE(Keywords.Lookup("else", keyword));
+    EXPECT_EQ(Keyword::Else, keyword);
+    EXPECT_TRUE(Keywords.Lookup("add_executable", keyword));
+    EXPECT_EQ(Keyword::AddExecutable, keyword);
+
+    keyword = Keyword::None;
+    EXPECT_FALSE(Keywords.Lookup("", keyword));
+    EXPECT_FALSE(Keywords.Lookup("i", keyword));
+    EXPECT_FALSE(Keywords.Lookup("iff", keyword));
+    EXPECT_FALSE(Keywords.Lookup("add_executable_", keyword));
+    EXPECT_FALSE(Keywords.Lookup("add_library", keyword));
+    EXPECT_EQ(Keyword::None, keyword);
+}
+
+TEST(KeywordTableTest, LookupIgnoresCase)
+{
+    EXPECT_EQ(Keyword::If, Keywords.Find("IF", Keyword::None));
+    EXPECT_EQ(Keyword::Else, Keywords.Find("eLsE", Keyword::None));
+    EXPECT_EQ(Keyword::AddExecutable, Keywords.Find("ADD_EXECUTABLE", Keyword::None));
+    // Characters that only differ in bit 5 outside of letters are not equal
+    EXPECT_EQ(Keyword::None, Keywords.Find("add\x7F" "executable", Keyword::None));
+}
+
+TEST(KeywordTableTest, LookupCaseSensitive)
+{
+    EXPECT_EQ(Keyword::If, CaseSensitiveKeywords.Find("if", Keyword::None));
+    EXPECT_EQ(Keyword::EndIf, CaseSensitiveKeywords.Find("IF", Keyword::None));
+    EXPECT_EQ(Keyword::None, CaseSensitiveKeywords.Find("If", Keyword::None));
+}
+
+} // namespace parser
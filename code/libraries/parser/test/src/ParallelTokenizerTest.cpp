@@ -0,0 +1,133 @@
+#include "test-platform/GoogleTest.h"
+
+#include "parser/ParallelTokenizer.h"
+
+namespace parser {
+
+namespace {
+
+const TokenizerRuleSet<int>& GetRuleSet()
+{
+    static const TokenizerRuleSet<int> ruleSet({
+        { "[ \t]+", TokenType{ 1 } },
+        { "\r?\n", TokenType{ 2 } },
+        { "[_a-zA-Z][_a-zA-Z0-9]*", TokenType{ 3 } },
+        { "\"[^\"]*\"", TokenType{ 4 } },
+        { "#[^\n]*", TokenType{ 5 } },
+        });
+    return ruleSet;
+}
+
+// Strings span lines, and comments contain quotes, so many chunk boundaries fall inside a token
+std::string GenerateSource(std::size_t numLines)
+{
+    std::string result;
+    for (std::size_t index = 0; index < numLines; ++index)
+    {
+        switch (index % 4)
+        {
+        case 0:
+            result += "name" + std::to_string(index) + " \"string\n\nspanning\nlines\"\n";
+            break;
+        case 1:
+            result += "# comment with \" quote\n";
+            break;
+        case 2:
+            result += "\tabc def\r\n";
+            break;
+        default:
+            result += "\"x\" \"\n\"\n";
+            break;
+        }
+    }
+    return result;
+}
+
+void ExpectSameTokens(const TokenStream<int>& expected, const TokenStream<int>& actual)
+{
+    ASSERT_EQ(expected.Size(), actual.Size());
+    EXPECT_EQ(expected.Types(), actual.Types());
+    EXPECT_EQ(expected.Offsets(), actual.Offsets());
+    EXPECT_EQ(expected.Lengths(), actual.Lengths());
+}
+
+} // namespace
+
+TEST(ParallelTokenizerTest, Construct)
+{
+    ParallelTokenizer<int> tokenizer(GetRuleSet());
+
+    EXPECT_LE(size_t{ 1 }, tokenizer.NumThreads());
+    EXPECT_EQ(ParallelTokenizer<int>::DefaultMinChunkSize, tokenizer.MinChunkSize());
+}
+
+TEST(ParallelTokenizerTest, SmallInputSameAsSequential)
+{
+    std::string compilationUnit("ABC");
+    auto text = GenerateSource(8);
+
+    auto expected = Tokenize(GetRuleSet(), compilationUnit, text);
+    auto actual = TokenizeParallel(GetRuleSet(), compilationUnit, text, 4);
+    ExpectSameTokens(expected, actual);
+    EXPECT_EQ(expected.GetFileId(), actual.GetFileId());
+}
+
+TEST(ParallelTokenizerTest, ChunksSameAsSequential)
+{
+    std::string compilationUnit("ABC");
+    auto text = GenerateSource(1000);
+
+    auto expected = Tokenize(GetRuleSet(), compilationUnit, text);
+    for (std::size_t minChunkSize : { 1, 7, 64, 1000 })
+    {
+        auto actual = TokenizeParallel(GetRuleSet(), compilationUnit, text, 4, minChunkSize);
+        ExpectSameTokens(expected, actual);
+    }
+}
+
+TEST(ParallelTokenizerTest, TokenSpanningChunks)
+{
+    std::string compilationUnit("ABC");
+    std::string text = "a\n\"" + std::string(1000, '\n') + "\"\nb\n" + GenerateSource(100);
+
+    auto expected = Tokenize(GetRuleSet(), compilationUnit, text);
+    auto actual = TokenizeParallel(GetRuleSet(), compilationUnit, text, 8, 16);
+    ExpectSameTokens(expected, actual);
+}
+
+TEST(ParallelTokenizerTest, InvalidTokenSameAsSequential)
+{
+    std::string compilationUnit("ABC");
+    auto text = GenerateSource(200) + "?" + GenerateSource(200);
+
+    auto expected = Tokenize(GetRuleSet(), compilationUnit, text);
+    auto actual = TokenizeParallel(GetRuleSet(), compilationUnit, text, 4, 32);
+    ExpectSameTokens(expected, actual);
+    EXPECT_TRUE(actual.View(actual.Size() - 1).IsInvalid());
+}
+
+TEST(ParallelTokenizerTest, ChunksOnPoolSameAsSequential)
+{
+    std::string compilationUnit("ABC");
+    auto text = GenerateSource(1000);
+    ThreadPool pool(3);
+
+    ParallelTokenizer<int> tokenizer(GetRuleSet(), pool, 0, 64);
+    EXPECT_EQ(pool.NumThreads(), tokenizer.NumThreads());
+    auto expected = Tokenize(GetRuleSet(), compilationUnit, text);
+    ExpectSameTokens(expected, tokenizer.Tokenize(compilationUnit, text));
+    ExpectSameTokens(expected, TokenizeParallel(GetRuleSet(), pool, compilationUnit, text, 64));
+}
+
+TEST(ParallelTokenizerTest, TokenizeFromPoolTask)
+{
+    std::string compilationUnit("ABC");
+    auto text = GenerateSource(1000);
+    ThreadPool pool(1);
+
+    // The only thread of the pool lexes all chunks itself, instead of waiting for tasks that cannot run
+    auto actual = pool.Async([&]() { return ParallelTokenizer<int>(GetRuleSet(), pool, 4, 64).Tokenize(compilationUnit, text); }).get();
+    ExpectSameTokens(Tokenize(GetRuleSet(), compilationUnit, text), actual);
+}
+
+} // namespace parser
@@ -0,0 +1,112 @@
+#include "parser/ParseArena.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "test-platform/GoogleTest.h"
+
+namespace parser {
+
+namespace {
+
+class Counted
+{
+private:
+    std::vector<int>& m_destroyed;
+    int m_id;
+
+public:
+    Counted(std::vector<int>& destroyed, int id)
+        : m_destroyed{ destroyed }
+        , m_id{ id }
+    {}
+    ~Counted()
+    {
+        m_destroyed.push_back(m_id);
+    }
+    int Id() const { return m_id; }
+};
+
+} // namespace
+
+TEST(ParseArenaTest, Construct)
+{
+    ParseArena arena;
+
+    EXPECT_EQ(size_t{ 0 }, arena.BytesReserved());
+    EXPECT_NE(nullptr, arena.Resource());
+}
+
+TEST(ParseArenaTest, Allocate)
+{
+    ParseArena arena(256);
+
+    auto first = arena.Allocate(3, 1);
+    auto second = arena.Allocate(sizeof(double), alignof(double));
+    EXPECT_NE(first, second);
+    EXPECT_EQ(std::uintptr_t{ 0 }, reinterpret_cast<std::uintptr_t>(second) % alignof(double));
+    auto reserved = arena.BytesReserved();
+    EXPECT_LE(size_t{ 256 }, reserved);
+
+    // Larger than a block
+    arena.Allocate(1000);
+    EXPECT_LT(reserved, arena.BytesReserved());
+}
+
+TEST(ParseArenaTest, CopyString)
+{
+    ParseArena arena;
+    std::string text{ "add_executable" };
+
+    auto copy = arena.CopyString(text);
+    text = "changed";
+    EXPECT_EQ("add_executable", copy);
+    EXPECT_EQ("", arena.CopyString(""));
+}
+
+TEST(ParseArenaTest, Create)
+{
+    std::vector<int> destroyed;
+    {
+        ParseArena arena;
+
+        auto first = arena.Create<Counted>(destroyed, 1);
+        auto second = arena.Create<Counted>(destroyed, 2);
+        EXPECT_EQ(1, first->Id());
+        EXPECT_EQ(2, second->Id());
+        EXPECT_TRUE(destroyed.empty());
+    }
+    EXPECT_EQ((std::vector<int>{ 2, 1 }), destroyed);
+}
+
+TEST(ParseArenaTest, CreateContainer)
+{
+    ParseArena arena;
+
+    auto items = arena.Create<std::pmr::vector<std::pmr::string>>();
+    items->emplace_back("a string that is too long for the small string buffer");
+    EXPECT_EQ(arena.Resource(), items->get_allocator().resource());
+    EXPECT_EQ(arena.Resource(), items->front().get_allocator().resource());
+}
+
+TEST(ParseArenaTest, Release)
+{
+    std::vector<int> destroyed;
+    ParseArena arena;
+
+    arena.Create<Counted>(destroyed, 1);
+    {
+        std::pmr::vector<int> values(arena.Resource());
+        values.resize(1000);
+        EXPECT_LT(size_t{ 0 }, arena.BytesReserved());
+    }
+
+    arena.Release();
+    EXPECT_EQ((std::vector<int>{ 1 }), destroyed);
+    EXPECT_EQ(size_t{ 0 }, arena.BytesReserved());
+
+    arena.Create<Counted>(destroyed, 2);
+    EXPECT_LT(size_t{ 0 }, arena.BytesReserved());
+}
+
+} // namespace parser
@@ -2,7 +2,7 @@
 
 #include "parser/ParserExecutor.h"
 #include "parser/Tokenizer.h"
-#include "parser/TokenizerRule.h"
+#include "parser/TokenizerRuleSet.h"
 #include "ParserCallbackMock.h"
 
 using ::testing::DoAll;
@@ -34,7 +34,6 @@ public:
     void TearDown() override
     {
         SetupTokenDefinitions<TokenTypes>({});
-        SetTokenizerRules<TokenTypes>({});
     }
 };
 
@@ -48,7 +47,8 @@ TEST_F(ParserExecutorTest, EmptyStream)
     EXPECT_CALL(callback, OnParseError(_)).Times(0);
     EXPECT_CALL(callback, OnNoMoreToken(_)).WillOnce(Return(true));
 
-    Tokenizer<TokenTypes> tokenizer(compilationUnit, stream);
+    TokenizerRuleSet<TokenTypes> ruleSet({});
+    Tokenizer<TokenTypes> tokenizer(ruleSet, compilationUnit, stream);
     ParserExecutor<TokenTypes> parser(callback, { TokenTypes::Whitespace });
     EXPECT_TRUE(parser.Parse(tokenizer));
 }
@@ -63,7 +63,7 @@ TEST_F(ParserExecutorTest, ParseSimpleComment)
     SetupTokenDefinitions<TokenTypes>({
         { SingleLineComment, "SingleLineComment" },
         });
-    SetTokenizerRules<TokenTypes>({
+    TokenizerRuleSet<TokenTypes> ruleSet({
         { "//.*", SingleLineComment, true },
         });
 
@@ -71,7 +71,7 @@ TEST_F(ParserExecutorTest, ParseSimpleComment)
     EXPECT_CALL(callback, OnParseError(_)).Times(0);
     EXPECT_CALL(callback, OnNoMoreToken(_)).WillOnce(Return(true));
 
-    Tokenizer<TokenTypes> tokenizer(compilationUnit, stream);
+    Tokenizer<TokenTypes> tokenizer(ruleSet, compilationUnit, stream);
     ParserExecutor<TokenTypes> parser(callback, { TokenTypes::Whitespace });
     EXPECT_TRUE(parser.Parse(tokenizer));
     EXPECT_EQ(TokenType<TokenTypes>{ SingleLineComment }, token.Type());
@@ -88,7 +88,7 @@ TEST_F(ParserExecutorTest, ParseInvalid)
     SetupTokenDefinitions<TokenTypes>({
         { SingleLineComment, "SingleLineComment" },
         });
-    SetTokenizerRules<TokenTypes>({
+    TokenizerRuleSet<TokenTypes> ruleSet({
         { "//.*", SingleLineComment, true },
         });
 
@@ -96,7 +96,7 @@ TEST_F(ParserExecutorTest, ParseInvalid)
     EXPECT_CALL(callback, OnParseError(_)).WillOnce(DoAll(SaveArg<0>(&errorToken)));
     EXPECT_CALL(callback, OnNoMoreToken(_)).Times(0);
 
-    Tokenizer<TokenTypes> tokenizer(compilationUnit, stream);
+    Tokenizer<TokenTypes> tokenizer(ruleSet, compilationUnit, stream);
     ParserExecutor<TokenTypes> parser(callback, { TokenTypes::Whitespace });
     EXPECT_FALSE(parser.Parse(tokenizer));
     EXPECT_EQ(text, errorToken.Value());
@@ -133,7 +133,7 @@ TEST_F(ParserExecutorTest, ParseComplex)
         { CurlyBraceOpen, "CurlyBraceOpen" },
         { CurlyBraceClose, "CurlyBraceClose" },
         });
-    SetTokenizerRules<TokenTypes>({
+    TokenizerRuleSet<TokenTypes> ruleSet({
         { "[ \t]+", Whitespace },
         { "(\r)?\n", NewLine },
         { "//[^\r\n]*", SingleLineComment },
@@ -161,7 +161,7 @@ TEST_F(ParserExecutorTest, ParseComplex)
     EXPECT_CALL(callback, OnParseError(_)).Times(0);
     EXPECT_CALL(callback, OnNoMoreToken(_)).WillOnce(Return(true));
 
-    Tokenizer<TokenTypes> tokenizer(compilationUnit, stream);
+    Tokenizer<TokenTypes> tokenizer(ruleSet, compilationUnit, stream);
     ParserExecutor<TokenTypes> parser(callback, {});
     EXPECT_TRUE(parser.Parse(tokenizer));
 
@@ -202,4 +202,119 @@ TEST_F(ParserExecutorTest, ParseComplex)
     EXPECT_EQ("}", token12.Value());
 }
 
+TEST_F(ParserExecutorTest, ParseStopsAtError)
+{
+    std::string compilationUnit("ABC");
+    std::istringstream stream("a b c");
+    ParserCallbackMock<TokenTypes> callback;
+    Token<TokenTypes> errorToken;
+    TokenizerRuleSet<TokenTypes> ruleSet({
+        { "[ \t]+", Whitespace },
+        { "[_a-zA-Z][_a-zA-Z0-9]*", Identifier },
+        });
+
+    EXPECT_CALL(callback, OnToken(_, _))
+        .WillOnce(DoAll(SetArgReferee<1>(false), Return(true)))
+        .WillOnce(DoAll(SetArgReferee<1>(false), Return(false)));
+    EXPECT_CALL(callback, OnSkipToken(_)).Times(1);
+    EXPECT_CALL(callback, OnParseError(_)).WillOnce(SaveArg<0>(&errorToken));
+    EXPECT_CALL(callback, OnRecover(_)).Times(0);
+    EXPECT_CALL(callback, OnNoMoreToken(_)).Times(0);
+
+    Tokenizer<TokenTypes> tokenizer(ruleSet, compilationUnit, stream);
+    ParserExecutor<TokenTypes> parser(callback, { TokenTypes::Whitespace });
+    EXPECT_FALSE(parser.Parse(tokenizer));
+    EXPECT_EQ("b", errorToken.Value());
+}
+
+TEST_F(ParserExecutorTest, ParseRecover)
+{
+    std::string compilationUnit("ABC");
+    std::istringstream stream("a b c d");
+    ParserCallbackMock<TokenTypes> callback;
+    Token<TokenTypes> errorToken;
+    Token<TokenTypes> lastToken;
+    TokenizerRuleSet<TokenTypes> ruleSet({
+        { "[ \t]+", Whitespace },
+        { "[_a-zA-Z][_a-zA-Z0-9]*", Identifier },
+        });
+
+    EXPECT_CALL(callback, OnToken(_, _))
+        .WillOnce(DoAll(SetArgReferee<1>(false), Return(true)))
+        .WillOnce(DoAll(SetArgReferee<1>(false), Return(false)))
+        .WillOnce(DoAll(SaveArg<0>(&lastToken), SetArgReferee<1>(false), Return(true)));
+    EXPECT_CALL(callback, OnSkipToken(_)).Times(2);
+    EXPECT_CALL(callback, OnParseError(_)).WillOnce(SaveArg<0>(&errorToken));
+    // Resynchronizes by skipping the whitespace and the next token
+    EXPECT_CALL(callback, OnRecover(_)).WillOnce([](ITokenizer<TokenTypes>& tokenizer)
+    {
+        tokenizer.GetToken();
+        tokenizer.GetToken();
+        return true;
+    });
+    EXPECT_CALL(callback, OnNoMoreToken(_)).WillOnce(Return(true));
+
+    Tokenizer<TokenTypes> tokenizer(ruleSet, compilationUnit, stream);
+    ParserExecutor<TokenTypes> parser(callback, { TokenTypes::Whitespace }, ErrorMode::Recover);
+    EXPECT_FALSE(parser.Parse(tokenizer));
+    EXPECT_EQ("b", errorToken.Value());
+    EXPECT_EQ("d", lastToken.Value());
+}
+
+TEST_F(ParserExecutorTest, ParsePipelined)
+{
+    std::string compilationUnit("ABC");
+    std::string text{ "a b\nc" };
+    std::istringstream stream(text);
+    ParserCallbackMock<TokenTypes> callback;
+    Token<TokenTypes> token1;
+    Token<TokenTypes> token2;
+    Token<TokenTypes> token3;
+    SourceLocation endLocation;
+    TokenizerRuleSet<TokenTypes> ruleSet({
+        { "[ \t]+", Whitespace },
+        { "\n", NewLine },
+        { "[_a-zA-Z][_a-zA-Z0-9]*", Identifier },
+        });
+
+    EXPECT_CALL(callback, OnToken(_, _))
+        .WillOnce(DoAll(SaveArg<0>(&token1), SetArgReferee<1>(false), Return(true)))
+        .WillOnce(DoAll(SaveArg<0>(&token2), SetArgReferee<1>(false), Return(true)))
+        .WillOnce(DoAll(SaveArg<0>(&token3), SetArgReferee<1>(false), Return(true)));
+    EXPECT_CALL(callback, OnSkipToken(_)).Times(2);
+    EXPECT_CALL(callback, OnParseError(_)).Times(0);
+    EXPECT_CALL(callback, OnNoMoreToken(_)).WillOnce(DoAll(SaveArg<0>(&endLocation), Return(true)));
+
+    Tokenizer<TokenTypes> tokenizer(ruleSet, compilationUnit, stream);
+    ParserExecutor<TokenTypes> parser(callback, { TokenTypes::Whitespace, TokenTypes::NewLine });
+    EXPECT_TRUE(parser.Parse(tokenizer, ParseMode::Pipelined));
+    EXPECT_EQ("a", token1.Value());
+    EXPECT_EQ("b", token2.Value());
+    EXPECT_EQ("c", token3.Value());
+    EXPECT_EQ(SourceLocation(compilationUnit, 2, 1), token3.BeginLocation());
+    EXPECT_EQ(SourceLocation(compilationUnit, 2, 2), endLocation);
+}
+
+TEST_F(ParserExecutorTest, ParseInvalidPipelined)
+{
+    std::string compilationUnit("ABC");
+    std::string text{ "void main(void {})"};
+    std::istringstream stream(text);
+    ParserCallbackMock<TokenTypes>callback;
+    Token<TokenTypes> errorToken;
+    TokenizerRuleSet<TokenTypes> ruleSet({
+        { "//.*", SingleLineComment, true },
+        });
+
+    EXPECT_CALL(callback, OnToken(_, _)).Times(0);
+    EXPECT_CALL(callback, OnParseError(_)).WillOnce(DoAll(SaveArg<0>(&errorToken)));
+    EXPECT_CALL(callback, OnNoMoreToken(_)).Times(0);
+
+    Tokenizer<TokenTypes> tokenizer(ruleSet, compilationUnit, stream);
+    ParserExecutor<TokenTypes> parser(callback, { TokenTypes::Whitespace });
+    EXPECT_FALSE(parser.Parse(tokenizer, ParseMode::Pipelined));
+    EXPECT_EQ(text, errorToken.Value());
+    EXPECT_EQ(SourceLocation(compilationUnit, 1, 19), errorToken.EndLocation());
+}
+
 } // namespace parser
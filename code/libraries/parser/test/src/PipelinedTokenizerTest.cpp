@@ -0,0 +1,131 @@
+#include "test-platform/GoogleTest.h"
+
+#include "parser/PipelinedTokenizer.h"
+#include <chrono>
+#include <thread>
+
+namespace parser {
+
+namespace {
+
+const TokenizerRuleSet<int>& GetRuleSet()
+{
+    static const TokenizerRuleSet<int> ruleSet({
+        { "[ \t]+", TokenType{ 1 } },
+        { "\r?\n", TokenType{ 2 } },
+        { "[_a-zA-Z][_a-zA-Z0-9]*", TokenType{ 3 } },
+        { "\"[^\"]*\"", TokenType{ 4 } },
+        });
+    return ruleSet;
+}
+
+std::string GenerateSource(std::size_t numLines)
+{
+    std::string result;
+    for (std::size_t index = 0; index < numLines; ++index)
+    {
+        result += "name" + std::to_string(index) + " \"string\nvalue\"\tx\n";
+    }
+    return result;
+}
+
+} // namespace
+
+TEST(PipelinedTokenizerTest, EmptyStream)
+{
+    std::string compilationUnit("ABC");
+    std::istringstream stream("");
+    Tokenizer<int> source(GetRuleSet(), compilationUnit, stream);
+    PipelinedTokenizer<int> tokenizer(source);
+
+    EXPECT_FALSE(tokenizer.IsAtEnd());
+    EXPECT_TRUE(tokenizer.GetToken().IsNull());
+    EXPECT_TRUE(tokenizer.IsAtEnd());
+    EXPECT_TRUE(tokenizer.GetToken().IsNull());
+}
+
+TEST(PipelinedTokenizerTest, SameAsTokenizer)
+{
+    std::string compilationUnit("ABC");
+    auto text = GenerateSource(1000);
+    std::istringstream expectedStream(text);
+    std::istringstream stream(text);
+    Tokenizer<int> expectedTokenizer(GetRuleSet(), compilationUnit, expectedStream);
+    Tokenizer<int> source(GetRuleSet(), compilationUnit, stream);
+    // A small queue makes the producer wait for the consumer
+    PipelinedTokenizer<int> tokenizer(source, 4);
+
+    std::size_t count{};
+    for (auto expected = expectedTokenizer.GetToken(); !expected.IsNull(); expected = expectedTokenizer.GetToken())
+    {
+        auto token = tokenizer.GetToken();
+        ASSERT_EQ(expected, token) << "Token " << count;
+        ++count;
+    }
+    EXPECT_TRUE(tokenizer.GetToken().IsNull());
+    EXPECT_EQ(size_t{ 6000 }, count);
+    EXPECT_EQ(expectedTokenizer.GetCurrentLocation(), tokenizer.GetCurrentLocation());
+}
+
+TEST(PipelinedTokenizerTest, SlowConsumer)
+{
+    std::string compilationUnit("ABC");
+    auto text = GenerateSource(100);
+    std::istringstream expectedStream(text);
+    std::istringstream stream(text);
+    Tokenizer<int> expectedTokenizer(GetRuleSet(), compilationUnit, expectedStream);
+    Tokenizer<int> source(GetRuleSet(), compilationUnit, stream);
+    // The producer fills the queue and waits until the consumer makes room
+    PipelinedTokenizer<int> tokenizer(source, 1);
+
+    std::size_t count{};
+    for (auto expected = expectedTokenizer.GetToken(); !expected.IsNull(); expected = expectedTokenizer.GetToken())
+    {
+        if (count % 100 == 0)
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        ASSERT_EQ(expected, tokenizer.GetToken()) << "Token " << count;
+        ++count;
+    }
+    EXPECT_TRUE(tokenizer.GetToken().IsNull());
+    EXPECT_EQ(size_t{ 600 }, count);
+}
+
+TEST(PipelinedTokenizerTest, UngetToken)
+{
+    std::string compilationUnit("ABC");
+    std::istringstream stream("a b");
+    Tokenizer<int> source(GetRuleSet(), compilationUnit, stream);
+    PipelinedTokenizer<int> tokenizer(source);
+
+    auto token1 = tokenizer.GetToken();
+    auto token2 = tokenizer.GetToken();
+    EXPECT_EQ(" ", token2.Value());
+    EXPECT_EQ(SourceLocation(compilationUnit, 1, 3), tokenizer.GetCurrentLocation());
+    tokenizer.UngetToken(token2);
+    tokenizer.UngetToken(token1);
+    EXPECT_EQ(token1, tokenizer.GetToken());
+    auto view = tokenizer.GetTokenView();
+    EXPECT_TRUE(view.IsRestored());
+    EXPECT_EQ(token2, tokenizer.MakeToken(view));
+    EXPECT_EQ("b", tokenizer.GetToken().Value());
+    EXPECT_TRUE(tokenizer.GetToken().IsNull());
+    tokenizer.UngetToken(token1);
+    EXPECT_FALSE(tokenizer.IsAtEnd());
+    EXPECT_EQ(token1, tokenizer.GetToken());
+    EXPECT_TRUE(tokenizer.IsAtEnd());
+}
+
+TEST(PipelinedTokenizerTest, DestroyBeforeEnd)
+{
+    std::string compilationUnit("ABC");
+    std::istringstream stream(GenerateSource(1000));
+    Tokenizer<int> source(GetRuleSet(), compilationUnit, stream);
+    {
+        PipelinedTokenizer<int> tokenizer(source, 2);
+        EXPECT_EQ("name0", tokenizer.GetToken().Value());
+    }
+    // The producer stopped, and read at most a few tokens beyond the queue
+    EXPECT_FALSE(source.GetToken().IsNull());
+}
+
+} // namespace parser
@@ -1,6 +1,7 @@
 #include "parser/Reader.h"
 
 #include "test-platform/GoogleTest.h"
+#include "parser/ParseArena.h"
 
 using namespace parser;
 
@@ -67,6 +68,20 @@ TEST(ReaderTest, NonEmptyStream)
     EXPECT_TRUE(reader.EndOfStream());
 }
 
+TEST(ReaderTest, StreamInArena)
+{
+    std::string compilationUnit("ABC");
+    std::istringstream stream("a text that is longer than the small string buffer");
+    ParseArena arena;
+    Reader reader(compilationUnit, stream, arena.Resource());
+
+    EXPECT_LT(size_t{ 0 }, arena.BytesReserved());
+    EXPECT_EQ("a text", reader.GetText(0, 6));
+    char ch;
+    EXPECT_TRUE(reader.GetChar(ch));
+    EXPECT_EQ('a', ch);
+}
+
 TEST(ReaderTest, RestoreChars)
 {
     std::string compilationUnit("ABC");
@@ -151,3 +166,94 @@ TEST(ReaderTest, RestoreChars)
     EXPECT_EQ(SourceLocation(compilationUnit, 3, 1), reader.GetLocation());
     EXPECT_TRUE(reader.EndOfStream());
 }
+
+TEST(ReaderTest, EmptyBuffer)
+{
+    std::string compilationUnit("ABC");
+    Reader reader(compilationUnit, std::string_view{});
+
+    char ch;
+    EXPECT_FALSE(reader.EndOfStream());
+    EXPECT_FALSE(reader.GetChar(ch));
+    EXPECT_EQ(SourceLocation(compilationUnit, 1, 1), reader.GetLocation());
+    EXPECT_TRUE(reader.EndOfStream());
+}
+
+TEST(ReaderTest, NonEmptyBuffer)
+{
+    std::string compilationUnit("ABC");
+    std::string text("1\n2\r3\n\r");
+    Reader reader(compilationUnit, text);
+
+    char ch;
+    std::string result;
+    while (reader.GetChar(ch))
+        result += ch;
+    EXPECT_EQ(text, result);
+    EXPECT_EQ(text.length(), reader.GetOffset());
+    EXPECT_EQ(SourceLocation(compilationUnit, 3, 1), reader.GetLocation());
+    EXPECT_TRUE(reader.EndOfStream());
+
+    EXPECT_EQ(SourceLocation(compilationUnit, 1, 1), reader.GetLocation(0));
+    EXPECT_EQ(SourceLocation(compilationUnit, 1, 2), reader.GetLocation(1));
+    EXPECT_EQ(SourceLocation(compilationUnit, 2, 1), reader.GetLocation(2));
+    EXPECT_EQ(SourceLocation(compilationUnit, 2, 2), reader.GetLocation(3));
+    EXPECT_EQ(SourceLocation(compilationUnit, 2, 1), reader.GetLocation(4));
+    EXPECT_EQ(SourceLocation(compilationUnit, 2, 2), reader.GetLocation(5));
+    EXPECT_EQ(SourceLocation(compilationUnit, 3, 1), reader.GetLocation(6));
+}
+
+TEST(ReaderTest, RewindBuffer)
+{
+    std::string compilationUnit("ABC");
+    std::string text("1\n2\r3\n\r");
+    Reader reader(compilationUnit, text);
+
+    char ch;
+    EXPECT_TRUE(reader.GetChar(ch));
+    EXPECT_TRUE(reader.GetChar(ch));
+    EXPECT_TRUE(reader.GetChar(ch));
+    EXPECT_EQ('2', ch);
+    EXPECT_EQ(SourceLocation(compilationUnit, 2, 2), reader.GetLocation());
+
+    reader.Rewind(2);
+    EXPECT_EQ(size_t{ 1 }, reader.GetOffset());
+    EXPECT_EQ(SourceLocation(compilationUnit, 1, 2), reader.GetLocation());
+    EXPECT_TRUE(reader.GetChar(ch));
+    EXPECT_EQ('\n', ch);
+    EXPECT_EQ(SourceLocation(compilationUnit, 2, 1), reader.GetLocation());
+
+    while (reader.GetChar(ch))
+        ;
+    EXPECT_TRUE(reader.EndOfStream());
+    reader.Rewind(1);
+    EXPECT_FALSE(reader.EndOfStream());
+    EXPECT_TRUE(reader.GetChar(ch));
+    EXPECT_EQ('\r', ch);
+    EXPECT_FALSE(reader.GetChar(ch));
+    EXPECT_TRUE(reader.EndOfStream());
+}
+
+TEST(ReaderTest, SeekRegisteredBuffer)
+{
+    std::string compilationUnit("ABC");
+    std::string text("1\n2\r3\n\r");
+    auto fileId = FileTable::Register(compilationUnit, text);
+    Reader reader(fileId, text);
+
+    EXPECT_EQ(fileId, reader.GetFileId());
+    char ch;
+    reader.Seek(2);
+    EXPECT_TRUE(reader.GetChar(ch));
+    EXPECT_EQ('2', ch);
+    EXPECT_EQ(SourceLocation(compilationUnit, 2, 2), reader.GetLocation());
+
+    reader.Seek(text.size() + 1);
+    EXPECT_EQ(text.size(), reader.GetOffset());
+    EXPECT_FALSE(reader.GetChar(ch));
+    EXPECT_TRUE(reader.EndOfStream());
+    reader.Seek(0);
+    EXPECT_FALSE(reader.EndOfStream());
+    EXPECT_TRUE(reader.GetChar(ch));
+    EXPECT_EQ('1', ch);
+}
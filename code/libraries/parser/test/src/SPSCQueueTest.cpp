@@ -0,0 +1,70 @@
+#include "test-platform/GoogleTest.h"
+
+#include <thread>
+#include "parser/SPSCQueue.h"
+
+namespace parser {
+
+TEST(SPSCQueueTest, Construct)
+{
+    SPSCQueue<int> queue;
+
+    EXPECT_EQ(SPSCQueue<int>::DefaultCapacity, queue.Capacity());
+    int value{};
+    EXPECT_FALSE(queue.TryPop(value));
+}
+
+TEST(SPSCQueueTest, ConstructCapacityNotPowerOfTwo)
+{
+    EXPECT_THROW(SPSCQueue<int>(0), std::invalid_argument);
+    EXPECT_THROW(SPSCQueue<int>(3), std::invalid_argument);
+}
+
+TEST(SPSCQueueTest, PushAndPop)
+{
+    SPSCQueue<int> queue(4);
+
+    EXPECT_TRUE(queue.TryPush(1));
+    EXPECT_TRUE(queue.TryPush(2));
+    EXPECT_TRUE(queue.TryPush(3));
+    EXPECT_TRUE(queue.TryPush(4));
+    EXPECT_FALSE(queue.TryPush(5));
+    int value{};
+    EXPECT_TRUE(queue.TryPop(value));
+    EXPECT_EQ(1, value);
+    EXPECT_TRUE(queue.TryPush(5));
+    for (int expected = 2; expected <= 5; ++expected)
+    {
+        EXPECT_TRUE(queue.TryPop(value));
+        EXPECT_EQ(expected, value);
+    }
+    EXPECT_FALSE(queue.TryPop(value));
+}
+
+TEST(SPSCQueueTest, ProducerAndConsumerThreads)
+{
+    const int NumValues = 100000;
+    SPSCQueue<int> queue(8);
+
+    std::thread producer([&queue]()
+    {
+        for (int value = 0; value < NumValues; ++value)
+        {
+            while (!queue.TryPush(value))
+                std::this_thread::yield();
+        }
+    });
+    int mismatches{};
+    for (int expected = 0; expected < NumValues; ++expected)
+    {
+        int value{};
+        while (!queue.TryPop(value))
+            std::this_thread::yield();
+        if (value != expected)
+            ++mismatches;
+    }
+    producer.join();
+    EXPECT_EQ(0, mismatches);
+}
+
+} // namespace parser
@@ -78,3 +78,47 @@ TEST_F(SourceLocationTest, Serialize)
     SourceLocation sourceLocation(path, 2, 3);
     EXPECT_EQ("abc(2:3)", sourceLocation.Serialize());
 }
+
+TEST_F(SourceLocationTest, ConstructFromOffset)
+{
+    auto fileId = FileTable::Register(path, "1\n23");
+    SourceLocation sourceLocation(fileId, 3);
+    EXPECT_EQ(path, sourceLocation.UnitPath());
+    EXPECT_TRUE(sourceLocation.HasOffset());
+    EXPECT_EQ(std::uint32_t{ 3 }, sourceLocation.Offset());
+    EXPECT_EQ(2, sourceLocation.Line());
+    EXPECT_EQ(2, sourceLocation.Column());
+    EXPECT_EQ(SourceLocation(path, 2, 2), sourceLocation);
+    EXPECT_EQ("abc(2:2)", sourceLocation.Serialize());
+}
+
+TEST_F(SourceLocationTest, NextColFromOffset)
+{
+    auto fileId = FileTable::Register(path, "1\n23");
+    SourceLocation sourceLocation(fileId, 3);
+    sourceLocation.NextCol();
+    EXPECT_FALSE(sourceLocation.HasOffset());
+    EXPECT_EQ(2, sourceLocation.Line());
+    EXPECT_EQ(3, sourceLocation.Column());
+}
+
+TEST_F(SourceLocationTest, LargeLineAndColumn)
+{
+    SourceLocation sourceLocation(path, SourceLocation::MaxLine + 1, SourceLocation::MaxColumn + 1);
+    EXPECT_EQ(SourceLocation::MaxLine + 1, sourceLocation.Line());
+    EXPECT_EQ(SourceLocation::MaxColumn + 1, sourceLocation.Column());
+    EXPECT_EQ("abc(1048576:2047)", sourceLocation.Serialize());
+    sourceLocation.NextCol();
+    EXPECT_EQ(SourceLocation::MaxColumn + 2, sourceLocation.Column());
+
+    SourceLocation packedLocation(path, SourceLocation::MaxLine, SourceLocation::MaxColumn);
+    EXPECT_EQ(SourceLocation::MaxLine, packedLocation.Line());
+    EXPECT_EQ(SourceLocation::MaxColumn, packedLocation.Column());
+    packedLocation.NextCol();
+    EXPECT_EQ(SourceLocation::MaxColumn + 1, packedLocation.Column());
+}
+
+TEST_F(SourceLocationTest, Size)
+{
+    EXPECT_EQ(size_t{ 8 }, sizeof(SourceLocation));
+}
@@ -0,0 +1,279 @@
+#include "test-platform/GoogleTest.h"
+
+#include "parser/StaticGrammar.h"
+#include "parser/Tokenizer.h"
+
+namespace parser {
+
+namespace {
+
+enum Terminal
+{
+    Whitespace = 1,
+    NewLine,
+    Identifier,
+    Number,
+    String,
+    Comment,
+    If,
+    Null,
+    Equals,
+    Assign,
+};
+
+using Term = StaticTerminal<int>;
+
+constexpr std::size_t MatchNumber(std::string_view text)
+{
+    std::size_t index{};
+    while ((index < text.length()) && (text[index] >= '0') && (text[index] <= '9'))
+        ++index;
+    if ((index < text.length()) && (text[index] == '.'))
+    {
+        ++index;
+        while ((index < text.length()) && (text[index] >= '0') && (text[index] <= '9'))
+            ++index;
+    }
+    return index;
+}
+
+constexpr CharacterClass Letters = CharacterClass::Range('a', 'z') | CharacterClass::Range('A', 'Z') | CharacterClass::Of("_");
+constexpr CharacterClass Digits = CharacterClass::Range('0', '9');
+
+constexpr Term terminals[] = {
+    Term::Repeat(CharacterClass::Of(" \t"), Whitespace),
+    Term::Literal("\n", NewLine),
+    Term::Literal("\r\n", NewLine),
+    Term::Literal("if", If),
+    Term::Literal("null", Null, true),
+    Term::Word(Letters, Letters | Digits, Identifier),
+    Term::Custom(Digits, MatchNumber, "[0-9]+(?:\\.[0-9]*)?", Number),
+    Term::Quoted('"', '\\', String),
+    Term::LineComment("//", Comment),
+    Term::Literal("==", Equals),
+    Term::Literal("=", Assign),
+};
+
+constexpr StaticGrammar grammar(terminals);
+
+constexpr std::size_t MatchLength(std::string_view text)
+{
+    std::size_t length{};
+    grammar.Match(text, length);
+    return length;
+}
+
+// The grammar is usable in constant expressions
+static_assert(MatchLength("identifier_1 = 2") == 12, "Identifier is matched at compile time");
+static_assert(MatchLength("== 2") == 2, "Longest literal is matched at compile time");
+static_assert(grammar.NumTerminalsInGrammar() == 11, "Grammar holds all terminals");
+
+} // namespace
+
+TEST(CharacterClassTest, Construct)
+{
+    CharacterClass characters;
+
+    for (int ch = 0; ch < 256; ++ch)
+    {
+        EXPECT_FALSE(characters.Contains(static_cast<char>(ch)));
+    }
+}
+
+TEST(CharacterClassTest, OfAndRange)
+{
+    auto characters = CharacterClass::Of("ab\xff") | CharacterClass::Range('0', '2');
+
+    for (int ch = 0; ch < 256; ++ch)
+    {
+        bool expected = (ch == 'a') || (ch == 'b') || (ch == 0xff) || ((ch >= '0') && (ch <= '2'));
+        EXPECT_EQ(expected, characters.Contains(static_cast<char>(ch))) << "Character " << ch;
+    }
+}
+
+TEST(StaticTerminalTest, Literal)
+{
+    auto terminal = Term::Literal("if", If);
+
+    EXPECT_EQ(TerminalKind::Literal, terminal.kind);
+    EXPECT_EQ(size_t{ 2 }, terminal.Match("if("));
+    EXPECT_EQ(size_t{ 0 }, terminal.Match("IF("));
+    EXPECT_EQ(size_t{ 0 }, terminal.Match("i"));
+    EXPECT_EQ(size_t{ 0 }, terminal.Match(""));
+}
+
+TEST(StaticTerminalTest, LiteralCaseInsensitive)
+{
+    auto terminal = Term::Literal("null", Null, true);
+
+    EXPECT_EQ(size_t{ 4 }, terminal.Match("null"));
+    EXPECT_EQ(size_t{ 4 }, terminal.Match("NuLl,"));
+    EXPECT_EQ(size_t{ 0 }, terminal.Match("nul"));
+}
+
+TEST(StaticTerminalTest, Repeat)
+{
+    auto terminal = Term::Repeat(CharacterClass::Of(" \t"), Whitespace);
+
+    EXPECT_EQ(size_t{ 3 }, terminal.Match(" \t x"));
+    EXPECT_EQ(size_t{ 0 }, terminal.Match("x "));
+}
+
+TEST(StaticTerminalTest, Word)
+{
+    auto terminal = Term::Word(Letters, Letters | Digits, Identifier);
+
+    EXPECT_EQ(size_t{ 4 }, terminal.Match("_a1b-c"));
+    EXPECT_EQ(size_t{ 0 }, terminal.Match("1ab"));
+}
+
+TEST(StaticTerminalTest, Quoted)
+{
+    auto terminal = Term::Quoted('"', '\\', String);
+
+    EXPECT_EQ(size_t{ 5 }, terminal.Match("\"abc\" x"));
+    EXPECT_EQ(size_t{ 8 }, terminal.Match("\"a\\\"b\\\\\""));
+    EXPECT_EQ(size_t{ 5 }, terminal.Match("\"a\nb\"\n"));
+    EXPECT_EQ(size_t{ 0 }, terminal.Match("\"a\\\nb\""));
+    EXPECT_EQ(size_t{ 0 }, terminal.Match("\"abc"));
+    EXPECT_EQ(size_t{ 0 }, terminal.Match("\"abc\\"));
+}
+
+TEST(StaticTerminalTest, LineComment)
+{
+    auto terminal = Term::LineComment("//", Comment);
+
+    EXPECT_EQ(size_t{ 6 }, terminal.Match("// abc\r\nx"));
+    EXPECT_EQ(size_t{ 2 }, terminal.Match("//"));
+    EXPECT_EQ(size_t{ 0 }, terminal.Match("/ abc"));
+}
+
+TEST(StaticTerminalTest, Custom)
+{
+    auto terminal = Term::Custom(Digits, MatchNumber, "[0-9]+(?:\\.[0-9]*)?", Number);
+
+    EXPECT_EQ(size_t{ 4 }, terminal.Match("12.5x"));
+    EXPECT_EQ(size_t{ 0 }, terminal.Match(".5"));
+    EXPECT_EQ("[0-9]+(?:\\.[0-9]*)?", terminal.Pattern());
+}
+
+TEST(StaticTerminalTest, Pattern)
+{
+    EXPECT_EQ("\\x3D\\x3D", Term::Literal("==", Equals).Pattern());
+    EXPECT_EQ("[\\x6E\\x4E]\\x31", Term::Literal("n1", Null, true).Pattern());
+    EXPECT_EQ("[\\x09\\x20]+", Term::Repeat(CharacterClass::Of(" \t"), Whitespace).Pattern());
+    EXPECT_EQ("[\\x61][\\x30\\x61]*", Term::Word(CharacterClass::Of("a"), CharacterClass::Of("a0"), Identifier).Pattern());
+    EXPECT_EQ("\\x22(?:[^\\x22\\x5C]|\\x5C[^\\n\\r])*\\x22", Term::Quoted('"', '\\', String).Pattern());
+    EXPECT_EQ("\\x2F\\x2F[^\\n\\r]*", Term::LineComment("//", Comment).Pattern());
+}
+
+TEST(StaticGrammarTest, Match)
+{
+    std::size_t length{};
+
+    EXPECT_EQ(int{ Identifier }, grammar.Match("abc def", length));
+    EXPECT_EQ(size_t{ 3 }, length);
+    EXPECT_EQ(int{ Number }, grammar.Match("3.14)", length));
+    EXPECT_EQ(size_t{ 4 }, length);
+    EXPECT_EQ(int{ NewLine }, grammar.Match("\r\nx", length));
+    EXPECT_EQ(size_t{ 2 }, length);
+}
+
+TEST(StaticGrammarTest, MatchLongest)
+{
+    std::size_t length{};
+
+    EXPECT_EQ(int{ Equals }, grammar.Match("==x", length));
+    EXPECT_EQ(size_t{ 2 }, length);
+    EXPECT_EQ(int{ Assign }, grammar.Match("=x", length));
+    EXPECT_EQ(size_t{ 1 }, length);
+    EXPECT_EQ(int{ Identifier }, grammar.Match("iffy", length));
+    EXPECT_EQ(size_t{ 4 }, length);
+}
+
+TEST(StaticGrammarTest, MatchFirstOfEqualLength)
+{
+    std::size_t length{};
+
+    EXPECT_EQ(int{ If }, grammar.Match("if(", length));
+    EXPECT_EQ(size_t{ 2 }, length);
+    EXPECT_EQ(int{ Null }, grammar.Match("NULL", length));
+    EXPECT_EQ(size_t{ 4 }, length);
+}
+
+TEST(StaticGrammarTest, MatchInvalid)
+{
+    std::size_t length{};
+
+    EXPECT_TRUE(grammar.Match("?abc def", length) == TokenType<int>::InvalidToken);
+    EXPECT_EQ(size_t{ 8 }, length);
+    EXPECT_TRUE(grammar.Match("\"abc", length) == TokenType<int>::InvalidToken);
+    EXPECT_EQ(size_t{ 4 }, length);
+}
+
+TEST(StaticGrammarTest, MatchEmpty)
+{
+    std::size_t length{ 1 };
+
+    EXPECT_TRUE(grammar.Match("", length).IsNull());
+    EXPECT_EQ(size_t{ 0 }, length);
+}
+
+TEST(StaticGrammarTest, Tokenize)
+{
+    std::string compilationUnit("ABC");
+    std::string text("if x == \"a b\" // test\r\n\ty = 1.5 ?");
+
+    auto tokens = Tokenize(grammar, compilationUnit, text);
+
+    std::vector<int> expectedTypes{ If, Whitespace, Identifier, Whitespace, Equals, Whitespace, String, Whitespace, Comment, NewLine,
+        Whitespace, Identifier, Whitespace, Assign, Whitespace, Number, Whitespace };
+    ASSERT_EQ(expectedTypes.size() + 1, tokens.Size());
+    std::size_t offset{};
+    for (std::size_t index = 0; index < expectedTypes.size(); ++index)
+    {
+        auto token = tokens.View(index);
+        EXPECT_EQ(expectedTypes[index], token.Type()) << "Token " << index;
+        EXPECT_EQ(offset, token.Offset()) << "Token " << index;
+        offset += token.Length();
+    }
+    EXPECT_TRUE(tokens.View(expectedTypes.size()).IsInvalid());
+    EXPECT_EQ("?", tokens.View(expectedTypes.size()).Value());
+    EXPECT_EQ(compilationUnit, FileTable::UnitPath(tokens.GetFileId()));
+}
+
+TEST(StaticGrammarTest, RuleSetSameAsGrammar)
+{
+    std::string compilationUnit("ABC");
+    std::string text("if x == \"a \\\" b\" // test\r\n\ty = 1.5 NULL nullx 12. \"bad\\\nescape\" \"unterminated ?");
+    TokenizerRuleSet<int> ruleSet(MakeTokenizerRules(grammar));
+
+    auto expected = Tokenize(grammar, compilationUnit, text);
+    auto tokens = Tokenize(ruleSet, compilationUnit, text);
+    ASSERT_EQ(expected.Size(), tokens.Size());
+    for (std::size_t index = 0; index < tokens.Size(); ++index)
+    {
+        EXPECT_EQ(expected.MakeToken(index), tokens.MakeToken(index)) << "Token " << index;
+    }
+}
+
+TEST(StaticGrammarTest, GrammarId)
+{
+    constexpr Term otherTerminals[] = {
+        Term::Repeat(CharacterClass::Of(" \t"), Whitespace),
+        Term::Literal("if", If),
+    };
+    constexpr Term otherTypes[] = {
+        Term::Repeat(CharacterClass::Of(" \t"), NewLine),
+        Term::Literal("if", If),
+    };
+    constexpr StaticGrammar otherGrammar(otherTerminals);
+    constexpr StaticGrammar otherTypesGrammar(otherTypes);
+
+    EXPECT_EQ(GrammarId("Lexer", grammar), GrammarId("Lexer", grammar));
+    EXPECT_NE(GrammarId("Lexer", grammar), GrammarId("OtherLexer", grammar));
+    EXPECT_NE(GrammarId("Lexer", grammar), GrammarId("Lexer", otherGrammar));
+    EXPECT_NE(GrammarId("Lexer", otherGrammar), GrammarId("Lexer", otherTypesGrammar));
+}
+
+} // namespace parser
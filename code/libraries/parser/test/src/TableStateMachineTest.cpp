@@ -0,0 +1,147 @@
+#include "parser/TableStateMachine.h"
+
+#include "test-platform/GoogleTest.h"
+
+using namespace parser;
+
+namespace {
+
+enum class State
+{
+    State1,
+    State2,
+    State3,
+};
+enum class Stimulus
+{
+    A,
+    B,
+};
+using Data = int*;
+constexpr std::size_t NumStates = 3;
+constexpr std::size_t NumStimuli = 2;
+using Rule = StateTableRule<State, Stimulus, Data>;
+using Table = StateTable<State, Stimulus, Data, NumStates, NumStimuli>;
+
+bool CountTransition(State /*from*/, State /*to*/, Stimulus /*input*/, Data data)
+{
+    ++*data;
+    return true;
+}
+
+bool RejectTransition(State /*from*/, State /*to*/, Stimulus /*input*/, Data /*data*/)
+{
+    return false;
+}
+
+State HandleInputAction(State from, Stimulus input, Data /*data*/)
+{
+    if (input == Stimulus::A)
+        return (from == State::State3) ? State::State2 : State::State1;
+    return (from == State::State1) ? State::State2 : State::State3;
+}
+
+constexpr Table transitionTable{
+    Rule::Transition(State::State1, State::State1, Stimulus::A, CountTransition),
+    Rule::Transition(State::State1, State::State2, Stimulus::B, CountTransition),
+    Rule::Transition(State::State2, State::State1, Stimulus::A, CountTransition),
+    Rule::Transition(State::State2, State::State3, Stimulus::B, CountTransition),
+    Rule::Transition(State::State3, State::State2, Stimulus::A),
+    Rule::Transition(State::State3, State::State3, Stimulus::B, RejectTransition),
+};
+
+static_assert(transitionTable.Find(State::State1, Stimulus::B) != nullptr);
+static_assert(transitionTable.Find(State::State1, Stimulus::B)->to == State::State2);
+
+} // namespace
+
+TEST(TableStateMachineTest, Construct)
+{
+    constexpr Table table{};
+    TableStateMachine<State, Stimulus, Data, NumStates, NumStimuli> stateMachine(table);
+
+    EXPECT_EQ(State::State1, stateMachine.GetState());
+    EXPECT_FALSE(stateMachine.HandleInput(Stimulus::A, nullptr));
+    EXPECT_EQ(State::State1, stateMachine.GetState());
+}
+
+TEST(TableStateMachineTest, SetState)
+{
+    TableStateMachine<State, Stimulus, Data, NumStates, NumStimuli> stateMachine(transitionTable);
+    stateMachine.SetState(State::State2);
+
+    EXPECT_EQ(State::State2, stateMachine.GetState());
+}
+
+TEST(TableStateMachineTest, HandleInput)
+{
+    TableStateMachine<State, Stimulus, Data, NumStates, NumStimuli> stateMachine(transitionTable);
+    int count{};
+
+    EXPECT_TRUE(stateMachine.HandleInput(Stimulus::A, &count));
+    EXPECT_EQ(State::State1, stateMachine.GetState());
+    EXPECT_TRUE(stateMachine.HandleInput(Stimulus::B, &count));
+    EXPECT_EQ(State::State2, stateMachine.GetState());
+    EXPECT_TRUE(stateMachine.HandleInput(Stimulus::B, &count));
+    EXPECT_EQ(State::State3, stateMachine.GetState());
+    EXPECT_EQ(3, count);
+    EXPECT_FALSE(stateMachine.HandleInput(Stimulus::B, &count));
+    EXPECT_EQ(State::State3, stateMachine.GetState());
+    EXPECT_TRUE(stateMachine.HandleInput(Stimulus::A, &count));
+    EXPECT_EQ(State::State2, stateMachine.GetState());
+    EXPECT_EQ(3, count);
+}
+
+TEST(TableStateMachineTest, HandleInputWithInputAction)
+{
+    Table table;
+    for (auto state : { State::State1, State::State2, State::State3 })
+    {
+        table.Add(Rule::HandleInput(state, Stimulus::A, HandleInputAction));
+        table.Add(Rule::HandleInput(state, Stimulus::B, HandleInputAction));
+    }
+    TableStateMachine<State, Stimulus, Data, NumStates, NumStimuli> stateMachine(table);
+
+    EXPECT_TRUE(stateMachine.HandleInput(Stimulus::B, nullptr));
+    EXPECT_EQ(State::State2, stateMachine.GetState());
+    EXPECT_TRUE(stateMachine.HandleInput(Stimulus::B, nullptr));
+    EXPECT_EQ(State::State3, stateMachine.GetState());
+    EXPECT_TRUE(stateMachine.HandleInput(Stimulus::A, nullptr));
+    EXPECT_EQ(State::State2, stateMachine.GetState());
+    EXPECT_TRUE(stateMachine.HandleInput(Stimulus::A, nullptr));
+    EXPECT_EQ(State::State1, stateMachine.GetState());
+}
+
+TEST(TableStateMachineTest, HandleInputCallback)
+{
+    static State lastFrom{};
+    static State lastTo{};
+    TableStateMachine<State, Stimulus, Data, NumStates, NumStimuli> stateMachine(transitionTable);
+    stateMachine.SetCallback([](State from, State to, Stimulus /*input*/, Data /*data*/) { lastFrom = from; lastTo = to; });
+    int count{};
+
+    EXPECT_TRUE(stateMachine.HandleInput(Stimulus::B, &count));
+    EXPECT_EQ(State::State1, lastFrom);
+    EXPECT_EQ(State::State2, lastTo);
+}
+
+TEST(TableStateMachineTest, FirstRuleWins)
+{
+    constexpr Table table{
+        Rule::Transition(State::State1, State::State2, Stimulus::A),
+        Rule::Transition(State::State1, State::State3, Stimulus::A),
+    };
+    static_assert(table.Find(State::State1, Stimulus::A)->to == State::State2);
+
+    TableStateMachine<State, Stimulus, Data, NumStates, NumStimuli> stateMachine(table);
+    EXPECT_TRUE(stateMachine.HandleInput(Stimulus::A, nullptr));
+    EXPECT_EQ(State::State2, stateMachine.GetState());
+}
+
+TEST(TableStateMachineTest, AddOutOfRangeThrows)
+{
+    Table table;
+    EXPECT_THROW(table.Add(Rule::Transition(static_cast<State>(NumStates), State::State1, Stimulus::A)), std::out_of_range);
+    EXPECT_THROW(table.Add(Rule::Transition(State::State1, State::State1, static_cast<Stimulus>(NumStimuli))), std::out_of_range);
+    EXPECT_EQ(nullptr, table.Find(State::State1, Stimulus::A));
+}
@@ -0,0 +1,61 @@
+#include "parser/ThreadPool.h"
+
+#include <atomic>
+#include <stdexcept>
+#include <vector>
+#include "test-platform/GoogleTest.h"
+
+namespace parser {
+
+TEST(ThreadPoolTest, Construct)
+{
+    ThreadPool pool(3);
+
+    EXPECT_EQ(size_t{ 3 }, pool.NumThreads());
+    EXPECT_LE(size_t{ 1 }, ThreadPool().NumThreads());
+}
+
+TEST(ThreadPoolTest, Async)
+{
+    ThreadPool pool(2);
+
+    std::vector<std::future<int>> results;
+    for (int index = 0; index < 100; ++index)
+    {
+        results.push_back(pool.Async([index]() { return index * index; }));
+    }
+    for (int index = 0; index < 100; ++index)
+    {
+        EXPECT_EQ(index * index, results[static_cast<std::size_t>(index)].get());
+    }
+}
+
+TEST(ThreadPoolTest, AsyncException)
+{
+    ThreadPool pool(1);
+
+    auto result = pool.Async([]() -> int { throw std::runtime_error("failed"); });
+    EXPECT_THROW(result.get(), std::runtime_error);
+}
+
+TEST(ThreadPoolTest, NestedTasksRunBeforeDestruction)
+{
+    std::atomic<int> count{};
+    {
+        ThreadPool pool(4);
+        for (int index = 0; index < 10; ++index)
+        {
+            pool.Submit([&pool, &count]()
+            {
+                for (int nested = 0; nested < 10; ++nested)
+                {
+                    pool.Submit([&count]() { ++count; });
+                }
+                ++count;
+            });
+        }
+    }
+    EXPECT_EQ(110, count);
+}
+
+} // namespace parser
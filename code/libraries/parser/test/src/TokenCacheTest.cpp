@@ -0,0 +1,137 @@
+#include "parser/TokenCache.h"
+
+#include <fstream>
+#include "test-platform/GoogleTest.h"
+#include "parser/Tokenizer.h"
+
+namespace parser {
+
+namespace {
+
+const std::uint64_t GrammarId = 3;
+
+class TokenCacheTest
+    : public ::testing::Test
+{
+public:
+    std::filesystem::path m_directory;
+    TokenizerRuleSet<int> m_ruleSet;
+    int m_numTokenized;
+
+    TokenCacheTest()
+        : m_directory{ std::filesystem::temp_directory_path() / "parser-token-cache-test" }
+        , m_ruleSet({
+            { "[ \t]+", TokenType{ 1 } },
+            { "[_a-zA-Z][_a-zA-Z0-9]*", TokenType{ 2 } },
+            { "\r?\n", TokenType{ 3 } },
+            })
+        , m_numTokenized{}
+    {
+    }
+    void SetUp() override
+    {
+        std::filesystem::remove_all(m_directory);
+    }
+    void TearDown() override
+    {
+        std::filesystem::remove_all(m_directory);
+    }
+    TokenStream<int> Tokenize(const TokenCache& cache, std::string_view source)
+    {
+        return cache.Tokenize<int>(GrammarId, "ABC", source, [this](const std::filesystem::path& unit, std::string_view text)
+        {
+            ++m_numTokenized;
+            return parser::Tokenize(m_ruleSet, unit, text);
+        });
+    }
+};
+
+void ExpectSameTokens(const TokenStream<int>& expected, const TokenStream<int>& actual)
+{
+    EXPECT_EQ(expected.Types(), actual.Types());
+    EXPECT_EQ(expected.Offsets(), actual.Offsets());
+    EXPECT_EQ(expected.Lengths(), actual.Lengths());
+}
+
+} // namespace
+
+TEST_F(TokenCacheTest, Construct)
+{
+    TokenCache cache(m_directory);
+
+    EXPECT_EQ(m_directory, cache.Directory());
+    auto key = TokenCacheKey::Make("ab c", GrammarId);
+    EXPECT_EQ(m_directory, cache.EntryPath(key).parent_path());
+    EXPECT_NE(cache.EntryPath(key), cache.EntryPath(TokenCacheKey::Make("ab c", GrammarId + 1)));
+}
+
+TEST_F(TokenCacheTest, TokenizeStoresAndLoads)
+{
+    TokenCache cache(m_directory);
+    std::string text{ "ab c\nd &" };
+
+    auto tokens = Tokenize(cache, text);
+    EXPECT_EQ(1, m_numTokenized);
+    EXPECT_TRUE(std::filesystem::exists(cache.EntryPath(TokenCacheKey::Make(text, GrammarId))));
+
+    auto cachedTokens = Tokenize(cache, text);
+    EXPECT_EQ(1, m_numTokenized);
+    ExpectSameTokens(tokens, cachedTokens);
+    ASSERT_EQ(size_t{ 7 }, cachedTokens.Size());
+    EXPECT_TRUE(cachedTokens.Type(6).IsInvalid());
+    EXPECT_EQ(text.data() + 5, cachedTokens.Value(4).data());
+    EXPECT_EQ(SourceLocation("ABC", 2, 1), cachedTokens.MakeToken(4).BeginLocation());
+}
+
+TEST_F(TokenCacheTest, ChangedTextIsLexed)
+{
+    TokenCache cache(m_directory);
+
+    Tokenize(cache, "ab c");
+    auto tokens = Tokenize(cache, "ab d");
+    EXPECT_EQ(2, m_numTokenized);
+    EXPECT_EQ("d", tokens.Value(2));
+}
+
+TEST_F(TokenCacheTest, OtherGrammarIsLexed)
+{
+    TokenCache cache(m_directory);
+    std::string text{ "ab c" };
+    TokenStream<int> tokens(text, FileTable::NoFile);
+
+    Tokenize(cache, text);
+    EXPECT_FALSE(cache.Load(TokenCacheKey::Make(text, GrammarId + 1), tokens));
+    EXPECT_TRUE(cache.Load(TokenCacheKey::Make(text, GrammarId), tokens));
+}
+
+TEST_F(TokenCacheTest, CorruptEntryIsIgnored)
+{
+    TokenCache cache(m_directory);
+    std::string text{ "ab c" };
+
+    Tokenize(cache, text);
+    std::ofstream(cache.EntryPath(TokenCacheKey::Make(text, GrammarId)), std::ios::binary | std::ios::trunc) << "PTOK";
+    auto tokens = Tokenize(cache, text);
+    EXPECT_EQ(2, m_numTokenized);
+    EXPECT_EQ(size_t{ 3 }, tokens.Size());
+}
+
+TEST_F(TokenCacheTest, HugeTokenCountIsIgnored)
+{
+    TokenCache cache(m_directory);
+    std::string text{ "ab c" };
+
+    Tokenize(cache, text);
+    // A token count for which the size of the arrays wraps around to the actual size of the entry
+    std::uint64_t numTokens = 3 + (std::uint64_t{ 1 } << 62);
+    {
+        std::fstream stream(cache.EntryPath(TokenCacheKey::Make(text, GrammarId)), std::ios::binary | std::ios::in | std::ios::out);
+        stream.seekp(32);
+        stream.write(reinterpret_cast<const char*>(&numTokens), sizeof(numTokens));
+    }
+    auto tokens = Tokenize(cache, text);
+    EXPECT_EQ(2, m_numTokenized);
+    EXPECT_EQ(size_t{ 3 }, tokens.Size());
+}
+
+} // namespace parser
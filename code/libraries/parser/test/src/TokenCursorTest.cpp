@@ -0,0 +1,71 @@
+#include "test-platform/GoogleTest.h"
+
+#include "parser/TokenCursor.h"
+
+namespace parser {
+
+class TokenCursorTest
+    : public ::testing::Test
+{
+public:
+    std::string text;
+    TokenStream<int> stream;
+
+    TokenCursorTest()
+        : text{ "a b" }
+        , stream(text, FileTable::NoFile)
+    {
+        stream.Add(TokenView<int>(TokenType{ 2 }, std::string_view(text).substr(0, 1), 0));
+        stream.Add(TokenView<int>(TokenType{ 1 }, std::string_view(text).substr(1, 1), 1));
+        stream.Add(TokenView<int>(TokenType{ 2 }, std::string_view(text).substr(2, 1), 2));
+    }
+};
+
+TEST_F(TokenCursorTest, Construct)
+{
+    TokenCursor<int> cursor(stream);
+
+    EXPECT_EQ(size_t{ 0 }, cursor.Position());
+    EXPECT_FALSE(cursor.IsAtEnd());
+    EXPECT_EQ(TokenType{ 2 }, cursor.Type());
+    EXPECT_EQ("a", cursor.View().Value());
+}
+
+TEST_F(TokenCursorTest, NextAndBack)
+{
+    TokenCursor<int> cursor(stream);
+
+    cursor.Next();
+    EXPECT_EQ(TokenType{ 1 }, cursor.Type());
+    cursor.Next(2);
+    EXPECT_TRUE(cursor.IsAtEnd());
+    EXPECT_TRUE(cursor.View().IsNull());
+    EXPECT_TRUE(cursor.GetToken().IsNull());
+    cursor.Back();
+    EXPECT_EQ("b", cursor.View().Value());
+    cursor.Back(5);
+    EXPECT_EQ(size_t{ 0 }, cursor.Position());
+}
+
+TEST_F(TokenCursorTest, Peek)
+{
+    TokenCursor<int> cursor(stream, 1);
+
+    EXPECT_EQ(TokenType{ 1 }, cursor.PeekType(0));
+    EXPECT_EQ(TokenType{ 2 }, cursor.PeekType(1));
+    EXPECT_EQ(TokenType<int>{}, cursor.PeekType(2));
+    EXPECT_EQ("b", cursor.PeekView(1).Value());
+    EXPECT_TRUE(cursor.PeekView(2).IsNull());
+}
+
+TEST_F(TokenCursorTest, Seek)
+{
+    TokenCursor<int> cursor(stream);
+
+    cursor.Seek(2);
+    EXPECT_EQ("b", cursor.GetToken().Value());
+    cursor.Seek(3);
+    EXPECT_TRUE(cursor.IsAtEnd());
+}
+
+} // namespace parser
@@ -0,0 +1,59 @@
+#include "test-platform/GoogleTest.h"
+
+#include "parser/TokenRing.h"
+
+namespace parser {
+
+TEST(TokenRingTest, Construct)
+{
+    TokenRing<int> ring;
+
+    EXPECT_EQ(TokenRing<int>::DefaultCapacity, ring.Capacity());
+    EXPECT_EQ(size_t{ 0 }, ring.Size());
+    EXPECT_TRUE(ring.IsEmpty());
+    EXPECT_FALSE(ring.IsFull());
+}
+
+TEST(TokenRingTest, ConstructRoundsCapacityToPowerOfTwo)
+{
+    TokenRing<int> ring(5);
+
+    EXPECT_EQ(size_t{ 8 }, ring.Capacity());
+}
+
+TEST(TokenRingTest, PushBackAndPopFront)
+{
+    TokenRing<int> ring(2);
+    std::string text{ "ab" };
+
+    ring.PushBack(TokenView<int>(TokenType{ 1 }, std::string_view(text).substr(0, 1), 0));
+    ring.PushBack(TokenView<int>(TokenType{ 2 }, std::string_view(text).substr(1, 1), 1));
+    EXPECT_TRUE(ring.IsFull());
+    EXPECT_EQ(TokenType{ 1 }, ring.Front().Type());
+    EXPECT_EQ(TokenType{ 2 }, ring[1].Type());
+    EXPECT_THROW(ring.PushBack(TokenView<int>()), std::length_error);
+
+    EXPECT_EQ("a", ring.PopFront().Value());
+    ring.PushBack(TokenView<int>(TokenType{ 3 }, std::string_view(text).substr(0, 1), 0));
+    EXPECT_EQ("b", ring.PopFront().Value());
+    EXPECT_EQ(TokenType{ 3 }, ring.PopFront().Type());
+    EXPECT_TRUE(ring.IsEmpty());
+}
+
+TEST(TokenRingTest, PushFront)
+{
+    TokenRing<int> ring(4);
+
+    ring.PushBack(TokenView<int>(TokenType{ 2 }, {}, 1));
+    ring.PushFront(TokenView<int>(TokenType{ 1 }, {}, 0));
+    ring.PushFront(TokenView<int>(TokenType{ 0 }, {}, 0));
+    EXPECT_EQ(size_t{ 3 }, ring.Size());
+    EXPECT_EQ(TokenType{ 0 }, ring[0].Type());
+    EXPECT_EQ(TokenType{ 1 }, ring[1].Type());
+    EXPECT_EQ(TokenType{ 2 }, ring[2].Type());
+
+    ring.Clear();
+    EXPECT_TRUE(ring.IsEmpty());
+}
+
+} // namespace parser
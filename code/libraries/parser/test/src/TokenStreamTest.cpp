@@ -0,0 +1,135 @@
+#include "test-platform/GoogleTest.h"
+
+#include "parser/ParseArena.h"
+#include "parser/Tokenizer.h"
+#include "parser/TokenStream.h"
+
+namespace parser {
+
+TEST(TokenStreamTest, Construct)
+{
+    TokenStream<int> stream;
+
+    EXPECT_TRUE(stream.IsEmpty());
+    EXPECT_EQ(size_t{ 0 }, stream.Size());
+    EXPECT_EQ(FileTable::NoFile, stream.GetFileId());
+}
+
+TEST(TokenStreamTest, Add)
+{
+    std::string text{ "ab c" };
+    TokenStream<int> stream(text, FileTable::NoFile);
+
+    stream.Add(TokenView<int>(TokenType{ 1 }, std::string_view(text).substr(0, 2), 0));
+    stream.Add(TokenView<int>(TokenType{ 2 }, std::string_view(text).substr(2, 1), 2));
+    EXPECT_EQ(size_t{ 2 }, stream.Size());
+    EXPECT_EQ(TokenType{ 1 }, stream.Type(0));
+    EXPECT_EQ(std::uint32_t{ 2 }, stream.Offset(1));
+    EXPECT_EQ(std::uint32_t{ 1 }, stream.Length(1));
+    EXPECT_EQ("ab", stream.Value(0));
+    EXPECT_EQ(text.data() + 2, stream.View(1).Value().data());
+    EXPECT_EQ(size_t{ 2 }, stream.Types().size());
+}
+
+TEST(TokenStreamTest, Append)
+{
+    std::string text{ "ab c" };
+    TokenStream<int> stream(text, FileTable::NoFile);
+    TokenStream<int> other(text, FileTable::NoFile);
+
+    stream.Add(TokenView<int>(TokenType{ 1 }, std::string_view(text).substr(0, 2), 0));
+    other.Add(TokenView<int>(TokenType{ 1 }, std::string_view(text).substr(0, 2), 0));
+    other.Add(TokenView<int>(TokenType{ 3 }, std::string_view(text).substr(2, 1), 2));
+    other.Add(TokenView<int>(TokenType{ 2 }, std::string_view(text).substr(3, 1), 3));
+    stream.Append(other, 1);
+    ASSERT_EQ(size_t{ 3 }, stream.Size());
+    EXPECT_EQ(TokenType{ 3 }, stream.Type(1));
+    EXPECT_EQ(std::uint32_t{ 3 }, stream.Offset(2));
+    EXPECT_EQ("c", stream.Value(2));
+}
+
+TEST(TokenStreamTest, Replace)
+{
+    std::string text{ "ab c" };
+    std::string newText{ "ab xyz c" };
+    TokenStream<int> stream(text, FileTable::NoFile);
+    TokenStream<int> other(newText, FileTable::NoFile);
+
+    stream.Add(TokenView<int>(TokenType{ 1 }, std::string_view(text).substr(0, 2), 0));
+    stream.Add(TokenView<int>(TokenType{ 2 }, std::string_view(text).substr(2, 1), 2));
+    stream.Add(TokenView<int>(TokenType{ 1 }, std::string_view(text).substr(3, 1), 3));
+    other.Add(TokenView<int>(TokenType{ 2 }, std::string_view(newText).substr(2, 1), 2));
+    other.Add(TokenView<int>(TokenType{ 1 }, std::string_view(newText).substr(3, 3), 3));
+    other.Add(TokenView<int>(TokenType{ 2 }, std::string_view(newText).substr(6, 1), 6));
+    stream.Replace(1, 1, other, 4);
+    ASSERT_EQ(size_t{ 5 }, stream.Size());
+    EXPECT_EQ(newText, stream.Source());
+    EXPECT_EQ("ab", stream.Value(0));
+    EXPECT_EQ("xyz", stream.Value(2));
+    EXPECT_EQ(std::uint32_t{ 7 }, stream.Offset(4));
+    EXPECT_EQ("c", stream.Value(4));
+}
+
+TEST(TokenStreamTest, Tokenize)
+{
+    TokenizerRuleSet<int> ruleSet({
+        { "[ \t]+", TokenType{ 1 } },
+        { "[_a-zA-Z][_a-zA-Z0-9]*", TokenType{ 2 } },
+        { "\r?\n", TokenType{ 3 } },
+        });
+    std::string compilationUnit("ABC");
+    std::string text{ "ab c\nd" };
+
+    auto stream = Tokenize(ruleSet, compilationUnit, text);
+    ASSERT_EQ(size_t{ 5 }, stream.Size());
+    EXPECT_EQ(TokenType{ 2 }, stream.Type(0));
+    EXPECT_EQ(TokenType{ 1 }, stream.Type(1));
+    EXPECT_EQ(TokenType{ 3 }, stream.Type(3));
+    EXPECT_EQ("d", stream.Value(4));
+
+    auto token = stream.MakeToken(4);
+    EXPECT_EQ("d", token.Value());
+    EXPECT_EQ(SourceLocation(compilationUnit, 2, 1), token.BeginLocation());
+    EXPECT_EQ(SourceLocation(compilationUnit, 2, 2), token.EndLocation());
+}
+
+TEST(TokenStreamTest, TokenizeInArena)
+{
+    TokenizerRuleSet<int> ruleSet({
+        { "[ \t]+", TokenType{ 1 } },
+        { "[_a-zA-Z][_a-zA-Z0-9]*", TokenType{ 2 } },
+        { "\r?\n", TokenType{ 3 } },
+        });
+    std::string compilationUnit("ABC");
+    std::string text{ "ab c\nd" };
+    ParseArena arena;
+
+    auto stream = Tokenize(ruleSet, compilationUnit, text, arena.Resource());
+    EXPECT_EQ(arena.Resource(), stream.Resource());
+    EXPECT_LT(size_t{ 0 }, arena.BytesReserved());
+    auto expected = Tokenize(ruleSet, compilationUnit, text);
+    EXPECT_EQ(std::pmr::get_default_resource(), expected.Resource());
+    EXPECT_EQ(expected.Types(), stream.Types());
+    EXPECT_EQ(expected.Offsets(), stream.Offsets());
+    EXPECT_EQ(expected.Lengths(), stream.Lengths());
+}
+
+TEST(TokenStreamTest, TokenizeSameAsGetToken)
+{
+    TokenizerRuleSet<int> ruleSet({
+        { "[ \t]+", TokenType{ 1 } },
+        { "[_a-zA-Z][_a-zA-Z0-9]*", TokenType{ 2 } },
+        });
+    std::string compilationUnit("ABC");
+    std::string text{ "ab c ? d" };
+
+    auto stream = Tokenize(ruleSet, compilationUnit, text);
+    Tokenizer<int> tokenizer(ruleSet, compilationUnit, std::string_view(text));
+    for (std::size_t index = 0; index < stream.Size(); ++index)
+    {
+        EXPECT_EQ(tokenizer.GetToken(), stream.MakeToken(index));
+    }
+    EXPECT_TRUE(tokenizer.GetToken().IsNull());
+}
+
+} // namespace parser
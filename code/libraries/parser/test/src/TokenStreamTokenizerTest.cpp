@@ -0,0 +1,69 @@
+#include "parser/TokenStreamTokenizer.h"
+
+#include "test-platform/GoogleTest.h"
+#include "parser/Tokenizer.h"
+
+namespace parser {
+
+class TokenStreamTokenizerTest
+    : public ::testing::Test
+{
+public:
+    TokenizerRuleSet<int> ruleSet;
+
+    TokenStreamTokenizerTest()
+        : ruleSet({
+            { "[ \t]+", TokenType{ 1 } },
+            { "[_a-zA-Z][_a-zA-Z0-9]*", TokenType{ 2 } },
+            { "\r?\n", TokenType{ 3 } },
+            })
+    {
+    }
+};
+
+TEST_F(TokenStreamTokenizerTest, EmptyStream)
+{
+    auto tokens = Tokenize(ruleSet, "ABC", "");
+    TokenStreamTokenizer<int> tokenizer(tokens);
+
+    EXPECT_TRUE(tokenizer.IsAtEnd());
+    EXPECT_TRUE(tokenizer.GetToken().IsNull());
+}
+
+TEST_F(TokenStreamTokenizerTest, SameTokensAsTokenizer)
+{
+    std::string text{ "ab c\nd" };
+    auto tokens = Tokenize(ruleSet, "ABC", text);
+    TokenStreamTokenizer<int> tokenizer(tokens);
+    Tokenizer<int> expected(ruleSet, "ABC", std::string_view(text));
+
+    while (!expected.IsAtEnd())
+    {
+        EXPECT_FALSE(tokenizer.IsAtEnd());
+        EXPECT_EQ(expected.GetToken(), tokenizer.GetToken());
+        EXPECT_EQ(expected.GetCurrentLocation(), tokenizer.GetCurrentLocation());
+    }
+    EXPECT_TRUE(tokenizer.IsAtEnd());
+    EXPECT_TRUE(tokenizer.GetToken().IsNull());
+}
+
+TEST_F(TokenStreamTokenizerTest, UngetToken)
+{
+    auto tokens = Tokenize(ruleSet, "ABC", "ab c");
+    TokenStreamTokenizer<int> tokenizer(tokens);
+
+    auto first = tokenizer.GetToken();
+    auto second = tokenizer.GetToken();
+    tokenizer.UngetToken(second);
+    tokenizer.UngetToken(first);
+    EXPECT_EQ(first, tokenizer.GetToken());
+    EXPECT_EQ(second, tokenizer.GetToken());
+
+    Token<int> other(TokenType{ 2 }, "x", SourceLocation("XYZ", 1, 1), SourceLocation("XYZ", 1, 2));
+    tokenizer.UngetToken(other);
+    EXPECT_EQ(other, tokenizer.GetToken());
+    EXPECT_EQ("c", tokenizer.GetToken().Value());
+    EXPECT_TRUE(tokenizer.IsAtEnd());
+}
+
+} // namespace parser
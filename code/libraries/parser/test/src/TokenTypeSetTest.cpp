@@ -0,0 +1,74 @@
+#include "test-platform/GoogleTest.h"
+
+#include "parser/TokenTypeSet.h"
+
+namespace parser {
+
+namespace {
+
+enum Terminal
+{
+    None,
+    Whitespace,
+    NewLine,
+    Identifier,
+    Last = 100,
+};
+
+constexpr TokenTypeSet<Terminal> whitespaceTerminals{ Terminal::Whitespace, Terminal::NewLine };
+static_assert(whitespaceTerminals.Contains(Terminal::NewLine));
+static_assert(!whitespaceTerminals.Contains(Terminal::Identifier));
+
+} // namespace
+
+TEST(TokenTypeSetTest, Construct)
+{
+    TokenTypeSet<Terminal> set;
+
+    EXPECT_TRUE(set.IsEmpty());
+    EXPECT_FALSE(set.Contains(Terminal::None));
+}
+
+TEST(TokenTypeSetTest, ConstructFromList)
+{
+    TokenTypeSet<Terminal> set{ Terminal::Whitespace, Terminal::NewLine };
+
+    EXPECT_FALSE(set.IsEmpty());
+    EXPECT_FALSE(set.Contains(Terminal::None));
+    EXPECT_TRUE(set.Contains(Terminal::Whitespace));
+    EXPECT_TRUE(set.Contains(Terminal::NewLine));
+    EXPECT_FALSE(set.Contains(Terminal::Identifier));
+    EXPECT_EQ(whitespaceTerminals, set);
+}
+
+TEST(TokenTypeSetTest, InsertAndErase)
+{
+    TokenTypeSet<Terminal, 128> set;
+
+    set.Insert(Terminal::Last);
+    EXPECT_TRUE(set.Contains(Terminal::Last));
+    set.Erase(Terminal::Last);
+    EXPECT_FALSE(set.Contains(Terminal::Last));
+    EXPECT_TRUE(set.IsEmpty());
+}
+
+TEST(TokenTypeSetTest, InsertOutOfRange)
+{
+    TokenTypeSet<Terminal> set;
+
+    EXPECT_THROW(set.Insert(Terminal::Last), std::out_of_range);
+    EXPECT_FALSE(set.Contains(Terminal::Last));
+}
+
+TEST(TokenTypeSetTest, ContainsTokenType)
+{
+    TokenTypeSet<Terminal> set{ Terminal::None, Terminal::Identifier };
+
+    EXPECT_TRUE(set.Contains(TokenType<Terminal>{ Terminal::None }));
+    EXPECT_TRUE(set.Contains(TokenType<Terminal>{ Terminal::Identifier }));
+    EXPECT_FALSE(set.Contains(TokenType<Terminal>{ Terminal::Whitespace }));
+    EXPECT_FALSE(set.Contains(TokenType<Terminal>{}));
+    EXPECT_FALSE(set.Contains(TokenType<Terminal>::InvalidToken));
+}
+
+} // namespace parser
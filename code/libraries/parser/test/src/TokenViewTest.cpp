@@ -0,0 +1,44 @@
+#include "test-platform/GoogleTest.h"
+
+#include "parser/TokenView.h"
+
+namespace parser {
+
+TEST(TokenViewTest, ConstructDefault)
+{
+    TokenView<int> token;
+
+    EXPECT_TRUE(token.IsNull());
+    EXPECT_FALSE(token.IsInvalid());
+    EXPECT_FALSE(token.IsRestored());
+    EXPECT_EQ(TokenType<int>{}, token.Type());
+    EXPECT_EQ("", token.Value());
+    EXPECT_EQ(size_t{ 0 }, token.Offset());
+    EXPECT_EQ(size_t{ 0 }, token.Length());
+}
+
+TEST(TokenViewTest, Construct)
+{
+    std::string text{ "Zero One Two" };
+    TokenView<int> token(TokenType{ 1 }, std::string_view(text).substr(5, 3), 5);
+
+    EXPECT_FALSE(token.IsNull());
+    EXPECT_FALSE(token.IsInvalid());
+    EXPECT_FALSE(token.IsRestored());
+    EXPECT_EQ(TokenType{ 1 }, token.Type());
+    EXPECT_EQ("One", token.Value());
+    EXPECT_EQ(text.data() + 5, token.Value().data());
+    EXPECT_EQ(size_t{ 5 }, token.Offset());
+    EXPECT_EQ(size_t{ 3 }, token.Length());
+    EXPECT_TRUE(token == TokenType{ 1 });
+    EXPECT_TRUE(token != TokenType{ 2 });
+}
+
+TEST(TokenViewTest, ConstructRestored)
+{
+    TokenView<int> token(TokenType{ 1 }, "One", TokenView<int>::RestoredOffset);
+
+    EXPECT_TRUE(token.IsRestored());
+}
+
+} // namespace parser
@@ -0,0 +1,146 @@
+#include "parser/TokenizerAutomaton.h"
+
+#include <regex>
+#include "test-platform/GoogleTest.h"
+
+namespace parser {
+
+TEST(TokenizerAutomatonTest, ConstructDefault)
+{
+    TokenizerAutomaton automaton;
+
+    EXPECT_FALSE(automaton.IsValid());
+    EXPECT_EQ(TokenizerAutomaton::NoRule, automaton.Match("a"));
+}
+
+TEST(TokenizerAutomatonTest, CompileEmpty)
+{
+    TokenizerAutomaton automaton;
+
+    EXPECT_TRUE(automaton.Compile({}));
+    EXPECT_TRUE(automaton.IsValid());
+    EXPECT_EQ(TokenizerAutomaton::NoRule, automaton.Match("a"));
+}
+
+TEST(TokenizerAutomatonTest, MatchSingleRule)
+{
+    TokenizerAutomaton automaton;
+
+    EXPECT_TRUE(automaton.Compile({ "a+" }));
+    EXPECT_EQ(0, automaton.Match("a"));
+    EXPECT_EQ(0, automaton.Match("aaa"));
+    EXPECT_EQ(TokenizerAutomaton::NoRule, automaton.Match("aab"));
+    EXPECT_EQ(TokenizerAutomaton::NoRule, automaton.Match(""));
+}
+
+TEST(TokenizerAutomatonTest, MatchFirstRuleHasPriority)
+{
+    TokenizerAutomaton automaton;
+
+    EXPECT_TRUE(automaton.Compile({ "if", "[a-z]+", "[[:space:]]+" }));
+    EXPECT_EQ(0, automaton.Match("if"));
+    EXPECT_EQ(1, automaton.Match("iff"));
+    EXPECT_EQ(1, automaton.Match("i"));
+    EXPECT_EQ(2, automaton.Match(" \t\r\n"));
+}
+
+TEST(TokenizerAutomatonTest, MatchLazyQuantifier)
+{
+    TokenizerAutomaton automaton;
+
+    EXPECT_TRUE(automaton.Compile({ "/\\*[\\s\\S]*?\\*/" }));
+    EXPECT_EQ(0, automaton.Match("/**/"));
+    EXPECT_EQ(0, automaton.Match("/* Text\r\non\r\nmultiple\r\nlines */"));
+    EXPECT_EQ(TokenizerAutomaton::NoRule, automaton.Match("/* Text"));
+}
+
+TEST(TokenizerAutomatonTest, MatchTokenEndAnchor)
+{
+    TokenizerAutomaton automaton;
+
+    EXPECT_TRUE(automaton.Compile({ "(?:/|$)(?:/|$).*" }));
+    EXPECT_EQ(0, automaton.Match("//"));
+    EXPECT_EQ(0, automaton.Match("/"));
+    EXPECT_EQ(TokenizerAutomaton::NoRule, automaton.Match("/a"));
+}
+
+TEST(TokenizerAutomatonTest, CompileUnsupportedSyntaxFails)
+{
+    TokenizerAutomaton automaton;
+
+    EXPECT_FALSE(automaton.Compile({ "(a)\\1" }));
+    EXPECT_FALSE(automaton.IsValid());
+    EXPECT_FALSE(automaton.Compile({ "a(?=b)" }));
+    EXPECT_FALSE(automaton.Compile({ "\\bword" }));
+    EXPECT_FALSE(automaton.Compile({ "a{" }));
+}
+
+TEST(TokenizerAutomatonTest, MatchSameAsRegex)
+{
+    const std::vector<std::string> patterns{
+        "#\\[(=*)\\[",
+        "[A-Za-z_][A-Za-z0-9_]*",
+        "[-+]?(?:0|[1-9][0-9]*)(?:\\.[0-9]+)?(?:[eE][-+]?[0-9]+)?",
+        "\"(?:[^\"\\\\\\n]|\\\\.)*\"",
+        "[:alpha:][[:digit:][:alpha:]]*",
+        "[\\t ]+|\\r?\\n",
+        "\\$\\{|\\}|\\$ENV\\{",
+        "x{2,3}y{2}z{1,}",
+        "[^a-c\\]]",
+        ".",
+    };
+    const std::vector<std::string> texts{
+        "", "#[[", "#[==[", "abc", "_a1", "1abc", "-12.5e+3", "0", "01", "\"abc\"", "\"a\\\"b\"", "\"a\nb\"",
+        "alpha", ":", "a0", " \t", "\r\n", "\n", "${", "}", "$ENV{", "xxyyz", "xxxyyzzz", "xyyz", "]", "d", "\r", "a",
+    };
+    TokenizerAutomaton automaton;
+
+    ASSERT_TRUE(automaton.Compile(patterns));
+    for (auto const& text : texts)
+    {
+        int expected = TokenizerAutomaton::NoRule;
+        for (std::size_t rule = 0; rule < patterns.size(); ++rule)
+        {
+            if (std::regex_match(text, std::regex(patterns[rule])))
+            {
+                expected = static_cast<int>(rule);
+                break;
+            }
+        }
+        EXPECT_EQ(expected, automaton.Match(text)) << "Text: " << text;
+    }
+}
+
+TEST(TokenizerAutomatonTest, StatesAreMinimized)
+{
+    TokenizerAutomaton automaton;
+
+    EXPECT_TRUE(automaton.Compile({ "(?:a|b)*c", "[ab]*c" }));
+    // Dead state, start state and accepting state
+    EXPECT_EQ(size_t{ 3 }, automaton.NumStates());
+    EXPECT_EQ(0, automaton.Match("ababc"));
+}
+
+TEST(TokenizerAutomatonTest, RunsOfLoopingStates)
+{
+    TokenizerAutomaton automaton;
+
+    EXPECT_TRUE(automaton.Compile({ "[ \t]+", "\"(?:[^\"\\\\]|\\\\.)*\"" }));
+    EXPECT_TRUE(automaton.Run(automaton.StartState()).IsEmpty());
+
+    auto const& whitespace = automaton.Run(automaton.Next(automaton.StartState(), ' '));
+    EXPECT_FALSE(whitespace.IsEmpty());
+    EXPECT_TRUE(whitespace.Contains(' '));
+    EXPECT_TRUE(whitespace.Contains('\t'));
+    EXPECT_FALSE(whitespace.Contains('a'));
+
+    // Inside a string, the run ends at a quote or an escape
+    auto const& text = automaton.Run(automaton.Next(automaton.StartState(), '"'));
+    EXPECT_FALSE(text.IsEmpty());
+    EXPECT_TRUE(text.Contains('a'));
+    EXPECT_TRUE(text.Contains('\n'));
+    EXPECT_FALSE(text.Contains('"'));
+    EXPECT_FALSE(text.Contains('\\'));
+}
+
+} // namespace parser
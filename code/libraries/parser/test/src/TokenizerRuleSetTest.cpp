@@ -0,0 +1,40 @@
+#include "parser/TokenizerRuleSet.h"
+
+#include "test-platform/GoogleTest.h"
+
+namespace parser {
+
+TEST(TokenizerRuleSetTest, ConstructEmpty)
+{
+    TokenizerRuleSet<int> ruleSet({});
+
+    EXPECT_EQ(size_t{ 0 }, ruleSet.Rules().size());
+    EXPECT_TRUE(ruleSet.Automaton().IsValid());
+    EXPECT_EQ(TokenizerAutomaton::NoRule, ruleSet.Automaton().Match("a"));
+}
+
+TEST(TokenizerRuleSetTest, ConstructCompilesRules)
+{
+    TokenizerRuleSet<int> ruleSet({
+        { "[ \t]+", TokenType{ 1 } },
+        { "[_a-zA-Z][_a-zA-Z0-9]*", TokenType{ 2 } },
+        });
+
+    EXPECT_EQ(size_t{ 2 }, ruleSet.Rules().size());
+    EXPECT_EQ("[_a-zA-Z][_a-zA-Z0-9]*", ruleSet.Rules()[1].Pattern());
+    EXPECT_TRUE(ruleSet.Automaton().IsValid());
+    EXPECT_EQ(0, ruleSet.Automaton().Match(" \t"));
+    EXPECT_EQ(1, ruleSet.Automaton().Match("_abc1"));
+}
+
+TEST(TokenizerRuleSetTest, ConstructWithUnsupportedRuleLeavesAutomatonInvalid)
+{
+    TokenizerRuleSet<int> ruleSet({
+        { "(a)\\1", TokenType{ 1 } },
+        });
+
+    EXPECT_EQ(size_t{ 1 }, ruleSet.Rules().size());
+    EXPECT_FALSE(ruleSet.Automaton().IsValid());
+}
+
+} // namespace parser
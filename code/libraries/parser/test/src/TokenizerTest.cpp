@@ -1,7 +1,7 @@
 #include "test-platform/GoogleTest.h"
 
 #include "parser/Tokenizer.h"
-#include "parser/TokenizerRule.h"
+#include "parser/TokenizerRuleSet.h"
 
 namespace parser {
 
@@ -9,15 +9,13 @@ class TokenizerTest
     : public ::testing::Test
 {
 public:
-    void SetUp() override
-    {
-        SetTokenizerRules<int>({
+    TokenizerRuleSet<int> ruleSet;
+
+    TokenizerTest()
+        : ruleSet({
             { "/(/)(.*)", TokenType{1} },
-            });
-    }
-    void TearDown() override
+            })
     {
-        SetTokenizerRules<int>({});
     }
 };
 
@@ -25,7 +23,7 @@ TEST_F(TokenizerTest, EmptyStream)
 {
     std::string compilationUnit("ABC");
     std::istringstream stream("");
-    Tokenizer<int> tokenizer(compilationUnit, stream);
+    Tokenizer<int> tokenizer(ruleSet, compilationUnit, stream);
 
     EXPECT_TRUE(tokenizer.GetToken().IsNull());
 }
@@ -35,7 +33,7 @@ TEST_F(TokenizerTest, GetToken)
     std::string compilationUnit("ABC");
     std::string text{ "// Comment" };
     std::istringstream stream(text);
-    Tokenizer<int> tokenizer(compilationUnit, stream);
+    Tokenizer<int> tokenizer(ruleSet, compilationUnit, stream);
 
     auto Token = tokenizer.GetToken();
     EXPECT_FALSE(Token.IsNull());
@@ -44,12 +42,55 @@ TEST_F(TokenizerTest, GetToken)
     EXPECT_EQ(SourceLocation(compilationUnit, 1, 1), Token.Location());
 }
 
+TEST_F(TokenizerTest, GetTokenFromBuffer)
+{
+    std::string compilationUnit("ABC");
+    std::string text{ "// Comment" };
+    Tokenizer<int> tokenizer(ruleSet, compilationUnit, std::string_view(text));
+
+    auto Token = tokenizer.GetToken();
+    EXPECT_FALSE(Token.IsNull());
+    EXPECT_EQ(TokenType{ 1 }, Token.Type());
+    EXPECT_EQ(text, Token.Value());
+    EXPECT_EQ(SourceLocation(compilationUnit, 1, 1), Token.Location());
+    EXPECT_TRUE(tokenizer.GetToken().IsNull());
+    EXPECT_TRUE(tokenizer.IsAtEnd());
+}
+
+TEST_F(TokenizerTest, GetTokenView)
+{
+    std::string compilationUnit("ABC");
+    std::string text{ "// Comment" };
+    Tokenizer<int> tokenizer(ruleSet, compilationUnit, std::string_view(text));
+
+    auto view = tokenizer.GetTokenView();
+    EXPECT_EQ(TokenType{ 1 }, view.Type());
+    EXPECT_EQ(text, view.Value());
+    EXPECT_EQ(text.data(), view.Value().data());
+    auto token = tokenizer.MakeToken(view);
+    EXPECT_EQ(TokenType{ 1 }, token.Type());
+    EXPECT_EQ(text, token.Value());
+    EXPECT_EQ(SourceLocation(compilationUnit, 1, 1), token.BeginLocation());
+    EXPECT_EQ(SourceLocation(compilationUnit, 1, 11), token.EndLocation());
+
+    tokenizer.UngetToken(token);
+    view = tokenizer.GetTokenView();
+    EXPECT_FALSE(view.IsRestored());
+    EXPECT_EQ(TokenType{ 1 }, view.Type());
+    EXPECT_EQ(text.data(), view.Value().data());
+    EXPECT_EQ(token, tokenizer.MakeToken(view));
+
+    view = tokenizer.GetTokenView();
+    EXPECT_TRUE(view.IsNull());
+    EXPECT_TRUE(tokenizer.MakeToken(view).IsNull());
+}
+
 TEST_F(TokenizerTest, GetTokenGarbage)
 {
     std::string compilationUnit("ABC");
     std::string text{ "void main() {}" };
     std::istringstream stream(text);
-    Tokenizer<int> tokenizer(compilationUnit, stream);
+    Tokenizer<int> tokenizer(ruleSet, compilationUnit, stream);
 
     auto Token = tokenizer.GetToken();
     EXPECT_FALSE(Token.IsNull());
@@ -58,4 +99,156 @@ TEST_F(TokenizerTest, GetTokenGarbage)
     EXPECT_EQ(SourceLocation(compilationUnit, 1, 1), Token.Location());
 }
 
+TEST_F(TokenizerTest, GetTokenLongestMatchWithRulePriority)
+{
+    TokenizerRuleSet<int> longestMatchRuleSet({
+        { "[ \t]+", TokenType{ 1 } },
+        { "[_a-zA-Z][_a-zA-Z0-9]*", TokenType{ 2 } },
+        { "[_a-zA-Z][_\\-a-zA-Z0-9]*", TokenType{ 3 } },
+        });
+    std::string compilationUnit("ABC");
+    std::istringstream stream("WX WX- X");
+    Tokenizer<int> tokenizer(longestMatchRuleSet, compilationUnit, stream);
+
+    auto token = tokenizer.GetToken();
+    EXPECT_EQ(TokenType{ 2 }, token.Type());
+    EXPECT_EQ("WX", token.Value());
+    token = tokenizer.GetToken();
+    EXPECT_EQ(TokenType{ 1 }, token.Type());
+    token = tokenizer.GetToken();
+    EXPECT_EQ(TokenType{ 3 }, token.Type());
+    EXPECT_EQ("WX-", token.Value());
+    EXPECT_EQ(SourceLocation(compilationUnit, 1, 4), token.Location());
+    token = tokenizer.GetToken();
+    EXPECT_EQ(TokenType{ 1 }, token.Type());
+    token = tokenizer.GetToken();
+    EXPECT_EQ(TokenType{ 2 }, token.Type());
+    EXPECT_EQ("X", token.Value());
+    EXPECT_TRUE(tokenizer.IsAtEnd());
+}
+
+TEST_F(TokenizerTest, PeekTokenView)
+{
+    TokenizerRuleSet<int> peekRuleSet({
+        { "[ \t]+", TokenType{ 1 } },
+        { "[_a-zA-Z][_a-zA-Z0-9]*", TokenType{ 2 } },
+        });
+    std::string compilationUnit("ABC");
+    std::string text{ "a b c" };
+    Tokenizer<int> tokenizer(peekRuleSet, compilationUnit, std::string_view(text), 5);
+
+    EXPECT_EQ("a", tokenizer.PeekTokenView().Value());
+    EXPECT_EQ("b", tokenizer.PeekTokenView(2).Value());
+    EXPECT_EQ("c", tokenizer.PeekTokenView(4).Value());
+    EXPECT_EQ(text.data() + 4, tokenizer.PeekTokenView(4).Value().data());
+    EXPECT_THROW(tokenizer.PeekTokenView(8), std::length_error);
+    EXPECT_EQ(SourceLocation(compilationUnit, 1, 3), tokenizer.PeekToken(2).BeginLocation());
+
+    EXPECT_EQ("a", tokenizer.GetToken().Value());
+    EXPECT_EQ(TokenType{ 1 }, tokenizer.GetToken().Type());
+    EXPECT_EQ("b", tokenizer.GetTokenView().Value());
+    EXPECT_EQ(TokenType{ 1 }, tokenizer.GetTokenView().Type());
+    EXPECT_FALSE(tokenizer.IsAtEnd());
+    EXPECT_EQ("c", tokenizer.GetToken().Value());
+    EXPECT_TRUE(tokenizer.PeekTokenView().IsNull());
+    EXPECT_TRUE(tokenizer.IsAtEnd());
+    EXPECT_TRUE(tokenizer.GetToken().IsNull());
+}
+
+TEST_F(TokenizerTest, UngetMultipleTokens)
+{
+    TokenizerRuleSet<int> ungetRuleSet({
+        { "[ \t]+", TokenType{ 1 } },
+        { "[_a-zA-Z][_a-zA-Z0-9]*", TokenType{ 2 } },
+        });
+    std::string compilationUnit("ABC");
+    std::istringstream stream("a b");
+    Tokenizer<int> tokenizer(ungetRuleSet, compilationUnit, stream);
+
+    auto token1 = tokenizer.GetToken();
+    auto token2 = tokenizer.GetToken();
+    auto token3 = tokenizer.GetToken();
+    EXPECT_TRUE(tokenizer.GetToken().IsNull());
+    EXPECT_TRUE(tokenizer.IsAtEnd());
+
+    tokenizer.UngetToken(token3);
+    tokenizer.UngetToken(token2);
+    tokenizer.UngetToken(token1);
+    EXPECT_FALSE(tokenizer.IsAtEnd());
+    auto view = tokenizer.GetTokenView();
+    EXPECT_FALSE(view.IsRestored());
+    EXPECT_EQ(token1, tokenizer.MakeToken(view));
+    EXPECT_EQ(token2, tokenizer.GetToken());
+    EXPECT_EQ(token3, tokenizer.GetToken());
+    EXPECT_TRUE(tokenizer.IsAtEnd());
+}
+
+TEST_F(TokenizerTest, UngetTokenFromElsewhere)
+{
+    std::string compilationUnit("ABC");
+    std::string text{ "// Comment" };
+    Tokenizer<int> tokenizer(ruleSet, compilationUnit, std::string_view(text));
+    Token<int> other(TokenType{ 2 }, "x", SourceLocation(compilationUnit, 2, 1), SourceLocation(compilationUnit, 2, 2));
+    Token<int> another(TokenType{ 3 }, "y", SourceLocation(compilationUnit, 3, 1), SourceLocation(compilationUnit, 3, 2));
+
+    tokenizer.UngetToken(other);
+    tokenizer.UngetToken(another);
+    EXPECT_EQ(another, tokenizer.PeekToken());
+    EXPECT_EQ(other, tokenizer.PeekToken(1));
+    EXPECT_EQ(text, tokenizer.PeekToken(2).Value());
+    EXPECT_EQ(another, tokenizer.GetToken());
+    EXPECT_EQ(other, tokenizer.GetToken());
+    EXPECT_EQ(text, tokenizer.GetToken().Value());
+    EXPECT_TRUE(tokenizer.IsAtEnd());
+}
+
+TEST_F(TokenizerTest, GetTokenLookAheadWindow)
+{
+    const TokenizerRules<int> rules{
+        { "a", TokenType{ 1 } },
+        { "a[b]{12}c", TokenType{ 2 } },
+        { "b", TokenType{ 3 } },
+        };
+    TokenizerRuleSet<int> unlimitedRuleSet(rules);
+    TokenizerRuleSet<int> limitedRuleSet(rules, 4);
+    std::string compilationUnit("ABC");
+    std::string text{ "abbbbbbbbbbbbc" };
+
+    Tokenizer<int> unlimited(unlimitedRuleSet, compilationUnit, std::string_view(text));
+    auto token = unlimited.GetToken();
+    EXPECT_EQ(TokenType{ 2 }, token.Type());
+    EXPECT_EQ(text, token.Value());
+
+    Tokenizer<int> limited(limitedRuleSet, compilationUnit, std::string_view(text));
+    token = limited.GetToken();
+    EXPECT_EQ(TokenType{ 1 }, token.Type());
+    EXPECT_EQ("a", token.Value());
+    token = limited.GetToken();
+    EXPECT_EQ(TokenType{ 3 }, token.Type());
+    EXPECT_EQ(SourceLocation(compilationUnit, 1, 2), token.Location());
+}
+
+TEST_F(TokenizerTest, GetTokenRegexFallback)
+{
+    // The backreference cannot be compiled into an automaton
+    TokenizerRuleSet<int> regexRuleSet({
+        { "([ab])\\1", TokenType{ 1 } },
+        { "[ \t]+", TokenType{ 2 } },
+        });
+    std::string compilationUnit("ABC");
+    std::string text{ "aa bb" };
+    Tokenizer<int> tokenizer(regexRuleSet, compilationUnit, std::string_view(text));
+
+    ASSERT_FALSE(regexRuleSet.Automaton().IsValid());
+    auto token = tokenizer.GetToken();
+    EXPECT_EQ(TokenType{ 1 }, token.Type());
+    EXPECT_EQ("aa", token.Value());
+    EXPECT_EQ(TokenType{ 2 }, tokenizer.GetToken().Type());
+    token = tokenizer.GetToken();
+    EXPECT_EQ(TokenType{ 1 }, token.Type());
+    EXPECT_EQ("bb", token.Value());
+    EXPECT_EQ(SourceLocation(compilationUnit, 1, 4), token.Location());
+    EXPECT_TRUE(tokenizer.GetToken().IsNull());
+}
+
 } // namespace parser